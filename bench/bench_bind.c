@@ -0,0 +1,99 @@
+/**
+ * @file    bench_bind.c
+ * @brief   Benchmark: Checked drv_read()/drv_ioctl() vs. calls through a bound handle.
+ *
+ * @details
+ * Polls a DIO pin BENCH_CALLS times with every API:
+ * - checked: drv_read()/drv_ioctl() with parameter checks and a reference per call.
+ * - bound: drv_bound_read()/drv_bound_ioctl() of a handle of drv_bind().
+ * Prints the time per call in nanoseconds.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_dio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CALLS     (20000000UL)
+
+// Polled pin: Returns its level.
+static ssize_t bench_pin_read(driver_t* driver, void* buffer, size_t count) {
+    *(volatile uint8_t*)buffer = 1;
+    return 1;
+}
+
+static int bench_pin_ioctl(driver_t* driver, size_t id, void* param) {
+    return 0;
+}
+
+static const driver_fops_t bench_pin_fops = {
+    .close = drv_open_release,
+    .read = bench_pin_read,
+    .ioctl = bench_pin_ioctl,
+};
+static driver_ctx_t bench_ctx = { .open_max = 0 };
+static driver_t bench_pin = { .name = "bind_pin", .type = DRV_GPIO_PIN, .fops = &bench_pin_fops, .ctx = &bench_ctx };
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(void) {
+    drv_dio_init();
+    if (drv_register(drv_dio, "bind_pin", &bench_pin) != 0) {
+        perror("drv_register");
+        return EXIT_FAILURE;
+    }
+    driver_t* pin = drv_open(drv_dio, "bind_pin");
+    drv_bound_t bound;
+    if ((pin == NULL) || (drv_bind(pin, &bound) != 0)) {
+        perror("drv_open/drv_bind");
+        return EXIT_FAILURE;
+    }
+
+    uint8_t level;
+    uint64_t errors = 0;
+    uint64_t start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_CALLS; i++) {
+        errors += (drv_read(pin, &level, 1) != 1);
+    }
+    double read_checked = (double)(bench_now_ns() - start) / BENCH_CALLS;
+
+    start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_CALLS; i++) {
+        errors += (drv_bound_read(&bound, &level, 1) != 1);
+    }
+    double read_bound = (double)(bench_now_ns() - start) / BENCH_CALLS;
+
+    start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_CALLS; i++) {
+        errors += (drv_ioctl(pin, 0, NULL) != 0);
+    }
+    double ioctl_checked = (double)(bench_now_ns() - start) / BENCH_CALLS;
+
+    start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_CALLS; i++) {
+        errors += (drv_bound_ioctl(&bound, 0, NULL) != 0);
+    }
+    double ioctl_bound = (double)(bench_now_ns() - start) / BENCH_CALLS;
+
+    printf("%-8s %16s %16s\n", "call", "checked [ns]", "bound [ns]");
+    printf("%-8s %16.2f %16.2f\n", "read", read_checked, read_bound);
+    printf("%-8s %16.2f %16.2f\n", "ioctl", ioctl_checked, ioctl_bound);
+
+    drv_unbind(&bound);
+    drv_close(pin);
+    drv_deregister(drv_dio, &bench_pin);
+    if (errors != 0) {
+        fprintf(stderr, "bench_bind: %llu failed calls\n", (unsigned long long)errors);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
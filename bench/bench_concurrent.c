@@ -0,0 +1,152 @@
+/**
+ * @file    bench_concurrent.c
+ * @brief   Benchmark: Lookup throughput of a concurrent registry over the number of reader threads.
+ *
+ * @details
+ * Registers BENCH_DRIVERS drivers in a concurrent registry (see registry_make_concurrent())
+ * and runs 1..BENCH_THREADS_MAX reader threads, which look up random names for a fixed time.
+ * Each run is repeated with an additional writer thread, which hot plugs a set of drivers.
+ * Prints the total lookup rate in millions of lookups per second.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <registry.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DRIVERS       (1000U)
+#define BENCH_HOTPLUG       (16U)           // Drivers, which are added/removed by the writer.
+#define BENCH_NAME_LEN      (24U)
+#define BENCH_THREADS_MAX   (8U)
+#define BENCH_RUN_NS        (200000000ULL)  // 200 ms per run.
+
+static registry_t reg;
+static driver_t drivers[BENCH_DRIVERS + BENCH_HOTPLUG];
+static driver_ctx_t ctxs[BENCH_DRIVERS + BENCH_HOTPLUG];
+static char names[BENCH_DRIVERS + BENCH_HOTPLUG][BENCH_NAME_LEN];
+static atomic_bool bench_stop;
+static atomic_size_t bench_errors;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void* bench_reader(void* arg) {
+    uint64_t* lookups = arg;
+    uint32_t seed = (uint32_t)(uintptr_t)arg;
+    uint64_t count = 0;
+    while (!atomic_load_explicit(&bench_stop, memory_order_relaxed)) {
+        for (size_t i = 0; i < 1024; i++) {
+            seed = seed * 1103515245U + 12345U;
+            size_t n = (seed >> 8) % BENCH_DRIVERS;
+            if (registry_get_driver_by_name(&reg, names[n]) != &drivers[n]) {
+                atomic_fetch_add(&bench_errors, 1);
+            }
+        }
+        count += 1024;
+    }
+    *lookups = count;
+    return NULL;
+}
+
+static void* bench_writer(void* arg) {
+    uint64_t* changes = arg;
+    const driver_t* hotplug[BENCH_HOTPLUG];
+    for (size_t i = 0; i < BENCH_HOTPLUG; i++) {
+        hotplug[i] = &drivers[BENCH_DRIVERS + i];
+    }
+    uint64_t count = 0;
+    while (!atomic_load_explicit(&bench_stop, memory_order_relaxed)) {
+        if ((registry_add_drivers(&reg, hotplug, BENCH_HOTPLUG, NULL) != 0) ||
+            (registry_remove_drivers(&reg, hotplug, BENCH_HOTPLUG, NULL) != 0)) {
+            atomic_fetch_add(&bench_errors, 1);
+        }
+        count += 2;
+    }
+    *changes = count;
+    return NULL;
+}
+
+/**
+ * @brief bench_run: Run the readers (and the writer) for BENCH_RUN_NS.
+ *
+ * @param (size_t) threads: Number of reader threads.
+ * @param (bool) writer: true: Run a hot plug writer in parallel.
+ * @param (uint64_t*) changes: Returns the number of batch changes of the writer.
+ *
+ * @return (double): Lookups per second [Mops/s].
+ */
+static double bench_run(size_t threads, bool writer, uint64_t* changes) {
+    pthread_t readers[BENCH_THREADS_MAX];
+    pthread_t writer_thread;
+    uint64_t lookups[BENCH_THREADS_MAX];
+
+    atomic_store(&bench_stop, false);
+    *changes = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < threads; i++) {
+        pthread_create(&readers[i], NULL, bench_reader, &lookups[i]);
+    }
+    if (writer) {
+        pthread_create(&writer_thread, NULL, bench_writer, changes);
+    }
+    struct timespec run = { .tv_sec = 0, .tv_nsec = (long)BENCH_RUN_NS };
+    nanosleep(&run, NULL);
+    atomic_store(&bench_stop, true);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(readers[i], NULL);
+        total += lookups[i];
+    }
+    if (writer) {
+        pthread_join(writer_thread, NULL);
+    }
+    return (double)total * 1000.0 / (double)(bench_now_ns() - start);
+}
+
+int main(void) {
+    for (size_t i = 0; i < BENCH_DRIVERS + BENCH_HOTPLUG; i++) {
+        snprintf(names[i], BENCH_NAME_LEN, "gpio_port_pin_%zu", i);
+        memcpy(&drivers[i], &(driver_t){ .name = names[i], .type = DRV_GPIO_PIN, .ctx = &ctxs[i] }, sizeof(driver_t));
+    }
+    if (registry_make_concurrent(&reg) != 0) {
+        perror("registry_make_concurrent");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < BENCH_DRIVERS; i++) {
+        if (registry_add_driver(&reg, &drivers[i]) != 0) {
+            perror("registry_add_driver");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-8s %16s %16s %16s\n", "readers", "lookups [Mops/s]", "w/ writer", "changes [1/s]");
+    for (size_t threads = 1; threads <= BENCH_THREADS_MAX; threads *= 2) {
+        uint64_t changes;
+        double plain = bench_run(threads, false, &changes);
+        double hotplug = bench_run(threads, true, &changes);
+        printf("%-8zu %16.1f %16.1f %16.0f\n", threads, plain, hotplug,
+               (double)changes * 1e9 / (double)BENCH_RUN_NS);
+    }
+
+    for (size_t i = 0; i < BENCH_DRIVERS; i++) {
+        registry_remove_driver(&reg, &drivers[i]);
+    }
+    registry_free_registry(&reg);
+    if (atomic_load(&bench_errors) != 0) {
+        fprintf(stderr, "bench_concurrent: %zu failed lookups/changes\n", atomic_load(&bench_errors));
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
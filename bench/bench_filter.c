@@ -0,0 +1,108 @@
+/**
+ * @file    bench_filter.c
+ * @brief   Benchmark: Single-byte writes to a device, direct vs. through a coalescing filter.
+ *
+ * @details
+ * Writes BENCH_WRITES single bytes to a pin, whose device access costs BENCH_ACCESS_NS
+ * per call regardless of its size:
+ * - direct: drv_write() to the pin.
+ * - filter: drv_write() to a drv_filter in front of the pin (BENCH_FILTER_SIZE bytes, 1 ms window).
+ * Prints the time per write and the number of device accesses.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_dio.h>
+#include <drv_filter.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define BENCH_WRITES        (200000UL)
+#define BENCH_ACCESS_NS     (500U)          /// Cost of one device access.
+#define BENCH_FILTER_SIZE   (64U)
+
+static _Atomic uint64_t bench_accesses;                  // Also counted by the flusher thread of the filter.
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Device access: Busy for BENCH_ACCESS_NS, like a bus transfer.
+static ssize_t bench_pin_write(driver_t* driver, const void* buffer, size_t count) {
+    uint64_t end = bench_now_ns() + BENCH_ACCESS_NS;
+    while (bench_now_ns() < end) {
+    }
+    bench_accesses++;
+    return (ssize_t)count;
+}
+
+static const driver_fops_t bench_pin_fops = {
+    .close = drv_open_release,
+    .write = bench_pin_write,
+};
+static driver_ctx_t bench_ctx = { .open_max = 0 };
+static driver_t bench_pin = { .name = "filter_pin", .type = DRV_GPIO_PIN, .fops = &bench_pin_fops, .ctx = &bench_ctx };
+
+// Time per write [ns] of BENCH_WRITES single bytes.
+static double bench_writes(driver_t* drv, uint64_t* errors) {
+    uint64_t start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_WRITES; i++) {
+        uint8_t level = (uint8_t)(i & 1U);
+        *errors += (drv_write(drv, &level, 1) != 1);
+    }
+    return (double)(bench_now_ns() - start) / BENCH_WRITES;
+}
+
+int main(void) {
+    drv_dio_init();
+    if (drv_register(drv_dio, "filter_pin", &bench_pin) != 0) {
+        perror("drv_register");
+        return EXIT_FAILURE;
+    }
+    uint64_t errors = 0;
+
+    driver_t* pin = drv_open(drv_dio, "filter_pin");
+    if (pin == NULL) {
+        perror("drv_open");
+        return EXIT_FAILURE;
+    }
+    double direct = bench_writes(pin, &errors);
+    uint64_t direct_accesses = bench_accesses;
+    drv_close(pin);
+
+    // Gleicher Name, jetzt mit Filter davor.
+    drv_filter_t filter;
+    if ((drv_filter_init(&filter, &bench_pin, BENCH_FILTER_SIZE, 1) != 0) || (drv_filter_stack(drv_dio, &filter) != 0)) {
+        perror("drv_filter_init/drv_filter_stack");
+        return EXIT_FAILURE;
+    }
+    pin = drv_open(drv_dio, "filter_pin");
+    if (pin == NULL) {
+        perror("drv_open");
+        return EXIT_FAILURE;
+    }
+    bench_accesses = 0;
+    double filtered = bench_writes(pin, &errors);
+    errors += (drv_close(pin) != 0);
+    uint64_t filter_accesses = bench_accesses;
+
+    printf("%-8s %16s %16s\n", "path", "write [ns]", "accesses");
+    printf("%-8s %16.2f %16llu\n", "direct", direct, (unsigned long long)direct_accesses);
+    printf("%-8s %16.2f %16llu\n", "filter", filtered, (unsigned long long)filter_accesses);
+
+    drv_filter_unstack(drv_dio, &filter);
+    drv_filter_destroy(&filter);
+    drv_deregister(drv_dio, &bench_pin);
+    if (errors != 0) {
+        fprintf(stderr, "bench_filter: %llu failed calls\n", (unsigned long long)errors);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file    bench_intern.c
+ * @brief   Benchmark: Register/open throughput with interned names.
+ *
+ * @details
+ * Registers the same set of pin names at the core and the DIO driver, so every
+ * name is interned once and shared by two drivers. Measures drv_register() and
+ * drv_open() throughput and the lookup by registered name with the interned
+ * pointer and with a private copy of the name (hash, length and byte compare).
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <registry.h>
+#include <intern.h>
+#include <drv_core.h>
+#include <drv_dio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DRIVERS       (10000U)
+#define BENCH_NAME_LEN      (24U)
+#define BENCH_LOOKUPS       (1000000U)
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(void) {
+    driver_t* drivers = calloc(2 * BENCH_DRIVERS, sizeof(driver_t));
+    driver_ctx_t* ctxs = calloc(2 * BENCH_DRIVERS, sizeof(driver_ctx_t));
+    char (*names)[BENCH_NAME_LEN] = calloc(BENCH_DRIVERS, BENCH_NAME_LEN);
+    for (size_t i = 0; i < 2 * BENCH_DRIVERS; i++) {
+        if (i < BENCH_DRIVERS) {
+            snprintf(names[i], BENCH_NAME_LEN, "gpio_port_pin_%zu", i);
+        }
+        memcpy(&ctxs[i], &(driver_ctx_t){ .open_max = 0 }, sizeof(driver_ctx_t));
+        memcpy(&drivers[i], &(driver_t){ .name = names[i % BENCH_DRIVERS], .type = DRV_GPIO_PIN, .ctx = &ctxs[i] }, sizeof(driver_t));
+    }
+
+    // Register: Same names at two parents.
+    size_t interned = intern_count();
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < 2 * BENCH_DRIVERS; i++) {
+        if (drv_register((i < BENCH_DRIVERS) ? drv_core : drv_dio, names[i % BENCH_DRIVERS], &drivers[i]) != 0) {
+            perror("drv_register");
+            return EXIT_FAILURE;
+        }
+    }
+    double register_ns = (double)(bench_now_ns() - start) / (2 * BENCH_DRIVERS);
+    interned = intern_count() - interned;
+
+    // Open
+    srand(1);
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+        if (drv_open(drv_dio, names[(size_t)rand() % BENCH_DRIVERS]) == NULL) {
+            perror("drv_open");
+            return EXIT_FAILURE;
+        }
+    }
+    double open_ns = (double)(bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // Lookup by registered name: Interned pointer vs. private copy.
+    registry_t reg = { 0 };
+    for (size_t i = BENCH_DRIVERS; i < 2 * BENCH_DRIVERS; i++) {
+        registry_add_driver(&reg, &drivers[i]);
+    }
+    double lookup_ns[2];
+    for (size_t variant = 0; variant < 2; variant++) {
+        srand(1);
+        start = bench_now_ns();
+        for (size_t i = 0; i < BENCH_LOOKUPS; i++) {
+            size_t n = (size_t)rand() % BENCH_DRIVERS;
+            const char* key = (variant == 0) ? ctxs[BENCH_DRIVERS + n].reg_name : names[n];
+            if (registry_get_driver_by_reg_name(&reg, key) == NULL) {
+                perror("registry_get_driver_by_reg_name");
+                return EXIT_FAILURE;
+            }
+        }
+        lookup_ns[variant] = (double)(bench_now_ns() - start) / BENCH_LOOKUPS;
+    }
+
+    printf("%-34s %10zu\n", "drivers registered", (size_t)(2 * BENCH_DRIVERS));
+    printf("%-34s %10zu\n", "names interned", interned);
+    printf("%-34s %10.1f\n", "drv_register [ns]", register_ns);
+    printf("%-34s %10.1f\n", "drv_open [ns]", open_ns);
+    printf("%-34s %10.1f\n", "lookup reg_name, interned [ns]", lookup_ns[0]);
+    printf("%-34s %10.1f\n", "lookup reg_name, copy [ns]", lookup_ns[1]);
+
+    free(reg.driver_list);
+    free(reg.name_index);
+    free(reg.reg_name_index);
+    free(reg.used_map);
+    free(reg.generations);
+    ptr_index_free(&reg.driver_index);
+    for (size_t i = 0; i < 2 * BENCH_DRIVERS; i++) {
+        drv_deregister((i < BENCH_DRIVERS) ? drv_core : drv_dio, &drivers[i]);
+    }
+    free(names);
+    free(ctxs);
+    free(drivers);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    bench_open.c
+ * @brief   Benchmark: drv_open()/drv_close() latency over the number of registered drivers.
+ *
+ * @details
+ * Registers N drivers at the core driver and measures the mean time of a
+ * drv_open()/drv_close() pair for randomly chosen names.
+ * With the hash indexed registry the latency should stay flat from 10 to 100k drivers.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_core.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_NAME_LEN      (16U)
+#define BENCH_OPENS         (200000U)
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double bench_run(size_t count) {
+    driver_t* drivers = calloc(count, sizeof(driver_t));
+    driver_ctx_t* ctxs = calloc(count, sizeof(driver_ctx_t));
+    char (*names)[BENCH_NAME_LEN] = calloc(count, BENCH_NAME_LEN);
+
+    for (size_t i = 0; i < count; i++) {
+        snprintf(names[i], BENCH_NAME_LEN, "pin%zu", i);
+        memcpy(&ctxs[i], &(driver_ctx_t){ .open_max = 0 }, sizeof(driver_ctx_t));
+        memcpy(&drivers[i], &(driver_t){ .name = names[i], .type = DRV_GPIO_PIN, .ctx = &ctxs[i] }, sizeof(driver_t));
+        if (drv_register(drv_core, names[i], &drivers[i]) != 0) {
+            perror("drv_register");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    srand(1);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_OPENS; i++) {
+        driver_t* drv = drv_open(drv_core, names[(size_t)rand() % count]);
+        if (drv == NULL) {
+            perror("drv_open");
+            exit(EXIT_FAILURE);
+        }
+        drv_close(drv);
+    }
+    uint64_t duration = bench_now_ns() - start;
+
+    for (size_t i = 0; i < count; i++) {
+        drv_deregister(drv_core, &drivers[i]);
+    }
+    free(names);
+    free(ctxs);
+    free(drivers);
+    return (double)duration / BENCH_OPENS;
+}
+
+int main(void) {
+    static const size_t counts[] = { 10, 100, 1000, 10000, 100000 };
+
+    printf("%10s %16s\n", "drivers", "open+close [ns]");
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        printf("%10zu %16.1f\n", counts[i], bench_run(counts[i]));
+    }
+    return 0;
+}
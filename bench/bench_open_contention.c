@@ -0,0 +1,123 @@
+/**
+ * @file    bench_open_contention.c
+ * @brief   Benchmark: drv_open()/drv_close() throughput from many threads.
+ *
+ * @details
+ * 1..BENCH_THREADS_MAX threads open and close drivers of the DIO driver for a fixed time:
+ * - same: All threads open and close the same driver (one contended counter).
+ * - different: Every thread opens and closes its own driver. The open counters live in
+ *   their own cache lines, so this case should scale with the number of cores.
+ * Prints the total rate in millions of open/close pairs per second.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_dio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_THREADS_MAX   (8U)
+#define BENCH_NAME_LEN      (24U)
+#define BENCH_RUN_NS        (200000000ULL)  // 200 ms per run.
+
+// The pins only count their opens.
+static const driver_fops_t bench_pin_fops = { .close = drv_open_release };
+
+static driver_t drivers[BENCH_THREADS_MAX];
+static driver_ctx_t ctxs[BENCH_THREADS_MAX];
+static char names[BENCH_THREADS_MAX][BENCH_NAME_LEN];
+static atomic_bool bench_stop;
+static atomic_size_t bench_errors;
+
+typedef struct {
+    const char* name;                               // Driver to open.
+    uint64_t pairs;                                 // Returns the number of open/close pairs.
+} bench_thread_t;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void* bench_thread(void* arg) {
+    bench_thread_t* thread = arg;
+    uint64_t pairs = 0;
+    while (!atomic_load_explicit(&bench_stop, memory_order_relaxed)) {
+        for (size_t i = 0; i < 256; i++) {
+            driver_t* drv = drv_open(drv_dio, thread->name);
+            if ((drv == NULL) || (drv_close(drv) != 0)) {
+                atomic_fetch_add(&bench_errors, 1);
+            }
+        }
+        pairs += 256;
+    }
+    thread->pairs = pairs;
+    return NULL;
+}
+
+/**
+ * @brief bench_run: Open and close drivers from a number of threads for BENCH_RUN_NS.
+ *
+ * @param (size_t) threads: Number of threads.
+ * @param (bool) same: true: All threads use the same driver; false: Every thread its own.
+ *
+ * @return (double): Open/close pairs per second [Mops/s].
+ */
+static double bench_run(size_t threads, bool same) {
+    pthread_t ids[BENCH_THREADS_MAX];
+    bench_thread_t args[BENCH_THREADS_MAX];
+
+    atomic_store(&bench_stop, false);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < threads; i++) {
+        args[i] = (bench_thread_t){ .name = names[same ? 0 : i], .pairs = 0 };
+        pthread_create(&ids[i], NULL, bench_thread, &args[i]);
+    }
+    struct timespec run = { .tv_sec = 0, .tv_nsec = (long)BENCH_RUN_NS };
+    nanosleep(&run, NULL);
+    atomic_store(&bench_stop, true);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        total += args[i].pairs;
+    }
+    return (double)total * 1000.0 / (double)(bench_now_ns() - start);
+}
+
+int main(void) {
+    // Attach the static drivers, before the threads start.
+    drv_dio_init();
+    for (size_t i = 0; i < BENCH_THREADS_MAX; i++) {
+        snprintf(names[i], BENCH_NAME_LEN, "contention_pin_%zu", i);
+        memcpy(&drivers[i], &(driver_t){ .name = names[i], .type = DRV_GPIO_PIN, .fops = &bench_pin_fops, .ctx = &ctxs[i] }, sizeof(driver_t));
+        if (drv_register(drv_dio, names[i], &drivers[i]) != 0) {
+            perror("drv_register");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-8s %20s %20s\n", "threads", "same [Mops/s]", "different [Mops/s]");
+    for (size_t threads = 1; threads <= BENCH_THREADS_MAX; threads *= 2) {
+        double same = bench_run(threads, true);
+        double different = bench_run(threads, false);
+        printf("%-8zu %20.1f %20.1f\n", threads, same, different);
+    }
+
+    for (size_t i = 0; i < BENCH_THREADS_MAX; i++) {
+        drv_deregister(drv_dio, &drivers[i]);
+    }
+    if (atomic_load(&bench_errors) != 0) {
+        fprintf(stderr, "bench_open_contention: %zu failed opens/closes\n", atomic_load(&bench_errors));
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file    bench_ring.c
+ * @brief   Benchmark: Synchronous drv_fread() vs. submission/completion rings.
+ *
+ * @details
+ * One thread reads once from each of BENCH_DEVICES DIO pins per round:
+ * - sync: drv_fread() one after the other.
+ * - ring: One drv_submit() for all pins, then drv_reap() of all completions. The pins
+ *   have no submit fop, so the reads run on the worker pool.
+ * The pins simulate a device latency (0 and BENCH_LATENCY_US). With latency the ring
+ * overlaps up to DRV_RING_WORKERS reads, without latency it shows the cost of the
+ * hand-over to the workers.
+ * Prints the time per round in microseconds.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_ring.h>
+#include <drv_dio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEVICES       (64U)
+#define BENCH_NAME_LEN      (24U)
+#define BENCH_LATENCY_US    (100U)
+#define BENCH_ROUNDS        (20U)
+
+static long bench_latency_ns;                       // Simulated device latency of a read.
+
+static ssize_t bench_pin_read(driver_t* driver, void* buffer, size_t count) {
+    if (bench_latency_ns > 0) {
+        struct timespec delay = { .tv_sec = 0, .tv_nsec = bench_latency_ns };
+        nanosleep(&delay, NULL);
+    }
+    memset(buffer, 1, count);
+    return (ssize_t)count;
+}
+
+static const driver_fops_t bench_pin_fops = { .close = drv_open_release, .read = bench_pin_read };
+
+static driver_t drivers[BENCH_DEVICES];
+static driver_ctx_t ctxs[BENCH_DEVICES];
+static char names[BENCH_DEVICES][BENCH_NAME_LEN];
+static int fds[BENCH_DEVICES];
+static uint32_t values[BENCH_DEVICES];
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Reads all pins one after the other. Returns the time per round [us].
+static double bench_sync(void) {
+    uint64_t start = bench_now_ns();
+    for (size_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (size_t i = 0; i < BENCH_DEVICES; i++) {
+            if (drv_fread(fds[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+                return -1.0;
+            }
+        }
+    }
+    return (double)(bench_now_ns() - start) / 1000.0 / BENCH_ROUNDS;
+}
+
+// Reads all pins with one submission per round. Returns the time per round [us].
+static double bench_ring(drv_ring_t* ring) {
+    drv_cqe_t cqes[BENCH_DEVICES];
+    uint64_t start = bench_now_ns();
+    for (size_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (size_t i = 0; i < BENCH_DEVICES; i++) {
+            *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fds[i], .buffer = &values[i], .len = sizeof(values[i]), .user_data = i };
+        }
+        if (drv_submit(ring) != BENCH_DEVICES) {
+            return -1.0;
+        }
+        unsigned reaped = 0;
+        while (reaped < BENCH_DEVICES) {
+            int count = drv_reap(ring, cqes, BENCH_DEVICES, 1);
+            for (int i = 0; i < count; i++) {
+                if (cqes[i].result != sizeof(values[0])) {
+                    return -1.0;
+                }
+            }
+            reaped += (unsigned)count;
+        }
+    }
+    return (double)(bench_now_ns() - start) / 1000.0 / BENCH_ROUNDS;
+}
+
+int main(void) {
+    drv_dio_init();
+    for (size_t i = 0; i < BENCH_DEVICES; i++) {
+        snprintf(names[i], BENCH_NAME_LEN, "ring_pin_%zu", i);
+        memcpy(&drivers[i], &(driver_t){ .name = names[i], .type = DRV_GPIO_PIN, .fops = &bench_pin_fops, .ctx = &ctxs[i] }, sizeof(driver_t));
+        if (drv_register(drv_dio, names[i], &drivers[i]) != 0) {
+            perror("drv_register");
+            return EXIT_FAILURE;
+        }
+        fds[i] = drv_fopen(drv_dio, names[i], 0);
+        if (fds[i] < 0) {
+            perror("drv_fopen");
+            return EXIT_FAILURE;
+        }
+    }
+    drv_ring_t* ring = drv_ring_create(BENCH_DEVICES);
+    if (ring == NULL) {
+        perror("drv_ring_create");
+        return EXIT_FAILURE;
+    }
+
+    int result = 0;
+    printf("%d devices, %u workers\n", BENCH_DEVICES, DRV_RING_WORKERS);
+    printf("%-14s %16s %16s\n", "latency [us]", "sync [us/round]", "ring [us/round]");
+    for (unsigned latency = 0; latency <= BENCH_LATENCY_US; latency += BENCH_LATENCY_US) {
+        bench_latency_ns = (long)latency * 1000L;
+        double sync = bench_sync();
+        double ring_us = bench_ring(ring);
+        if ((sync < 0.0) || (ring_us < 0.0)) {
+            fprintf(stderr, "bench_ring: read failed\n");
+            result = EXIT_FAILURE;
+        }
+        printf("%-14u %16.1f %16.1f\n", latency, sync, ring_us);
+    }
+
+    drv_ring_destroy(ring);
+    for (size_t i = 0; i < BENCH_DEVICES; i++) {
+        drv_fclose(fds[i]);
+        drv_deregister(drv_dio, &drivers[i]);
+    }
+    return result;
+}
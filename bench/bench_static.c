@@ -0,0 +1,87 @@
+/**
+ * @file    bench_static.c
+ * @brief   Benchmark: Startup time of link-time vs. runtime registration.
+ *
+ * @details
+ * 1000 pins are registered at link time at the core driver (DRV_STATIC_REGISTER),
+ * another 1000 pins are registered at runtime at the DIO driver with drv_register().
+ * Measures the time until all pins of each set can be opened.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_static.h>
+#include <drv_core.h>
+#include <drv_dio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_PINS          (1000U)
+#define BENCH_NAME_LEN      (16U)
+
+// ---- Link-time registered pins: spin1000 .. spin1999 ----
+#define BENCH_PIN(n) \
+    static driver_ctx_t bench_ctx_##n = { .open_max = 0 }; \
+    static driver_t bench_pin_##n = { .name = "spin" #n, .type = DRV_GPIO_PIN, .ctx = &bench_ctx_##n }; \
+    DRV_STATIC_REGISTER(drv_core, "spin" #n, &bench_pin_##n);
+#define BENCH_PINS_10(p)    BENCH_PIN(p##0) BENCH_PIN(p##1) BENCH_PIN(p##2) BENCH_PIN(p##3) BENCH_PIN(p##4) \
+                            BENCH_PIN(p##5) BENCH_PIN(p##6) BENCH_PIN(p##7) BENCH_PIN(p##8) BENCH_PIN(p##9)
+#define BENCH_PINS_100(p)   BENCH_PINS_10(p##0) BENCH_PINS_10(p##1) BENCH_PINS_10(p##2) BENCH_PINS_10(p##3) BENCH_PINS_10(p##4) \
+                            BENCH_PINS_10(p##5) BENCH_PINS_10(p##6) BENCH_PINS_10(p##7) BENCH_PINS_10(p##8) BENCH_PINS_10(p##9)
+#define BENCH_PINS_1000(p)  BENCH_PINS_100(p##0) BENCH_PINS_100(p##1) BENCH_PINS_100(p##2) BENCH_PINS_100(p##3) BENCH_PINS_100(p##4) \
+                            BENCH_PINS_100(p##5) BENCH_PINS_100(p##6) BENCH_PINS_100(p##7) BENCH_PINS_100(p##8) BENCH_PINS_100(p##9)
+
+BENCH_PINS_1000(1)
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(void) {
+    // Link-time registration: Sort table once and attach to the core registry.
+    uint64_t start = bench_now_ns();
+    drv_core_init();
+    uint64_t static_ns = bench_now_ns() - start;
+
+    // Runtime registration at the DIO driver.
+    driver_t* drivers = calloc(BENCH_PINS, sizeof(driver_t));
+    driver_ctx_t* ctxs = calloc(BENCH_PINS, sizeof(driver_ctx_t));
+    char (*names)[BENCH_NAME_LEN] = calloc(BENCH_PINS, BENCH_NAME_LEN);
+    for (size_t i = 0; i < BENCH_PINS; i++) {
+        snprintf(names[i], BENCH_NAME_LEN, "dpin%zu", 1000 + i);
+        memcpy(&ctxs[i], &(driver_ctx_t){ .open_max = 0 }, sizeof(driver_ctx_t));
+        memcpy(&drivers[i], &(driver_t){ .name = names[i], .type = DRV_GPIO_PIN, .ctx = &ctxs[i] }, sizeof(driver_t));
+    }
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_PINS; i++) {
+        if (drv_register(drv_dio, names[i], &drivers[i]) != 0) {
+            perror("drv_register");
+            return EXIT_FAILURE;
+        }
+    }
+    uint64_t runtime_ns = bench_now_ns() - start;
+
+    // Both sets must be usable.
+    if ((drv_open(drv_core, "spin1999") == NULL) || (drv_open(drv_dio, "dpin1999") == NULL)) {
+        perror("drv_open");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-24s %12s\n", "registration", "startup [us]");
+    printf("%-24s %12.1f\n", "link-time (static)", static_ns / 1000.0);
+    printf("%-24s %12.1f\n", "runtime (drv_register)", runtime_ns / 1000.0);
+
+    for (size_t i = 0; i < BENCH_PINS; i++) {
+        drv_deregister(drv_dio, &drivers[i]);
+    }
+    free(names);
+    free(ctxs);
+    free(drivers);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file    bench_trace.c
+ * @brief   Benchmark: Cost of the call trace (drv_trace.h) per drv_read().
+ *
+ * @details
+ * Polls a DIO pin BENCH_CALLS times with tracing off and on and prints the time per
+ * call in nanoseconds. Writes the trace to the file given as argument, if any
+ * (decode it with drv_trace_decode).
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#include <driver.h>
+#include <drv_dio.h>
+#include <drv_trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CALLS     (20000000UL)
+
+// Polled pin: Returns its level.
+static ssize_t bench_pin_read(driver_t* driver, void* buffer, size_t count) {
+    *(volatile uint8_t*)buffer = 1;
+    return 1;
+}
+
+static const driver_fops_t bench_pin_fops = {
+    .close = drv_open_release,
+    .read = bench_pin_read,
+};
+static driver_ctx_t bench_ctx = { .open_max = 0 };
+static driver_t bench_pin = { .name = "trace_pin", .type = DRV_GPIO_PIN, .fops = &bench_pin_fops, .ctx = &bench_ctx };
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Time per drv_read() [ns].
+static double bench_read(driver_t* pin, uint64_t* errors) {
+    uint8_t level;
+    uint64_t start = bench_now_ns();
+    for (unsigned long i = 0; i < BENCH_CALLS; i++) {
+        *errors += (drv_read(pin, &level, 1) != 1);
+    }
+    return (double)(bench_now_ns() - start) / BENCH_CALLS;
+}
+
+int main(int argc, char* argv[]) {
+    drv_dio_init();
+    if (drv_register(drv_dio, "trace_pin", &bench_pin) != 0) {
+        perror("drv_register");
+        return EXIT_FAILURE;
+    }
+    driver_t* pin = drv_open(drv_dio, "trace_pin");
+    if (pin == NULL) {
+        perror("drv_open");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t errors = 0;
+    double off = bench_read(pin, &errors);
+    drv_trace_enable(1);
+    double on = bench_read(pin, &errors);
+    drv_trace_enable(0);
+
+    printf("%-8s %16s %16s\n", "call", "trace off [ns]", "trace on [ns]");
+    printf("%-8s %16.2f %16.2f\n", "read", off, on);
+
+    if (argc > 1) {
+        FILE* out = fopen(argv[1], "wb");
+        if ((out == NULL) || (drv_trace_dump(out) != 0)) {
+            perror(argv[1]);
+            return EXIT_FAILURE;
+        }
+        fclose(out);
+    }
+
+    drv_close(pin);
+    drv_deregister(drv_dio, &bench_pin);
+    if (errors != 0) {
+        fprintf(stderr, "bench_trace: %llu failed calls\n", (unsigned long long)errors);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -1,21 +1,433 @@
 #include <driver.h>
+#include <path_cache.h>
+#include <registry.h>
+#include <intern.h>
+#include <drv_file.h>
+#include <epoch.h>
+#include <drv_stats.h>
+#include <drv_trace.h>
+#include <drv_wait.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#define DRV_POLL_STACK  (16U)       /// Entries of drv_poll() without allocation.
+
+/*
+ * LOCAL Types
+ */
+typedef struct drv_saved_ctx_s {
+    driver_t* parent;
+    const char* reg_name;
+    uint32_t reg_name_hash;
+    uint32_t reg_name_len;
+} drv_saved_ctx_t;
+
+// State of one entry of drv_poll().
+typedef struct drv_poll_slot_s {
+    drv_wait_entry_t entry;                         // Registration in the wait queue of the driver.
+    int held;                                       // true: Reference taken, entry registered after the first check.
+} drv_poll_slot_t;
+
+// Readiness exported by drv_eventfd_open(). entry first: drv_wait_remove_fd() returns the container.
+typedef struct drv_eventfd_s {
+    drv_wait_entry_t entry;
+    drv_waiter_t waiter;                            // Signals the eventfd.
+} drv_eventfd_t;
+
+/*
+ * LOCAL Functions
+ */
+// Sets parent and interned registered name (with hash and length) of a driver.
+static void drv_set_parent(driver_t* driver, driver_t* parent, const char* reg_name, uint32_t hash, uint32_t len) {
+    if (driver->ctx != NULL) {
+        driver->ctx->parent = parent;               // Overwrite parent explicit!
+        driver->ctx->reg_name = reg_name;           // Overwrite name explicit!
+        driver->ctx->reg_name_hash = hash;
+        driver->ctx->reg_name_len = len;
+    }
+}
+
+// Releases a deregistered driver after its last reference (see drv_release_unused()).
+// refs is reset first, so the driver can be registered again. The release fop may free the driver.
+static void drv_release(void* driver) {
+    driver_t* drv = (driver_t*)driver;
+    atomic_store(&drv->ctx->epoch_release, false);
+    atomic_store(&drv->ctx->refs, 0);
+    if ((drv->fops != NULL) && (drv->fops->release != NULL)) {
+        drv->fops->release(drv);
+    }
+}
+
+// Releases a driver after its last reference. Only lookups in a concurrent registry may still see it:
+// Those release after their epoch. Other registries are serialized by the caller, no reader is left.
+static void drv_release_unused(driver_t* drv) {
+    if (atomic_load(&drv->ctx->epoch_release)) {
+        epoch_retire(drv, drv_release);
+    } else {
+        drv_release(drv);
+    }
+}
+
+// Takes a reference for an open or a running operation. Fails, if the driver has been deregistered.
+static int drv_ref_get(driver_t* drv) {
+    if (drv->ctx == NULL) {
+        return 0;                                   // No context, no accounting.
+    }
+    size_t refs = atomic_load_explicit(&drv->ctx->refs, memory_order_relaxed);
+    do {
+        if (refs & DRV_REF_DEAD) {
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&drv->ctx->refs, &refs, refs + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+    return 0;
+}
+
+// Drops a reference. The last reference of a deregistered driver releases it. Keeps errno.
+static void drv_ref_put(driver_t* drv) {
+    if ((drv->ctx != NULL) &&
+        (atomic_fetch_sub_explicit(&drv->ctx->refs, 1, memory_order_acq_rel) == (DRV_REF_DEAD | 1U))) {
+        int error = errno;
+        drv_release_unused(drv);
+        errno = error;
+    }
+}
+
+// Marks a deregistered driver dead: New opens and operations fail. Releases it, if it isn't used.
+static void drv_ref_kill(driver_t* drv) {
+    if ((drv->ctx != NULL) && (atomic_fetch_or(&drv->ctx->refs, DRV_REF_DEAD) == 0)) {
+        drv_release_unused(drv);
+    }
+}
+
+// Checks, if a driver can be registered: A previous registration must be released completely.
+static int drv_ref_check_free(const driver_t* drv) {
+    if ((drv->ctx != NULL) && (atomic_load(&drv->ctx->refs) & DRV_REF_DEAD)) {
+        errno = EBUSY;
+        return -1;
+    }
+    return 0;
+}
+
+// Finds a registered driver without changing its open counter. Fallback without lookup fop: open and close again.
+static driver_t* drv_lookup(driver_t* dir, const char* name) {
+    if ((dir->fops == NULL) || ((dir->fops->lookup == NULL) && (dir->fops->open == NULL))) {
+        errno = ENOTDIR;
+        return NULL;
+    }
+
+    if (dir->fops->lookup != NULL) {
+        return dir->fops->lookup(dir, name);
+    }
+
+    driver_t* driver = dir->fops->open(dir, name);
+    if (driver != NULL) {
+        (void)drv_close(driver);
+    }
+    return driver;
+}
+
+// Resolves the directory part of a path component by component. The components are separated by '\0' temporarily.
+static driver_t* drv_walk(driver_t* dir, char* path) {
+    for (char* name = path; dir != NULL; ) {
+        char* next = strchr(name, '/');
+        if (next != NULL) {
+            *next = '\0';
+        }
+        dir = drv_lookup(dir, name);
+        if (next == NULL) {
+            break;
+        }
+        *next = '/';
+        name = next + 1;
+    }
+    return dir;
+}
+
+// Marks all drivers without error as canceled, because another driver of the batch failed.
+static void drv_cancel_batch(int* errors, size_t count) {
+    for (size_t i = 0; (errors != NULL) && (i < count); i++) {
+        if (errors[i] == 0) {
+            errors[i] = ECANCELED;
+        }
+    }
+}
+
+// Fallback of drv_register_many(), if the base driver has no reg_drv_many. Registers one by one, rolls back on error.
+static int drv_register_each(driver_t* base_driver, const char* const reg_names[], driver_t* const drivers[], size_t count, int* errors) {
+    for (size_t i = 0; i < count; i++) {
+        if (base_driver->fops->reg_drv(base_driver, reg_names[i], drivers[i]) == 0) {
+            continue;
+        }
+
+        int error = errno;
+        if (errors != NULL) {
+            errors[i] = error;
+        }
+        while ((i > 0) && (base_driver->fops->dereg_drv != NULL)) {
+            i--;
+            base_driver->fops->dereg_drv(base_driver, drivers[i]);
+        }
+        drv_cancel_batch(errors, count);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+// Fallback of drv_deregister_many(), if the base driver has no dereg_drv_many. Deregisters one by one, rolls back on error.
+static int drv_deregister_each(driver_t* base_driver, driver_t* const drivers[], size_t count, int* errors) {
+    for (size_t i = 0; i < count; i++) {
+        if (base_driver->fops->dereg_drv(base_driver, drivers[i]) == 0) {
+            continue;
+        }
+
+        int error = errno;
+        if (errors != NULL) {
+            errors[i] = error;
+        }
+        while ((i > 0) && (base_driver->fops->reg_drv != NULL)) {
+            i--;
+            base_driver->fops->reg_drv(base_driver, drivers[i]->ctx->reg_name, drivers[i]);
+        }
+        drv_cancel_batch(errors, count);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+// Checks the segments of drv_readv()/drv_writev(). The total length must fit into the return value.
+static int drv_iov_check(const struct iovec* iov, int iovcnt) {
+    if ((iovcnt < 0) || (iovcnt > DRV_IOV_MAX) || ((iov == NULL) && (iovcnt > 0))) {
+        return -1;
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if ((iov[i].iov_base == NULL) && (iov[i].iov_len > 0)) {
+            return -1;
+        }
+        if (iov[i].iov_len > (size_t)SSIZE_MAX - total) {
+            return -1;
+        }
+        total += iov[i].iov_len;
+    }
+    return 0;
+}
+
+// Fallback of drv_readv(), if the driver has no readv. Reads segment by segment, stops at a short read.
+// An error after the first segment returns the number of bytes read so far.
+static ssize_t drv_readv_each(driver_t* drv, const struct iovec* iov, int iovcnt) {
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t result = drv->fops->read(drv, iov[i].iov_base, iov[i].iov_len);
+        if (result < 0) {
+            return (total > 0) ? total : -1;
+        }
+        total += result;
+        if ((size_t)result < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+// Fallback of drv_writev(), if the driver has no writev. Writes segment by segment, stops at a short write.
+// An error after the first segment returns the number of bytes written so far.
+static ssize_t drv_writev_each(driver_t* drv, const struct iovec* iov, int iovcnt) {
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t result = drv->fops->write(drv, iov[i].iov_base, iov[i].iov_len);
+        if (result < 0) {
+            return (total > 0) ? total : -1;
+        }
+        total += result;
+        if ((size_t)result < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+// Fallback of drv_ioctl_batch(), if the driver has no ioctl_batch. Calls ioctl per request.
+static int drv_ioctl_each(driver_t* drv, const drv_ioctl_req_t* reqs, size_t count, int* results, int flags) {
+    int first_error = 0;
+    for (size_t i = 0; i < count; i++) {
+        int result = 0;
+        if (drv->fops->ioctl(drv, reqs[i].id, reqs[i].param) != 0) {
+            result = errno;
+            first_error = (first_error == 0) ? result : first_error;
+        }
+        if (results != NULL) {
+            results[i] = result;
+        }
+        if ((result != 0) && (flags & DRV_IOCTL_BATCH_STOP)) {
+            for (i++; (results != NULL) && (i < count); i++) {
+                results[i] = ECANCELED;
+            }
+            break;
+        }
+    }
+    if (first_error != 0) {
+        errno = first_error;
+        return -1;
+    }
+    return 0;
+}
+
+// Stubs of drv_bind() for missing fops.
+static ssize_t drv_bound_no_read(driver_t* drv, void* buffer, size_t count) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+static ssize_t drv_bound_no_write(driver_t* drv, const void* buffer, size_t count) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+static int drv_bound_no_ioctl(driver_t* drv, size_t id, void* param) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+// Driver lends its own read buffers. Otherwise drv_acquire_read_buf() reads into a copy.
+static int drv_lends_read_buf(const driver_t* drv) {
+    return (drv->fops->acquire_read_buf != NULL) && (drv->fops->release_read_buf != NULL);
+}
+
+// Driver lends its own write buffers. Otherwise drv_commit_write_buf() writes a copy.
+static int drv_lends_write_buf(const driver_t* drv) {
+    return (drv->fops->acquire_write_buf != NULL) && (drv->fops->commit_write_buf != NULL);
+}
+
+// Ready events of one entry of drv_poll(). Drivers without poll fop are always ready for reading and writing.
+static short drv_poll_events(driver_t* drv, short events) {
+    if ((drv == NULL) || (drv->fops == NULL)) {
+        return POLLNVAL;
+    }
+    if ((drv->ctx != NULL) && (atomic_load_explicit(&drv->ctx->refs, memory_order_acquire) & DRV_REF_DEAD)) {
+        return POLLHUP;                             // Deregistered: No more data.
+    }
+    if (drv->fops->poll != NULL) {
+        return drv->fops->poll(drv, events) & (events | POLLERR | POLLHUP | POLLNVAL);
+    }
+    return events & (POLLIN | POLLOUT | POLLRDNORM | POLLWRNORM);
+}
+
+// Fills revents of all entries of drv_poll(). Returns the number of ready entries.
+static int drv_poll_check(drv_pollfd_t* fds, const drv_poll_slot_t* slots, size_t count) {
+    int ready = 0;
+    for (size_t i = 0; i < count; i++) {
+        driver_t* drv = fds[i].driver;
+        if ((drv != NULL) && (drv->fops != NULL) && (drv->ctx != NULL) && !slots[i].held) {
+            fds[i].revents = POLLHUP;               // No reference: Deregistered before drv_poll().
+        } else {
+            fds[i].revents = drv_poll_events(drv, fds[i].events);
+        }
+        ready += (fds[i].revents != 0);
+    }
+    return ready;
+}
+
+// Sleeps in the wait queues of all referenced drivers of drv_poll(), until one is ready or the deadline
+// (NULL: none) passes. Returns the number of ready entries, 0 on timeout (errno = ETIMEDOUT).
+static int drv_poll_wait(drv_pollfd_t* fds, drv_poll_slot_t* slots, size_t count, const struct timespec* deadline) {
+    drv_waiter_t waiter;
+    if (drv_waiter_init(&waiter, -1) != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i].held) {
+            drv_wait_add(&fds[i].driver->ctx->wait, &slots[i].entry, &waiter);
+        }
+    }
+
+    int ready;
+    for (;;) {
+        // Check after the reset: A wake during the check ends the following sleep at once.
+        drv_waiter_reset(&waiter);
+        ready = drv_poll_check(fds, slots, count);
+        if (ready > 0) {
+            break;
+        }
+        if (drv_waiter_sleep(&waiter, deadline) != 0) {
+            ready = (errno == ETIMEDOUT) ? 0 : -1;
+            break;
+        }
+    }
+
+    int error = errno;
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i].held) {
+            drv_wait_remove(&fds[i].driver->ctx->wait, &slots[i].entry);
+        }
+    }
+    drv_waiter_destroy(&waiter);
+    errno = error;
+    return ready;
+}
+
+// Fallback of drv_read_timed()/drv_write_timed() and of drv_fread()/drv_fwrite() for drivers without timed fops:
+// Reads or writes, and waits for the readiness only after EAGAIN. Any other result, also an error, returns at once.
+static ssize_t drv_io_timed(driver_t* drv, void* buffer, size_t count, int write, int flags, const struct timespec* deadline) {
+    if (write && (drv->fops->write_timed != NULL)) {
+        return drv->fops->write_timed(drv, buffer, count, flags, deadline);
+    }
+    if (!write && (drv->fops->read_timed != NULL)) {
+        return drv->fops->read_timed(drv, buffer, count, flags, deadline);
+    }
+
+    // Without poll fop or context the driver can't be waited for: Its own read or write decides.
+    int waitable = (drv->fops->poll != NULL) && (drv->ctx != NULL);
+    for (;;) {
+        ssize_t result = write ? drv->fops->write(drv, buffer, count) : drv->fops->read(drv, buffer, count);
+        if ((result >= 0) || (errno != EAGAIN) || !waitable || (flags & O_NONBLOCK)) {
+            return result;
+        }
+        if (drv_wait_ready(drv, write ? POLLOUT : POLLIN, flags, deadline) != 0) {
+            return -1;
+        }
+    }
+}
+
+// Marks a driver dead after its deregistration and wakes its pollers: They see POLLHUP.
+static void drv_ref_kill_wake(driver_t* drv) {
+    int held = (drv_ref_get(drv) == 0);             // Keeps the wait queue alive until the pollers are woken.
+    drv_ref_kill(drv);
+    if (held) {
+        drv_wake(drv);
+        drv_ref_put(drv);
+    }
+}
 
 /*
  * GLOBAL Functions
  */
 int drv_register(const driver_t* const base_driver, const char* const name, const driver_t* const driver) {
     // Parameter check
-    if ((base_driver == NULL) || (name == NULL) || (strlen(name) == 0) || (driver == NULL)) {
+    if ((base_driver == NULL) || (name == NULL) || (name[0] == '\0') || (driver == NULL)) {
         errno = EINVAL;
         return -1;
     }
 
-    if (driver->ctx != NULL) {
-        driver->ctx->parent = base_driver;      // Overwrite parent explicit!
-        driver->ctx->reg_name = name;           // Overwrite name explicit!
+    if (drv_ref_check_free(driver) != 0) {
+        return -1;
+    }
+
+    uint32_t hash, len;
+    const char* reg_name = intern_str(name, &hash, &len);
+    if (reg_name == NULL) {
+        return -1;
     }
+    drv_set_parent((driver_t*)driver, (driver_t*)base_driver, reg_name, hash, len);
 
     if (base_driver->fops == NULL) {
         errno = ENOSYS;
@@ -23,7 +435,11 @@ int drv_register(const driver_t* const base_driver, const char* const name, cons
     }
 
     if (base_driver->fops->reg_drv != NULL) { 
-        return base_driver->fops->reg_drv(base_driver, name, driver);
+        DRV_STATS_START(start);
+        int result = base_driver->fops->reg_drv(base_driver, reg_name, driver);
+        DRV_STATS_RECORD(base_driver, DRV_STAT_REGISTER, start, result != 0, 0);
+        DRV_TRACE(base_driver, DRV_TRACE_REGISTER, 1, result, result != 0);
+        return result;
     }
 
     errno = ENOTSUP;
@@ -43,7 +459,16 @@ int drv_deregister(const driver_t* const base_driver, const driver_t* const driv
     }
 
     if (base_driver->fops->dereg_drv != NULL) {
-        return base_driver->fops->dereg_drv(base_driver, driver);
+        DRV_STATS_START(start);
+        int result = base_driver->fops->dereg_drv(base_driver, driver);
+        DRV_STATS_RECORD(base_driver, DRV_STAT_DEREGISTER, start, result != 0, 0);
+        DRV_TRACE(base_driver, DRV_TRACE_DEREGISTER, 1, result, result != 0);
+        if (result != 0) {
+            return -1;
+        }
+        // No new opens from now on. Released, when the last open is closed.
+        drv_ref_kill_wake((driver_t*)driver);
+        return 0;
     }
 
     errno = ENOTSUP;
@@ -51,9 +476,193 @@ int drv_deregister(const driver_t* const base_driver, const driver_t* const driv
 
 }
 
+int drv_register_many(const driver_t* const base_driver, const char* const names[], const driver_t* const drivers[], size_t count, int* errors) {
+    // Parameter check
+    if ((base_driver == NULL) || (((names == NULL) || (drivers == NULL)) && (count > 0))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (base_driver->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((base_driver->fops->reg_drv_many == NULL) && (base_driver->fops->reg_drv == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Check all drivers first. If one is invalid, none is registered.
+    int first_error = 0;
+    for (size_t i = 0; i < count; i++) {
+        int result = 0;
+        if ((names[i] == NULL) || (names[i][0] == '\0') || (drivers[i] == NULL)) {
+            result = EINVAL;
+            first_error = (first_error == 0) ? result : first_error;
+        }
+        else if (drv_ref_check_free(drivers[i]) != 0) {
+            result = EBUSY;
+            first_error = (first_error == 0) ? result : first_error;
+        }
+        if (errors != NULL) {
+            errors[i] = result;
+        }
+    }
+    if (first_error != 0) {
+        drv_cancel_batch(errors, count);
+        errno = first_error;
+        return -1;
+    }
+
+    // Save parent and name, to restore them if the batch fails. The fops get the interned names, like drv_register().
+    drv_saved_ctx_t* saved = malloc(count * sizeof(drv_saved_ctx_t));
+    const char** reg_names = malloc(count * sizeof(const char*));
+    if (((saved == NULL) || (reg_names == NULL)) && (count > 0)) {
+        free(saved);
+        free(reg_names);
+        errno = ENOMEM;
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t hash, len;
+        const char* reg_name = intern_str(names[i], &hash, &len);
+        if (reg_name == NULL) {
+            int error = errno;
+            while (i > 0) {
+                i--;
+                drv_set_parent((driver_t*)drivers[i], saved[i].parent, saved[i].reg_name, saved[i].reg_name_hash, saved[i].reg_name_len);
+            }
+            free(saved);
+            free(reg_names);
+            errno = error;
+            return -1;
+        }
+        reg_names[i] = reg_name;
+        if (drivers[i]->ctx != NULL) {
+            saved[i].parent = drivers[i]->ctx->parent;
+            saved[i].reg_name = drivers[i]->ctx->reg_name;
+            saved[i].reg_name_hash = drivers[i]->ctx->reg_name_hash;
+            saved[i].reg_name_len = drivers[i]->ctx->reg_name_len;
+        }
+        drv_set_parent((driver_t*)drivers[i], (driver_t*)base_driver, reg_name, hash, len);
+    }
+
+    int result;
+    DRV_STATS_START(start);
+    if (base_driver->fops->reg_drv_many != NULL) {
+        result = base_driver->fops->reg_drv_many((driver_t*)base_driver, reg_names, (driver_t* const*)drivers, count, errors);
+    }
+    else {
+        result = drv_register_each((driver_t*)base_driver, reg_names, (driver_t* const*)drivers, count, errors);
+    }
+    DRV_STATS_RECORD(base_driver, DRV_STAT_REGISTER, start, result != 0, 0);
+    DRV_TRACE(base_driver, DRV_TRACE_REGISTER, count, result, result != 0);
+
+    if (result != 0) {
+        int error = errno;
+        for (size_t i = 0; i < count; i++) {
+            drv_set_parent((driver_t*)drivers[i], saved[i].parent, saved[i].reg_name, saved[i].reg_name_hash, saved[i].reg_name_len);
+        }
+        errno = error;
+    }
+    free(saved);
+    free(reg_names);
+    return result;
+}
+
+int drv_replace(const driver_t* const base_driver, const driver_t* const old_driver, const driver_t* const new_driver) {
+    // Parameter check
+    if ((base_driver == NULL) || (old_driver == NULL) || (new_driver == NULL) || (old_driver == new_driver)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // The new driver takes over the interned registered name of the old one.
+    if ((old_driver->ctx == NULL) || (old_driver->ctx->reg_name == NULL) || (old_driver->ctx->parent != base_driver)) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (drv_ref_check_free(new_driver) != 0) {
+        return -1;
+    }
+
+    if (base_driver->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if (base_driver->fops->replace_drv == NULL) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    const driver_ctx_t* ctx = old_driver->ctx;
+    drv_set_parent((driver_t*)new_driver, (driver_t*)base_driver, ctx->reg_name, ctx->reg_name_hash, ctx->reg_name_len);
+    DRV_STATS_START(start);
+    int result = base_driver->fops->replace_drv((driver_t*)base_driver, (driver_t*)old_driver, (driver_t*)new_driver);
+    DRV_STATS_RECORD(base_driver, DRV_STAT_REGISTER, start, result != 0, 0);
+    DRV_TRACE(base_driver, DRV_TRACE_REGISTER, 1, result, result != 0);
+    // The old driver isn't killed: Its opens stay valid and it can be registered again.
+    return result;
+}
+
+int drv_deregister_many(const driver_t* const base_driver, const driver_t* const drivers[], size_t count, int* errors) {
+    // Parameter check
+    if ((base_driver == NULL) || ((drivers == NULL) && (count > 0))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (base_driver->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((base_driver->fops->dereg_drv_many == NULL) && (base_driver->fops->dereg_drv == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Check all drivers first. If one is invalid, none is deregistered.
+    int first_error = 0;
+    for (size_t i = 0; i < count; i++) {
+        int result = 0;
+        if (drivers[i] == NULL) {
+            result = EINVAL;
+            first_error = (first_error == 0) ? result : first_error;
+        }
+        if (errors != NULL) {
+            errors[i] = result;
+        }
+    }
+    if (first_error != 0) {
+        drv_cancel_batch(errors, count);
+        errno = first_error;
+        return -1;
+    }
+
+    int result;
+    DRV_STATS_START(start);
+    if (base_driver->fops->dereg_drv_many != NULL) {
+        result = base_driver->fops->dereg_drv_many((driver_t*)base_driver, (driver_t* const*)drivers, count, errors);
+    }
+    else {
+        result = drv_deregister_each((driver_t*)base_driver, (driver_t* const*)drivers, count, errors);
+    }
+    DRV_STATS_RECORD(base_driver, DRV_STAT_DEREGISTER, start, result != 0, 0);
+    DRV_TRACE(base_driver, DRV_TRACE_DEREGISTER, count, result, result != 0);
+
+    // No new opens from now on. Each driver is released, when its last open is closed.
+    for (size_t i = 0; (result == 0) && (i < count); i++) {
+        drv_ref_kill_wake((driver_t*)drivers[i]);
+    }
+    return result;
+}
+
 driver_t* drv_open(const driver_t* const base_driver, const char* const name) {
     // Parameter check
-    if ((base_driver == NULL) || (name == NULL) || (strlen(name) == 0)) {
+    if ((base_driver == NULL) || (name == NULL) || (name[0] == '\0')) {
         errno = EINVAL;
         return NULL;
     }
@@ -64,13 +673,85 @@ driver_t* drv_open(const driver_t* const base_driver, const char* const name) {
     }
 
     if (base_driver->fops->open != NULL) {
-        return base_driver->fops->open(base_driver, name);
+        DRV_STATS_START(start);
+        driver_t* driver = base_driver->fops->open(base_driver, name);
+        DRV_STATS_RECORD(base_driver, DRV_STAT_OPEN, start, driver == NULL, 0);
+        DRV_TRACE(base_driver, DRV_TRACE_OPEN, 0, (driver == NULL) ? -1 : 0, driver == NULL);
+        return driver;
     }
 
     errno = ENOTSUP;
     return NULL;
 }
 
+driver_t* drv_open_path(const driver_t* const base_driver, const char* const path) {
+    // Parameter check
+    if ((base_driver == NULL) || (path == NULL) || (path[0] == '\0')) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t len = strlen(path);
+    if (len >= DRV_PATH_MAX) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+
+    // No empty components (leading, trailing or double '/').
+    if ((path[0] == '/') || (path[len - 1] == '/') || (strstr(path, "//") != NULL)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    const char* leaf = strrchr(path, '/');
+    if (leaf == NULL) {
+        return drv_open(base_driver, path);
+    }
+
+    // Directory part of the path: One cache probe, walk only on a miss.
+    char dir_path[DRV_PATH_MAX];
+    size_t dir_len = (size_t)(leaf - path);
+    memcpy(dir_path, path, dir_len);
+    dir_path[dir_len] = '\0';
+
+    // The generation is read before the walk: A driver removed during the walk invalidates the new entry.
+    uint32_t hash = path_cache_hash(base_driver, dir_path);
+    uint32_t generation = registry_generation();
+
+    // Resolve in an epoch and hold the directory by a reference: A concurrently deregistered
+    // directory is released only after the epoch and the reference are left.
+    if (epoch_enter() != 0) {
+        return NULL;
+    }
+    driver_t* dir = path_cache_lookup(base_driver, dir_path, hash);
+    if (dir == NULL) {
+        dir = drv_walk((driver_t*)base_driver, dir_path);
+        if (dir != NULL) {
+            path_cache_insert(base_driver, dir_path, hash, dir, generation);
+        }
+    }
+    if ((dir != NULL) && (drv_ref_get(dir) != 0)) {
+        dir = NULL;
+        errno = ENOENT;                             // Deregistered in between.
+    }
+    epoch_exit();
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    driver_t* driver = NULL;
+    if ((dir->fops == NULL) || (dir->fops->open == NULL)) {
+        errno = ENOTDIR;
+    } else {
+        DRV_STATS_START(start);
+        driver = dir->fops->open(dir, leaf + 1);
+        DRV_STATS_RECORD(dir, DRV_STAT_OPEN, start, driver == NULL, 0);
+        DRV_TRACE(dir, DRV_TRACE_OPEN, 0, (driver == NULL) ? -1 : 0, driver == NULL);
+    }
+    drv_ref_put(dir);
+    return driver;
+}
+
 int drv_close(driver_t* drv) {
     // Parameter check
     if (drv == NULL) {
@@ -84,8 +765,11 @@ int drv_close(driver_t* drv) {
     }
 
     if (drv->fops->close != NULL) {
-        return drv->fops->close(drv);
-
+        DRV_STATS_START(start);
+        int result = drv->fops->close(drv);
+        DRV_STATS_RECORD(drv, DRV_STAT_CLOSE, start, result != 0, 0);
+        DRV_TRACE(drv, DRV_TRACE_CLOSE, 0, result, result != 0);
+        return result;
     }
 
     errno = ENOTSUP;
@@ -110,7 +794,17 @@ ssize_t drv_read(driver_t* drv, void* buffer, size_t count) {
     }
 
     if (drv->fops->read != NULL) {
-        return drv->fops->read(drv, buffer, count);
+        // Reference for the running operation: A deregistered driver is released afterwards.
+        if (drv_ref_get(drv) != 0) {
+            errno = ENODEV;
+            return -1;
+        }
+        DRV_STATS_START(start);
+        ssize_t result = drv->fops->read(drv, buffer, count);
+        DRV_STATS_RECORD(drv, DRV_STAT_READ, start, result < 0, (result > 0) ? (size_t)result : 0);
+        DRV_TRACE(drv, DRV_TRACE_READ, count, result, result < 0);
+        drv_ref_put(drv);
+        return result;
     }
 
     errno = ENOTSUP;
@@ -135,29 +829,812 @@ ssize_t drv_write(driver_t* drv, const void* buffer, size_t count) {
     }
 
     if (drv->fops->write != NULL) {
-        return drv->fops->write(drv, buffer, count);
+        // Reference for the running operation: A deregistered driver is released afterwards.
+        if (drv_ref_get(drv) != 0) {
+            errno = ENODEV;
+            return -1;
+        }
+        DRV_STATS_START(start);
+        ssize_t result = drv->fops->write(drv, buffer, count);
+        DRV_STATS_RECORD(drv, DRV_STAT_WRITE, start, result < 0, (result > 0) ? (size_t)result : 0);
+        DRV_TRACE(drv, DRV_TRACE_WRITE, count, result, result < 0);
+        drv_ref_put(drv);
+        return result;
     }
 
     errno = ENOTSUP;
     return -1;
 }
 
-int drv_ioctl(driver_t* drv, size_t id, void* param) {
+ssize_t drv_readv(driver_t* drv, const struct iovec* iov, int iovcnt) {
     // Parameter check
     if (drv == NULL) {
         errno = EBADF;
         return -1;
     }
 
+    if (drv_iov_check(iov, iovcnt) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
     if (drv->fops == NULL) {
         errno = ENOSYS;
         return -1;
     }
 
-    if (drv->fops->ioctl != NULL) {
-        return drv->fops->ioctl(drv, id, param);
+    if ((drv->fops->readv == NULL) && (drv->fops->read == NULL)) {
+        errno = ENOTSUP;
+        return -1;
     }
 
-    errno = ENOTSUP;
-    return -1;
+    // One reference and one dispatch for all segments.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    ssize_t result;
+    DRV_STATS_START(start);
+    if (drv->fops->readv != NULL) {
+        result = drv->fops->readv(drv, iov, iovcnt);
+    } else {
+        result = drv_readv_each(drv, iov, iovcnt);
+    }
+    DRV_STATS_RECORD(drv, DRV_STAT_READ, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_READ, iovcnt, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+ssize_t drv_writev(driver_t* drv, const struct iovec* iov, int iovcnt) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (drv_iov_check(iov, iovcnt) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->writev == NULL) && (drv->fops->write == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // One reference and one dispatch for all segments.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    ssize_t result;
+    DRV_STATS_START(start);
+    if (drv->fops->writev != NULL) {
+        result = drv->fops->writev(drv, iov, iovcnt);
+    } else {
+        result = drv_writev_each(drv, iov, iovcnt);
+    }
+    DRV_STATS_RECORD(drv, DRV_STAT_WRITE, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_WRITE, iovcnt, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+ssize_t drv_acquire_read_buf(driver_t* drv, const void** buffer, size_t count) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (buffer == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    *buffer = NULL;
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if (!drv_lends_read_buf(drv) && (drv->fops->read == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    if (count == 0) {
+        return 0;                                   // Nothing lent.
+    }
+
+    // The reference is held until the buffer is released.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    ssize_t result;
+    if (drv_lends_read_buf(drv)) {
+        result = drv->fops->acquire_read_buf(drv, buffer, count);
+    }
+    else {
+        // Fallback: Read into a copy. The data is consumed from the driver at once.
+        void* copy = malloc(count);
+        if (copy == NULL) {
+            drv_ref_put(drv);
+            errno = ENOMEM;
+            return -1;
+        }
+        result = drv->fops->read(drv, copy, count);
+        if (result > 0) {
+            *buffer = copy;
+        } else {
+            free(copy);
+        }
+    }
+    if (result <= 0) {
+        *buffer = NULL;
+        drv_ref_put(drv);                           // Nothing lent.
+    }
+    return result;
+}
+
+int drv_release_read_buf(driver_t* drv, const void* buffer, size_t count) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if ((buffer == NULL) || (drv->fops == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int result = 0;
+    if (drv_lends_read_buf(drv)) {
+        result = drv->fops->release_read_buf(drv, buffer, count);
+    } else {
+        free((void*)buffer);
+    }
+    drv_ref_put(drv);                               // From drv_acquire_read_buf().
+    return result;
+}
+
+ssize_t drv_acquire_write_buf(driver_t* drv, void** buffer, size_t count) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (buffer == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    *buffer = NULL;
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if (!drv_lends_write_buf(drv) && (drv->fops->write == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    if (count == 0) {
+        return 0;                                   // Nothing lent.
+    }
+
+    // The reference is held until the buffer is committed.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    ssize_t result;
+    if (drv_lends_write_buf(drv)) {
+        result = drv->fops->acquire_write_buf(drv, buffer, count);
+    }
+    else {
+        // Fallback: Buffer for a copy, written by drv_commit_write_buf().
+        *buffer = malloc(count);
+        result = (*buffer != NULL) ? (ssize_t)count : -1;
+        if (result < 0) {
+            errno = ENOMEM;
+        }
+    }
+    if (result <= 0) {
+        *buffer = NULL;
+        drv_ref_put(drv);                           // Nothing lent.
+    }
+    return result;
+}
+
+ssize_t drv_commit_write_buf(driver_t* drv, void* buffer, size_t count) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if ((buffer == NULL) || (drv->fops == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ssize_t result;
+    if (drv_lends_write_buf(drv)) {
+        result = drv->fops->commit_write_buf(drv, buffer, count);
+    }
+    else {
+        result = (count > 0) ? drv->fops->write(drv, buffer, count) : 0;
+        int error = errno;
+        free(buffer);
+        errno = error;
+    }
+    drv_ref_put(drv);                               // From drv_acquire_write_buf().
+    return result;
+}
+
+int drv_bind(driver_t* drv, drv_bound_t* bound) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (bound == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    // One reference for the lifetime of the handle instead of one per call.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    bound->driver = drv;
+    bound->read = (drv->fops->read != NULL) ? drv->fops->read : drv_bound_no_read;
+    bound->write = (drv->fops->write != NULL) ? drv->fops->write : drv_bound_no_write;
+    bound->ioctl = (drv->fops->ioctl != NULL) ? drv->fops->ioctl : drv_bound_no_ioctl;
+    return 0;
+}
+
+int drv_unbind(drv_bound_t* bound) {
+    // Parameter check
+    if ((bound == NULL) || (bound->driver == NULL)) {
+        errno = EBADF;
+        return -1;
+    }
+
+    driver_t* drv = bound->driver;
+    memset(bound, 0, sizeof(drv_bound_t));
+    drv_ref_put(drv);                               // From drv_bind(). May release the driver.
+    return 0;
+}
+
+int drv_ioctl_batch(driver_t* drv, const drv_ioctl_req_t* reqs, size_t count, int* results, int flags) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (((reqs == NULL) && (count > 0)) || ((flags & ~DRV_IOCTL_BATCH_STOP) != 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->ioctl_batch == NULL) && (drv->fops->ioctl == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // One reference and one dispatch for the whole batch.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    int result;
+    DRV_STATS_START(start);
+    if (drv->fops->ioctl_batch != NULL) {
+        result = drv->fops->ioctl_batch(drv, reqs, count, results, flags);
+    } else {
+        result = drv_ioctl_each(drv, reqs, count, results, flags);
+    }
+    DRV_STATS_RECORD(drv, DRV_STAT_IOCTL, start, result != 0, 0);
+    DRV_TRACE(drv, DRV_TRACE_IOCTL, count, result, result != 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+int drv_ioctl(driver_t* drv, size_t id, void* param) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if (drv->fops->ioctl != NULL) {
+        // Reference for the running operation: A deregistered driver is released afterwards.
+        if (drv_ref_get(drv) != 0) {
+            errno = ENODEV;
+            return -1;
+        }
+        DRV_STATS_START(start);
+        int result = drv->fops->ioctl(drv, id, param);
+        DRV_STATS_RECORD(drv, DRV_STAT_IOCTL, start, result != 0, 0);
+        DRV_TRACE(drv, DRV_TRACE_IOCTL, id, result, result != 0);
+        drv_ref_put(drv);
+        return result;
+    }
+
+    errno = ENOTSUP;
+    return -1;
+}
+
+int drv_fopen(const driver_t* const base_driver, const char* const name, int flags) {
+    driver_t* driver = drv_open(base_driver, name);
+    if (driver == NULL) {
+        return -1;
+    }
+
+    drv_file_t* file;
+    int fd = drv_fd_alloc(driver, flags, &file);
+    if (fd < 0) {
+        int error = errno;
+        (void)drv_close(driver);
+        errno = error;
+        return -1;
+    }
+
+    // Per-handle state of the driver.
+    if ((driver->fops != NULL) && (driver->fops->open_file != NULL) && (driver->fops->open_file(file) != 0)) {
+        int error = errno;
+        (void)drv_fd_free(fd);
+        (void)drv_close(driver);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+int drv_fclose(int fd) {
+    drv_file_t* file = drv_fd_get(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    // The handle is released in any case. The first error is reported.
+    driver_t* driver = file->driver;
+    int result = 0;
+    int error = 0;
+    if ((driver->fops != NULL) && (driver->fops->close_file != NULL) && (driver->fops->close_file(file) != 0)) {
+        result = -1;
+        error = errno;
+    }
+    (void)drv_fd_free(fd);
+    if ((drv_close(driver) != 0) && (result == 0)) {
+        result = -1;
+        error = errno;
+    }
+    if (result != 0) {
+        errno = error;
+    }
+    return result;
+}
+
+drv_file_t* drv_file(int fd) {
+    return drv_fd_get(fd);
+}
+
+ssize_t drv_fread(int fd, void* buffer, size_t count) {
+    drv_file_t* file = drv_fd_get(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    if ((buffer == NULL) && (count > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    driver_t* drv = file->driver;
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->read_file == NULL) && (drv->fops->read == NULL) && (drv->fops->read_timed == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Reference for the running operation: A deregistered driver is released afterwards.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    DRV_STATS_START(start);
+    // read_file sees the flags in the handle. Otherwise blocking handles wait for the readiness.
+    ssize_t result = (drv->fops->read_file != NULL) ? drv->fops->read_file(file, buffer, count)
+                                                    : drv_io_timed(drv, buffer, count, 0, file->flags, NULL);
+    DRV_STATS_RECORD(drv, DRV_STAT_READ, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_READ, count, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+ssize_t drv_fwrite(int fd, const void* buffer, size_t count) {
+    drv_file_t* file = drv_fd_get(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    if ((buffer == NULL) && (count > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    driver_t* drv = file->driver;
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->write_file == NULL) && (drv->fops->write == NULL) && (drv->fops->write_timed == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Reference for the running operation: A deregistered driver is released afterwards.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    DRV_STATS_START(start);
+    // write_file sees the flags in the handle. Otherwise blocking handles wait for the readiness.
+    ssize_t result = (drv->fops->write_file != NULL) ? drv->fops->write_file(file, buffer, count)
+                                                     : drv_io_timed(drv, (void*)buffer, count, 1, file->flags, NULL);
+    DRV_STATS_RECORD(drv, DRV_STAT_WRITE, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_WRITE, count, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+int drv_fioctl(int fd, size_t id, void* param) {
+    drv_file_t* file = drv_fd_get(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    driver_t* drv = file->driver;
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->ioctl_file == NULL) && (drv->fops->ioctl == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Reference for the running operation: A deregistered driver is released afterwards.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    DRV_STATS_START(start);
+    int result = (drv->fops->ioctl_file != NULL) ? drv->fops->ioctl_file(file, id, param) : drv->fops->ioctl(drv, id, param);
+    DRV_STATS_RECORD(drv, DRV_STAT_IOCTL, start, result != 0, 0);
+    DRV_TRACE(drv, DRV_TRACE_IOCTL, id, result, result != 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+int drv_poll(drv_pollfd_t* fds, size_t count, int timeout_ms) {
+    // Parameter check
+    if (((fds == NULL) && (count > 0)) || (count > INT_MAX)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    drv_poll_slot_t stack_slots[DRV_POLL_STACK];
+    drv_poll_slot_t* slots = stack_slots;
+    if (count > DRV_POLL_STACK) {
+        slots = malloc(count * sizeof(drv_poll_slot_t));
+        if (slots == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    // One reference per driver keeps it and its wait queue alive while polling.
+    for (size_t i = 0; i < count; i++) {
+        driver_t* drv = fds[i].driver;
+        slots[i].held = (drv != NULL) && (drv->fops != NULL) && (drv->ctx != NULL) && (drv_ref_get(drv) == 0);
+    }
+
+    // Sleep only, if nothing is ready yet.
+    int ready = drv_poll_check(fds, slots, count);
+    if ((ready == 0) && (timeout_ms != 0)) {
+        struct timespec deadline;
+        if (timeout_ms > 0) {
+            drv_wait_deadline(&deadline, timeout_ms);
+        }
+        ready = drv_poll_wait(fds, slots, count, (timeout_ms > 0) ? &deadline : NULL);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i].held) {
+            drv_ref_put(fds[i].driver);
+        }
+    }
+    if (slots != stack_slots) {
+        int error = errno;
+        free(slots);
+        errno = error;
+    }
+    return ready;
+}
+
+int drv_wake(driver_t* drv) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (drv->ctx != NULL) {
+        drv_wait_wake(&drv->ctx->wait);
+    }
+    return 0;
+}
+
+int drv_eventfd_open(driver_t* drv, short events) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    // The wait queue lives in the context.
+    if (drv->ctx == NULL) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+#ifdef __linux__
+    // The eventfd keeps the driver alive until drv_eventfd_close().
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    drv_eventfd_t* efd = malloc(sizeof(drv_eventfd_t));
+    int fd = (efd != NULL) ? eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) : -1;
+    if ((fd < 0) || (drv_waiter_init(&efd->waiter, fd) != 0)) {
+        int error = (efd == NULL) ? ENOMEM : errno;
+        if (fd >= 0) {
+            close(fd);
+        }
+        free(efd);
+        drv_ref_put(drv);
+        errno = error;
+        return -1;
+    }
+    drv_wait_add(&drv->ctx->wait, &efd->entry, &efd->waiter);
+
+    // Changes before the registration got no wake: Signal the current readiness once.
+    if (drv_poll_events(drv, events) != 0) {
+        uint64_t one = 1;
+        (void)!write(fd, &one, sizeof(one));
+    }
+    return fd;
+#else
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+int drv_eventfd_close(driver_t* drv, int fd) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if ((drv->ctx == NULL) || (fd < 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    drv_eventfd_t* efd = (drv_eventfd_t*)drv_wait_remove_fd(&drv->ctx->wait, fd);
+    if (efd == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+    drv_waiter_destroy(&efd->waiter);
+    close(fd);
+    free(efd);
+    drv_ref_put(drv);                               // From drv_eventfd_open(). May release the driver.
+    return 0;
+}
+
+ssize_t drv_read_timed(driver_t* drv, void* buffer, size_t count, const struct timespec* deadline) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (((buffer == NULL) && (count > 0)) ||
+        ((deadline != NULL) && ((deadline->tv_nsec < 0) || (deadline->tv_nsec >= 1000000000L)))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->read_timed == NULL) && (drv->fops->read == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Reference for the running operation: A deregistered driver is released afterwards.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    DRV_STATS_START(start);
+    ssize_t result = drv_io_timed(drv, buffer, count, 0, 0, deadline);
+    DRV_STATS_RECORD(drv, DRV_STAT_READ, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_READ, count, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+ssize_t drv_write_timed(driver_t* drv, const void* buffer, size_t count, const struct timespec* deadline) {
+    // Parameter check
+    if (drv == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (((buffer == NULL) && (count > 0)) ||
+        ((deadline != NULL) && ((deadline->tv_nsec < 0) || (deadline->tv_nsec >= 1000000000L)))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (drv->fops == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if ((drv->fops->write_timed == NULL) && (drv->fops->write == NULL)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Reference for the running operation: A deregistered driver is released afterwards.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENODEV;
+        return -1;
+    }
+    DRV_STATS_START(start);
+    ssize_t result = drv_io_timed(drv, (void*)buffer, count, 1, 0, deadline);
+    DRV_STATS_RECORD(drv, DRV_STAT_WRITE, start, result < 0, (result > 0) ? (size_t)result : 0);
+    DRV_TRACE(drv, DRV_TRACE_WRITE, count, result, result < 0);
+    drv_ref_put(drv);
+    return result;
+}
+
+// Waits inside an operation (the caller holds a reference), until the poll fop reports one of the events.
+// Drivers without poll fop or context are always ready. A wake without the events sleeps again.
+int drv_wait_ready(driver_t* drv, short events, int flags, const struct timespec* deadline) {
+    if ((drv == NULL) || (drv->fops == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((drv->fops->poll == NULL) || (drv->ctx == NULL)) {
+        return 0;
+    }
+
+    drv_pollfd_t fd = { .driver = drv, .events = events };
+    drv_poll_slot_t slot = { .held = 1 };
+    int ready = drv_poll_check(&fd, &slot, 1);
+    if ((ready == 0) && !(flags & O_NONBLOCK)) {
+        ready = drv_poll_wait(&fd, &slot, 1, deadline);
+    }
+    if (ready == 0) {
+        errno = (flags & O_NONBLOCK) ? EAGAIN : ETIMEDOUT;
+        return -1;
+    }
+    return (ready > 0) ? 0 : -1;
+}
+
+// Counts an open of a driver, if open_max allows it. Lock-free: Unlimited drivers need a single
+// atomic add, limited ones a CAS loop, so concurrent opens never exceed open_max.
+int drv_open_acquire(driver_t* drv) {
+    if ((drv == NULL) || (drv->ctx == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Every open holds a reference. Deregistered drivers can't be opened anymore.
+    if (drv_ref_get(drv) != 0) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    driver_ctx_t* ctx = drv->ctx;
+    if (ctx->open_max == 0) {
+        atomic_fetch_add_explicit(&ctx->open_cntr, 1, memory_order_acquire);
+        return 0;
+    }
+
+    size_t cntr = atomic_load_explicit(&ctx->open_cntr, memory_order_relaxed);
+    do {
+        if (cntr >= ctx->open_max) {
+            drv_ref_put(drv);
+            errno = EBUSY;
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ctx->open_cntr, &cntr, cntr + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+    return 0;
+}
+
+// Counts a close of a driver. Fails, if the driver is not open. Never drops below 0.
+// The driver may be released by this call (see driver_fops_t::release).
+int drv_open_release(driver_t* drv) {
+    if ((drv == NULL) || (drv->ctx == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    driver_ctx_t* ctx = drv->ctx;
+    size_t cntr = atomic_load_explicit(&ctx->open_cntr, memory_order_relaxed);
+    do {
+        if (cntr == 0) {
+            errno = EBADF;
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ctx->open_cntr, &cntr, cntr - 1,
+                                                    memory_order_release, memory_order_relaxed));
+
+    // The last close of a deregistered driver releases it.
+    drv_ref_put(drv);
+    return 0;
 }
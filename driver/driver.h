@@ -2,12 +2,78 @@
 #define _DRIVER_H_
 #include <driver_types.h>
 
+#define DRV_PATH_MAX    (128U)      /// Max. length of a path for drv_open_path() incl. '\0'.
+#define DRV_IOV_MAX     (1024)      /// Max. number of segments for drv_readv()/drv_writev() (as IOV_MAX).
+
 int drv_register(const driver_t* const base_driver, const char* const name, const driver_t* const driver);
 int drv_deregister(const driver_t* const base_driver, const driver_t* const driver);
+int drv_register_many(const driver_t* const base_driver, const char* const names[], const driver_t* const drivers[], size_t count, int* errors);
+int drv_deregister_many(const driver_t* const base_driver, const driver_t* const drivers[], size_t count, int* errors);
+// Replaces a registered driver under its registered name in one step: Opens find either driver, never none.
+// The old driver is only detached, not released as by drv_deregister(). Its opens stay valid and it can be
+// registered again, e.g. by drv_replace() with swapped drivers. Needs driver_fops_t::replace_drv of the base driver.
+int drv_replace(const driver_t* const base_driver, const driver_t* const old_driver, const driver_t* const new_driver);
 driver_t* drv_open(const driver_t* const base_driver, const char* const name);
+driver_t* drv_open_path(const driver_t* const base_driver, const char* const path);
 int drv_close(driver_t* drv);
 ssize_t drv_read(driver_t* drv, void* buffer, size_t buffer_len);
 ssize_t drv_write(driver_t* drv, const void* buffer, size_t buffer_len);
 int drv_ioctl(driver_t*, size_t id, void* param);
+ssize_t drv_readv(driver_t* drv, const struct iovec* iov, int iovcnt);
+ssize_t drv_writev(driver_t* drv, const struct iovec* iov, int iovcnt);
+int drv_ioctl_batch(driver_t* drv, const drv_ioctl_req_t* reqs, size_t count, int* results, int flags);
+
+// Buffer lending: Access the buffers of a driver without copy. A lent buffer keeps the driver alive until it
+// is returned. A result of 0 lends nothing. Drivers without lending fops get a copy (read data is consumed at once).
+ssize_t drv_acquire_read_buf(driver_t* drv, const void** buffer, size_t count);
+int drv_release_read_buf(driver_t* drv, const void* buffer, size_t count);
+ssize_t drv_acquire_write_buf(driver_t* drv, void** buffer, size_t count);
+ssize_t drv_commit_write_buf(driver_t* drv, void* buffer, size_t count);
+
+// Per-open handles: Integer descriptors with per-handle state (see drv_file.h).
+int drv_fopen(const driver_t* const base_driver, const char* const name, int flags);
+int drv_fclose(int fd);
+drv_file_t* drv_file(int fd);
+ssize_t drv_fread(int fd, void* buffer, size_t buffer_len);
+ssize_t drv_fwrite(int fd, const void* buffer, size_t buffer_len);
+int drv_fioctl(int fd, size_t id, void* param);
+
+// Bound handles: Checks once in drv_bind(), then one indirect call per operation. Missing fops fail with ENOTSUP.
+// A bound handle keeps the driver alive. Calls reach the driver until drv_unbind(), even after deregistration.
+int drv_bind(driver_t* drv, drv_bound_t* bound);
+int drv_unbind(drv_bound_t* bound);
+
+static inline ssize_t drv_bound_read(const drv_bound_t* bound, void* buffer, size_t buffer_len) {
+    return bound->read(bound->driver, buffer, buffer_len);
+}
+
+static inline ssize_t drv_bound_write(const drv_bound_t* bound, const void* buffer, size_t buffer_len) {
+    return bound->write(bound->driver, buffer, buffer_len);
+}
+
+static inline int drv_bound_ioctl(const drv_bound_t* bound, size_t id, void* param) {
+    return bound->ioctl(bound->driver, id, param);
+}
+
+// Readiness: drv_poll() sleeps until one of the drivers is ready (see driver_fops_t::poll) or the timeout [ms]
+// expires (< 0: none, 0: don't sleep). Drivers call drv_wake() on every change of their readiness.
+// drv_eventfd_open() exports the changes as an eventfd for epoll: Readable after a change, then ask drv_poll().
+int drv_poll(drv_pollfd_t* fds, size_t count, int timeout_ms);
+int drv_wake(driver_t* drv);
+int drv_eventfd_open(driver_t* drv, short events);
+int drv_eventfd_close(driver_t* drv, int fd);
+
+// Deadlines: Absolute CLOCK_MONOTONIC times (see drv_wait_deadline()), NULL waits without limit. A passed deadline
+// tries once. Fail with ETIMEDOUT. Drivers without timed fops are waited for with their poll fop.
+ssize_t drv_read_timed(driver_t* drv, void* buffer, size_t count, const struct timespec* deadline);
+ssize_t drv_write_timed(driver_t* drv, const void* buffer, size_t count, const struct timespec* deadline);
+
+// Open accounting for driver implementations (thread safe).
+int drv_open_acquire(driver_t* drv);
+int drv_open_release(driver_t* drv);
+
+// Wait primitive for driver implementations (e.g. in read_timed): Sleeps until the poll fop reports one of the events.
+// flags O_NONBLOCK: EAGAIN instead of sleeping.
+int drv_wait_ready(driver_t* drv, short events, int flags, const struct timespec* deadline);
 
 #endif //_DRIVER_H_
\ No newline at end of file
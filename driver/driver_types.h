@@ -3,14 +3,32 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <types.h>
 #include <property_types.h>
 
+#define DRV_CACHE_LINE  (64U)       /// Size of a cache line. Hot counters are padded apart by it.
+#define DRV_REF_DEAD    ((size_t)1 << (sizeof(size_t) * 8U - 1U))  /// Flag of driver_ctx_t::refs: Driver is deregistered.
+#define DRV_IOCTL_BATCH_STOP    (1 << 0)    /// Flag of drv_ioctl_batch(): Stop at the first failed request.
+
 typedef struct driver_fops_s driver_fops_t;
 typedef struct driver_ctx_s driver_ctx_t;
 typedef struct driver_s driver_t;
+typedef struct drv_file_s drv_file_t;
+typedef struct drv_sqe_s drv_sqe_t;
+typedef struct drv_cqe_s drv_cqe_t;
+typedef struct drv_ring_s drv_ring_t;
+typedef struct drv_ioctl_req_s drv_ioctl_req_t;
+typedef struct drv_wait_s drv_wait_t;
+typedef struct drv_wait_entry_s drv_wait_entry_t;
+typedef struct drv_waiter_s drv_waiter_t;
+typedef struct drv_pollfd_s drv_pollfd_t;
 
 typedef enum {
     DRV_CORE,
@@ -22,14 +40,37 @@ typedef enum {
     DRV_SPI,
     DRV_QSPI,
     DRV_TEST,
+    DRV_FILTER,
 } driver_type_t;
 
+// Wait queue: Threads and eventfds waiting for a change of a driver, see drv_wait.h. Valid zero initialized.
+struct drv_wait_s {
+    _Atomic bool lock;                              // Spinlock of the list.
+    drv_wait_entry_t* head;                         // Registered waiters.
+};
+
+// Registration of a waiter in a wait queue.
+struct drv_wait_entry_s {
+    drv_waiter_t* waiter;                           // Woken by drv_wait_wake().
+    drv_wait_entry_t* prev;
+    drv_wait_entry_t* next;
+};
+
 struct driver_ctx_s {
     const char* reg_name;                           // Name under which the driver is registered.
     driver_t* parent;                               // Parent of this driver.
     const size_t open_max;                          // Max amount of open operations. Fixed
-    size_t open_cntr;                               // Current number of opens.
     const property_list_t properties;               // Driver properties. Fixed.
+    uint32_t reg_name_hash;                         // Hash of reg_name (see hash_str()). Set by drv_register().
+    uint32_t reg_name_len;                          // Length of reg_name. 0: Not set, hash is invalid.
+    atomic_bool epoch_release;                      // Removed from a concurrent registry: Released after the epoch of its readers.
+    // The counters below are written by every open and operation. The padding keeps them off the cache lines
+    // of the fixed fields and of a neighbouring context, without raising the alignment of driver_ctx_t.
+    char pad_fixed[DRV_CACHE_LINE];
+    _Atomic size_t open_cntr;                       // Current number of opens. See drv_open_acquire().
+    _Atomic size_t refs;                            // Opens and running operations | DRV_REF_DEAD. Released at 0, if dead.
+    drv_wait_t wait;                                // Waiters for a change of the readiness, see drv_poll() and drv_wake().
+    char pad_hot[DRV_CACHE_LINE];
 };
 
 struct driver_fops_s {
@@ -42,6 +83,27 @@ struct driver_fops_s {
     int (*ioctl)(driver_t* driver, size_t id, void* param);
     size_t (*get_properties)(driver_t* driver);
     property_t* (*get_property)(driver_t* driver, size_t id);
+    int (*reg_drv_many)(driver_t* base_driver, const char* const names[], driver_t* const drivers[], size_t count, int* errors);   // Optional
+    int (*dereg_drv_many)(driver_t* base_driver, driver_t* const drivers[], size_t count, int* errors);                           // Optional
+    driver_t* (*lookup)(driver_t* base_driver, const char* name);                                                                 // Optional. Find a registered driver without opening it.
+    int (*open_file)(drv_file_t* file);                                                                                           // Optional. Set up per-handle state after open.
+    int (*close_file)(drv_file_t* file);                                                                                          // Optional. Release per-handle state before close.
+    ssize_t (*read_file)(drv_file_t* file, void* buffer, size_t count);                                                           // Optional. Fallback: read.
+    ssize_t (*write_file)(drv_file_t* file, const void* buffer, size_t count);                                                    // Optional. Fallback: write.
+    int (*ioctl_file)(drv_file_t* file, size_t id, void* param);                                                                  // Optional. Fallback: ioctl.
+    void (*release)(driver_t* driver);                                                                                            // Optional. Called once after deregistration, when the last open and operation has finished.
+    ssize_t (*readv)(driver_t* driver, const struct iovec* iov, int iovcnt);                                                      // Optional. Fallback: read per segment.
+    ssize_t (*writev)(driver_t* driver, const struct iovec* iov, int iovcnt);                                                     // Optional. Fallback: write per segment.
+    int (*submit)(drv_file_t* file, const drv_sqe_t* sqe, drv_ring_t* ring);                                                      // Optional. Start a request, finish it with drv_ring_complete(). Fallback: worker pool.
+    int (*ioctl_batch)(driver_t* driver, const drv_ioctl_req_t* reqs, size_t count, int* results, int flags);                     // Optional. Fallback: ioctl per request.
+    ssize_t (*acquire_read_buf)(driver_t* driver, const void** buffer, size_t count);                                             // Optional, with release_read_buf. Lend received data. Fallback: read into a copy.
+    int (*release_read_buf)(driver_t* driver, const void* buffer, size_t count);                                                  // Optional, with acquire_read_buf. Return a lent buffer, count bytes consumed.
+    ssize_t (*acquire_write_buf)(driver_t* driver, void** buffer, size_t count);                                                  // Optional, with commit_write_buf. Lend free space to fill. Fallback: copy for write.
+    ssize_t (*commit_write_buf)(driver_t* driver, void* buffer, size_t count);                                                    // Optional, with acquire_write_buf. Return a lent buffer, count bytes filled.
+    short (*poll)(driver_t* driver, short events);                                                                                // Optional. Ready events (POLLIN, POLLOUT, ...), changes signaled by drv_wake(). Fallback: Always ready.
+    ssize_t (*read_timed)(driver_t* driver, void* buffer, size_t count, int flags, const struct timespec* deadline);              // Optional. O_NONBLOCK: EAGAIN, deadline passed: ETIMEDOUT. Fallback: read, after EAGAIN drv_wait_ready().
+    ssize_t (*write_timed)(driver_t* driver, const void* buffer, size_t count, int flags, const struct timespec* deadline);       // Optional. O_NONBLOCK: EAGAIN, deadline passed: ETIMEDOUT. Fallback: write, after EAGAIN drv_wait_ready().
+    int (*replace_drv)(driver_t* base_driver, driver_t* old_driver, driver_t* new_driver);                                        // Optional. Swap a registered driver in one step, see drv_replace(). Fallback: none (ENOTSUP).
 };
 
 struct driver_s {
@@ -52,4 +114,56 @@ struct driver_s {
     void* const user;                               //User data. Pointer fixed, content variable.
 };
 
+// Per-open state of a driver, see drv_fopen().
+struct drv_file_s {
+    driver_t* driver;                               // Opened driver.
+    int flags;                                      // Flags of drv_fopen(). O_NONBLOCK: drv_fread()/drv_fwrite() fail with EAGAIN instead of waiting.
+    off_t offset;                                   // Position. Free for use by the driver.
+    void* priv;                                     // Per-handle data of the driver (e.g. set by open_file).
+};
+
+// Bound handle, see drv_bind(): Operations of a driver resolved once, called without checks.
+typedef struct drv_bound_s {
+    driver_t* driver;                               // Bound driver.
+    ssize_t (*read)(driver_t* driver, void* buffer, size_t count);
+    ssize_t (*write)(driver_t* driver, const void* buffer, size_t count);
+    int (*ioctl)(driver_t* driver, size_t id, void* param);
+} drv_bound_t;
+
+// One request of drv_ioctl_batch().
+struct drv_ioctl_req_s {
+    size_t id;                                      // Id of the ioctl.
+    void* param;                                    // Parameter of the ioctl.
+};
+
+// One driver of drv_poll().
+struct drv_pollfd_s {
+    driver_t* driver;                               // Opened driver. NULL: Ignored, revents = POLLNVAL.
+    short events;                                   // Requested events (POLLIN, POLLOUT, ...).
+    short revents;                                  // Returns the ready events, incl. POLLERR, POLLHUP (deregistered) and POLLNVAL.
+};
+
+// Operations of a submission entry, see drv_submit().
+typedef enum {
+    DRV_OP_NOP,                                     // Completes with 0.
+    DRV_OP_READ,                                    // drv_fread(fd, buffer, len)
+    DRV_OP_WRITE,                                   // drv_fwrite(fd, buffer, len)
+    DRV_OP_IOCTL,                                   // drv_fioctl(fd, len, buffer)
+} drv_op_t;
+
+// Submission entry: One request of a ring, see drv_ring_get_sqe().
+struct drv_sqe_s {
+    drv_op_t op;                                    // Operation.
+    int fd;                                         // Handle of drv_fopen(). Must stay open until completion.
+    void* buffer;                                   // Read/write: Buffer, ioctl: Parameter. Must stay valid until completion.
+    size_t len;                                     // Read/write: Length, ioctl: Id.
+    uint64_t user_data;                             // Passed unchanged to the completion.
+};
+
+// Completion entry: Result of one request, see drv_reap().
+struct drv_cqe_s {
+    uint64_t user_data;                             // From the submission entry.
+    ssize_t result;                                 // >= 0: Result of the operation, < 0: -errno.
+};
+
 #endif // _DRIVER_TYPES_H_
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**
+ * @file    drv_file.c
+ * @brief   Descriptor table for per-open file handles.
+ *
+ * @details
+ * Slots above the high water mark have never been used. Released slots are kept in a
+ * free list, so allocation and release are O(1) and the table needs no initialization.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_file.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_FD_NONE     (UINT32_MAX)                /// End of the free list.
+
+/*
+ * LOCAL Types
+ */
+typedef struct drv_fd_slot_s {
+    drv_file_t file;                                // Handle.
+    _Atomic uint32_t generation;                    // Odd: In use.
+    uint32_t next_free;                             // Next slot of the free list.
+} drv_fd_slot_t;
+
+/*
+ * LOCAL Variables
+ */
+static drv_fd_slot_t drv_fd_table[DRV_FD_MAX];
+static pthread_mutex_t drv_fd_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t drv_fd_high = 0;                    // Slots below have been used at least once.
+static uint32_t drv_fd_free_head = DRV_FD_NONE;
+static size_t drv_fd_used = 0;
+
+/*
+ * LOCAL Functions
+ */
+/**
+ * @brief drv_fd_slot: Get the slot of a descriptor, if the descriptor is current.
+ *
+ * @param (int) fd: Descriptor.
+ *
+ * @return (drv_fd_slot_t*): NULL: Invalid or stale; other: Slot.
+ */
+static drv_fd_slot_t* drv_fd_slot(int fd) {
+    if (fd < 0) {
+        return NULL;
+    }
+    uint32_t index = (uint32_t)fd & ((1U << DRV_FD_INDEX_BITS) - 1U);
+    uint32_t generation = (uint32_t)fd >> DRV_FD_INDEX_BITS;
+    if (index >= DRV_FD_MAX) {
+        return NULL;
+    }
+    drv_fd_slot_t* slot = &drv_fd_table[index];
+    // Acquire: The handle has been written before the generation was published.
+    uint32_t current = atomic_load_explicit(&slot->generation, memory_order_acquire);
+    if (((current & 1U) == 0) || ((current & DRV_FD_GEN_MASK) != generation)) {
+        return NULL;
+    }
+    return slot;
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_fd_alloc: Allocate a handle for an opened driver.
+ *
+ * @param (driver_t*) driver: Opened driver.
+ * @param (int) flags: Flags of the handle.
+ * @param (drv_file_t**) file: Returns the handle. May be NULL.
+ *
+ * @return (int): >= 0: Descriptor, -1: Failed. For reason see errno-variable.
+ */
+int drv_fd_alloc(driver_t* driver, int flags, drv_file_t** file) {
+    // Parameter check
+    if (driver == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pthread_mutex_lock(&drv_fd_lock);
+    uint32_t index;
+    if (drv_fd_free_head != DRV_FD_NONE) {
+        index = drv_fd_free_head;
+        drv_fd_free_head = drv_fd_table[index].next_free;
+    }
+    else if (drv_fd_high < DRV_FD_MAX) {
+        index = drv_fd_high++;
+    }
+    else {
+        pthread_mutex_unlock(&drv_fd_lock);
+        errno = EMFILE;
+        return -1;
+    }
+
+    drv_fd_slot_t* slot = &drv_fd_table[index];
+    memcpy(&slot->file, &(drv_file_t){ .driver = driver, .flags = flags, .offset = 0, .priv = NULL }, sizeof(drv_file_t));
+    uint32_t generation = atomic_load_explicit(&slot->generation, memory_order_relaxed) + 1U;
+    atomic_store_explicit(&slot->generation, generation, memory_order_release);
+    drv_fd_used++;
+    pthread_mutex_unlock(&drv_fd_lock);
+
+    if (file != NULL) {
+        *file = &slot->file;
+    }
+    return (int)(((generation & DRV_FD_GEN_MASK) << DRV_FD_INDEX_BITS) | index);
+}
+
+/**
+ * @brief drv_fd_free: Release a handle. Afterwards the descriptor is stale.
+ *
+ * @param (int) fd: Descriptor.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_fd_free(int fd) {
+    pthread_mutex_lock(&drv_fd_lock);
+    drv_fd_slot_t* slot = drv_fd_slot(fd);
+    if (slot == NULL) {
+        pthread_mutex_unlock(&drv_fd_lock);
+        errno = EBADF;
+        return -1;
+    }
+
+    atomic_fetch_add_explicit(&slot->generation, 1U, memory_order_release);
+    slot->next_free = drv_fd_free_head;
+    drv_fd_free_head = (uint32_t)(slot - drv_fd_table);
+    drv_fd_used--;
+    pthread_mutex_unlock(&drv_fd_lock);
+    return 0;
+}
+
+/**
+ * @brief drv_fd_get: Resolve a descriptor in O(1).
+ *
+ * @param (int) fd: Descriptor.
+ *
+ * @return (drv_file_t*): NULL: Invalid or stale descriptor (errno = EBADF); other: Handle.
+ */
+drv_file_t* drv_fd_get(int fd) {
+    drv_fd_slot_t* slot = drv_fd_slot(fd);
+    if (slot == NULL) {
+        errno = EBADF;
+        return NULL;
+    }
+    return &slot->file;
+}
+
+/**
+ * @brief drv_fd_count: Get the number of allocated handles.
+ *
+ * @return (size_t): Number of handles in use.
+ */
+size_t drv_fd_count(void) {
+    pthread_mutex_lock(&drv_fd_lock);
+    size_t count = drv_fd_used;
+    pthread_mutex_unlock(&drv_fd_lock);
+    return count;
+}
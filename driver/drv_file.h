@@ -0,0 +1,81 @@
+/**
+ * @file    drv_file.h
+ * @brief   Descriptor table for per-open file handles.
+ *
+ * @details
+ * drv_fopen() allocates a drv_file_t for every open from a statically allocated pool
+ * and returns an integer descriptor. A descriptor carries the slot index and the
+ * generation of the slot:
+ *
+ *   bit 30..16: generation, bit 15..0: index
+ *
+ * The generation of a slot is odd while the slot is in use and incremented on every
+ * allocation and release, so resolving a descriptor is one load and one compare, and
+ * descriptors of closed handles are detected without any scan.
+ * The generation wraps after 16384 reuses of the same slot.
+ *
+ * Allocation and release are serialized by a mutex, resolving is lock-free.
+ * Like POSIX descriptors, a handle must not be closed while another thread uses it.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_FILE_H_
+#define _DRV_FILE_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_FD_MAX          (1024U)     /// Max. number of open handles. At most 1 << DRV_FD_INDEX_BITS.
+#define DRV_FD_INDEX_BITS   (16U)       /// Bits of a descriptor used for the slot index.
+#define DRV_FD_GEN_MASK     (0x7FFFU)   /// Bits of the generation stored in a descriptor (keeps it positive).
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_fd_alloc: Allocate a handle for an opened driver.
+ *
+ * @param (driver_t*) driver: Opened driver.
+ * @param (int) flags: Flags of the handle.
+ * @param (drv_file_t**) file: Returns the handle. May be NULL.
+ *
+ * @return (int): >= 0: Descriptor, -1: Failed. For reason see errno-variable.
+ */
+int drv_fd_alloc(driver_t* driver, int flags, drv_file_t** file);
+
+/**
+ * @brief drv_fd_free: Release a handle. Afterwards the descriptor is stale.
+ *
+ * @param (int) fd: Descriptor.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_fd_free(int fd);
+
+/**
+ * @brief drv_fd_get: Resolve a descriptor in O(1).
+ *
+ * @param (int) fd: Descriptor.
+ *
+ * @return (drv_file_t*): NULL: Invalid or stale descriptor (errno = EBADF); other: Handle.
+ */
+drv_file_t* drv_fd_get(int fd);
+
+/**
+ * @brief drv_fd_count: Get the number of allocated handles.
+ *
+ * @return (size_t): Number of handles in use.
+ */
+size_t drv_fd_count(void);
+
+#endif //_DRV_FILE_H_
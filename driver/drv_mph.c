@@ -0,0 +1,68 @@
+/**
+ * @file    drv_mph.c
+ * @brief   Minimal perfect hash tables for the driver names known at build time.
+ *
+ * @details
+ * Lookup and binding of the tables generated by drv_mph_gen.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_mph.h"
+#include <string.h>
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_mph_bind: Bind the drivers of a static driver list to the slots of their names.
+ * Drivers, whose names are not in the table, are ignored. No heap allocation.
+ *
+ * @param (const drv_mph_table_t*) table: Table.
+ * @param (const drv_static_entry_t*) list: Static drivers of a parent, see drv_static_get().
+ * @param (size_t) count: Number of static drivers.
+ *
+ * @return (size_t): Number of bound drivers.
+ */
+size_t drv_mph_bind(const drv_mph_table_t* table, const drv_static_entry_t* list, size_t count) {
+    if ((table == NULL) || (table->size == 0) || (list == NULL)) {
+        return 0;
+    }
+
+    size_t bound = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t slot = drv_mph_index(table, list[i].driver->name);
+        if (strcmp(table->keys[slot], list[i].driver->name) == 0) {
+            table->slots[slot] = (driver_t*)list[i].driver;
+            bound++;
+        }
+    }
+    return bound;
+}
+
+/**
+ * @brief drv_mph_find: Search a driver by its name.
+ *
+ * @param (const drv_mph_table_t*) table: Table. May be NULL.
+ * @param (const char* const) name: Name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found or not bound; other: handle to the requested driver.
+ */
+driver_t* drv_mph_find(const drv_mph_table_t* table, const char* const name) {
+    if ((table == NULL) || (table->size == 0)) {
+        return NULL;
+    }
+
+    uint32_t slot = drv_mph_index(table, name);
+    driver_t* driver = table->slots[slot];
+    if ((driver == NULL) || (strcmp(table->keys[slot], name) != 0)) {
+        return NULL;
+    }
+    return driver;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file    drv_mph.h
+ * @brief   Minimal perfect hash tables for the driver names known at build time.
+ *
+ * @details
+ * The tables are generated at build time by the tool drv_mph_gen (see tools/) from a
+ * list of driver names. CMake: drv_mph_generate(<target> <symbol> <names-file>).
+ * Every name of the list is mapped to its own slot (hash and displace), so a lookup
+ * needs two hashes, one table access and one strcmp(). No heap allocation.
+ *
+ * The slots are bound to the drivers of the static driver table (see drv_static.h)
+ * by drv_mph_bind(). Names without a bound driver are not found and the registry
+ * falls back to its other lookups.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_MPH_H_
+#define _DRV_MPH_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <driver_types.h>
+#include <hash.h>
+#include <drv_static.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_MPH_DISP_MUL    (0x9e3779b9UL)  /// Multiplier to spread the displacement over all bits.
+
+/*
+ * Types
+ */
+typedef struct drv_mph_table_s {
+    uint32_t size;                          // Number of names (and slots).
+    uint32_t buckets;                       // Number of displacement buckets.
+    uint32_t seed;                          // Seed of the name hash.
+    const uint16_t* disp;                   // Displacement per bucket.
+    const char* const* keys;                // Name per slot.
+    driver_t** slots;                       // Driver per slot. Set by drv_mph_bind().
+} drv_mph_table_t;
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_mph_reduce: Map a hash to the range [0, range) without division.
+ *
+ * @param (uint32_t) hash: Hash value.
+ * @param (uint32_t) range: Size of the range.
+ *
+ * @return (uint32_t): Value in the range.
+ */
+static inline uint32_t drv_mph_reduce(uint32_t hash, uint32_t range) {
+    return (uint32_t)(((uint64_t)hash * range) >> 32);
+}
+
+/**
+ * @brief drv_mph_slot: Calculate the slot of a name hash for a given displacement.
+ * Shared by the generator and the lookup.
+ *
+ * @param (uint32_t) hash: Hash of the name (hash_str_seed() with the seed of the table).
+ * @param (uint16_t) disp: Displacement of the bucket of the name.
+ * @param (uint32_t) size: Number of slots.
+ *
+ * @return (uint32_t): Slot of the name.
+ */
+static inline uint32_t drv_mph_slot(uint32_t hash, uint16_t disp, uint32_t size) {
+    return drv_mph_reduce(hash_mix(hash ^ (disp * DRV_MPH_DISP_MUL)), size);
+}
+
+/**
+ * @brief drv_mph_index: Get the slot of a name. Names, which are not in the table, get an arbitrary slot.
+ *
+ * @param (const drv_mph_table_t*) table: Table. Must contain at least one name.
+ * @param (const char* const) name: Name of the driver.
+ *
+ * @return (uint32_t): Slot of the name.
+ */
+static inline uint32_t drv_mph_index(const drv_mph_table_t* table, const char* const name) {
+    uint32_t hash = hash_str_seed(name, table->seed);
+    return drv_mph_slot(hash, table->disp[drv_mph_reduce(hash, table->buckets)], table->size);
+}
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_mph_bind: Bind the drivers of a static driver list to the slots of their names.
+ * Drivers, whose names are not in the table, are ignored. No heap allocation.
+ *
+ * @param (const drv_mph_table_t*) table: Table.
+ * @param (const drv_static_entry_t*) list: Static drivers of a parent, see drv_static_get().
+ * @param (size_t) count: Number of static drivers.
+ *
+ * @return (size_t): Number of bound drivers.
+ */
+size_t drv_mph_bind(const drv_mph_table_t* table, const drv_static_entry_t* list, size_t count);
+
+/**
+ * @brief drv_mph_find: Search a driver by its name.
+ *
+ * @param (const drv_mph_table_t*) table: Table. May be NULL.
+ * @param (const char* const) name: Name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found or not bound; other: handle to the requested driver.
+ */
+driver_t* drv_mph_find(const drv_mph_table_t* table, const char* const name);
+
+#endif //_DRV_MPH_H_
@@ -0,0 +1,399 @@
+/**
+ * @file    drv_ring.c
+ * @brief   Asynchronous driver I/O with submission and completion rings.
+ *
+ * @details
+ * Every submitted request gets a job of the ring, which holds a copy of the submission
+ * entry until the request is completed. A ring has one job per CQ entry in a free list:
+ * At most CQ entries requests are submitted and not reaped, so drv_submit() always finds
+ * enough free jobs and no allocation is needed.
+ * The worker pool is started on the first drv_submit() and keeps running until the
+ * process ends. If no worker could be started, requests are executed by drv_submit().
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_ring.h"
+#include <driver.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+
+/*
+ * LOCAL Types
+ */
+typedef struct drv_ring_job_s {
+    drv_sqe_t sqe;                                  // Copy of the submission entry.
+    drv_ring_t* ring;                               // Ring of the request.
+    struct drv_ring_job_s* next;                    // Queue of the worker pool or free list.
+} drv_ring_job_t;
+
+struct drv_ring_s {
+    drv_sqe_t* sq;                                  // Submission queue.
+    unsigned sq_mask;                               // SQ entries - 1.
+    unsigned sq_head;                               // Next entry to submit.
+    unsigned sq_tail;                               // Next free entry.
+    drv_ring_job_t* jobs;                           // One job per CQ entry.
+    drv_ring_job_t* free_jobs;                      // Free list of jobs. Guarded by lock.
+    unsigned pending;                               // Submitted and not reaped.
+    drv_cqe_t* cq;                                  // Completion queue. Guarded by lock.
+    unsigned cq_mask;                               // CQ entries - 1.
+    unsigned cq_head;                               // Next completion to reap.
+    unsigned cq_tail;                               // Next free completion.
+    pthread_mutex_t lock;
+    pthread_cond_t cond;                            // Signaled on every completion.
+};
+
+/*
+ * LOCAL Variables
+ */
+static pthread_once_t drv_ring_pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t drv_ring_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t drv_ring_pool_cond = PTHREAD_COND_INITIALIZER;
+static drv_ring_job_t* drv_ring_pool_head = NULL;   // Queue of jobs for the workers.
+static drv_ring_job_t* drv_ring_pool_tail = NULL;
+static unsigned drv_ring_pool_workers = 0;          // Number of started workers.
+
+/*
+ * LOCAL Functions
+ */
+/**
+ * @brief drv_ring_execute: Execute a request with the synchronous calls and complete it.
+ *
+ * @param (drv_ring_job_t*) job: Job of the request. May be reused after the completion.
+ */
+static void drv_ring_execute(drv_ring_job_t* job) {
+    ssize_t result;
+    switch (job->sqe.op) {
+        case DRV_OP_READ:
+            result = drv_fread(job->sqe.fd, job->sqe.buffer, job->sqe.len);
+            break;
+        case DRV_OP_WRITE:
+            result = drv_fwrite(job->sqe.fd, job->sqe.buffer, job->sqe.len);
+            break;
+        case DRV_OP_IOCTL:
+            result = drv_fioctl(job->sqe.fd, job->sqe.len, job->sqe.buffer);
+            break;
+        default:
+            errno = EINVAL;
+            result = -1;
+            break;
+    }
+    drv_ring_complete(job->ring, &job->sqe, (result < 0) ? -errno : result);
+}
+
+// Thread of the worker pool: Executes jobs until the process ends.
+static void* drv_ring_worker(void* arg) {
+    for (;;) {
+        pthread_mutex_lock(&drv_ring_pool_lock);
+        while (drv_ring_pool_head == NULL) {
+            pthread_cond_wait(&drv_ring_pool_cond, &drv_ring_pool_lock);
+        }
+        drv_ring_job_t* job = drv_ring_pool_head;
+        drv_ring_pool_head = job->next;
+        if (drv_ring_pool_head == NULL) {
+            drv_ring_pool_tail = NULL;
+        }
+        pthread_mutex_unlock(&drv_ring_pool_lock);
+
+        drv_ring_execute(job);
+    }
+    return NULL;
+}
+
+// Starts the worker pool (once).
+static void drv_ring_pool_start(void) {
+    for (unsigned i = 0; i < DRV_RING_WORKERS; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, drv_ring_worker, NULL) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        drv_ring_pool_workers++;
+    }
+}
+
+/**
+ * @brief drv_ring_start: Start a request: Driver with submit fop or queue for the worker pool.
+ *
+ * @param (drv_ring_job_t*) job: Job of the request.
+ *
+ * @return (int): 1: Job has to be executed by the worker pool, 0: Started or already completed.
+ */
+static int drv_ring_start(drv_ring_job_t* job) {
+    drv_ring_t* ring = job->ring;
+    if (job->sqe.op == DRV_OP_NOP) {
+        drv_ring_complete(ring, &job->sqe, 0);
+        return 0;
+    }
+    if ((job->sqe.op != DRV_OP_READ) && (job->sqe.op != DRV_OP_WRITE) && (job->sqe.op != DRV_OP_IOCTL)) {
+        drv_ring_complete(ring, &job->sqe, -EINVAL);
+        return 0;
+    }
+
+    drv_file_t* file = drv_file(job->sqe.fd);
+    if (file == NULL) {
+        drv_ring_complete(ring, &job->sqe, -errno);
+        return 0;
+    }
+
+    driver_t* driver = file->driver;
+    if ((driver->fops != NULL) && (driver->fops->submit != NULL)) {
+        // The driver completes the request itself. The entry stays valid until it is completed.
+        if (driver->fops->submit(file, &job->sqe, ring) != 0) {
+            drv_ring_complete(ring, &job->sqe, -errno);
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_ring_create: Create a ring.
+ *
+ * @param (unsigned) entries: Number of SQ entries. Power of two, 1 .. DRV_RING_MAX. The CQ gets twice as many.
+ *
+ * @return (drv_ring_t*): NULL: Failed. For reason see errno-variable; other: Ring.
+ */
+drv_ring_t* drv_ring_create(unsigned entries) {
+    // Parameter check
+    if ((entries == 0) || (entries > DRV_RING_MAX) || ((entries & (entries - 1U)) != 0)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    drv_ring_t* ring = calloc(1, sizeof(drv_ring_t));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->sq = calloc(entries, sizeof(drv_sqe_t));
+    ring->cq = calloc(2U * entries, sizeof(drv_cqe_t));
+    ring->jobs = calloc(2U * entries, sizeof(drv_ring_job_t));
+    if ((ring->sq == NULL) || (ring->cq == NULL) || (ring->jobs == NULL)) {
+        free(ring->sq);
+        free(ring->cq);
+        free(ring->jobs);
+        free(ring);
+        errno = ENOMEM;
+        return NULL;
+    }
+    ring->sq_mask = entries - 1U;
+    ring->cq_mask = 2U * entries - 1U;
+    for (unsigned i = 0; i <= ring->cq_mask; i++) {
+        ring->jobs[i].next = ring->free_jobs;
+        ring->free_jobs = &ring->jobs[i];
+    }
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->cond, NULL);
+    return ring;
+}
+
+/**
+ * @brief drv_ring_destroy: Wait for all submitted requests and free the ring.
+ * Unsubmitted SQ entries and unreaped completions are dropped.
+ *
+ * @param (drv_ring_t*) ring: Ring. May be NULL.
+ */
+void drv_ring_destroy(drv_ring_t* ring) {
+    if (ring == NULL) {
+        return;
+    }
+
+    // Requests in flight still reference the ring.
+    pthread_mutex_lock(&ring->lock);
+    while (ring->pending != ring->cq_tail - ring->cq_head) {
+        pthread_cond_wait(&ring->cond, &ring->lock);
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->sq);
+    free(ring->cq);
+    free(ring->jobs);
+    free(ring);
+}
+
+/**
+ * @brief drv_ring_get_sqe: Get the next free submission entry.
+ * The entry is queued, but not submitted until drv_submit().
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ *
+ * @return (drv_sqe_t*): NULL: SQ is full (errno = EBUSY) or ring invalid (errno = EINVAL); other: Entry to fill.
+ */
+drv_sqe_t* drv_ring_get_sqe(drv_ring_t* ring) {
+    // Parameter check
+    if (ring == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (ring->sq_tail - ring->sq_head > ring->sq_mask) {
+        errno = EBUSY;
+        return NULL;
+    }
+    drv_sqe_t* sqe = &ring->sq[ring->sq_tail++ & ring->sq_mask];
+    *sqe = (drv_sqe_t){ .op = DRV_OP_NOP, .fd = -1 };
+    return sqe;
+}
+
+/**
+ * @brief drv_submit: Submit all queued entries of the SQ.
+ * If the CQ hasn't enough room, the remaining entries stay queued for the next call.
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ *
+ * @return (int): >= 0: Number of submitted entries, -1: Failed. For reason see errno-variable
+ *                (EBUSY: Entries are queued, but the CQ is full. Reap first).
+ */
+int drv_submit(drv_ring_t* ring) {
+    // Parameter check
+    if (ring == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    unsigned queued = ring->sq_tail - ring->sq_head;
+    unsigned room = ring->cq_mask + 1U - ring->pending;
+    unsigned count = (queued < room) ? queued : room;
+    if ((count == 0) && (queued > 0)) {
+        errno = EBUSY;
+        return -1;
+    }
+
+    // Take the jobs with one lock. There are at least as many free jobs as room in the CQ.
+    pthread_mutex_lock(&ring->lock);
+    drv_ring_job_t* jobs = ring->free_jobs;
+    for (unsigned i = 0; i < count; i++) {
+        ring->free_jobs = ring->free_jobs->next;
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    // Collect the jobs for the worker pool, then hand them over with one lock.
+    drv_ring_job_t* head = NULL;
+    drv_ring_job_t* tail = NULL;
+    for (unsigned i = 0; i < count; i++) {
+        drv_ring_job_t* job = jobs;
+        jobs = job->next;
+        job->sqe = ring->sq[ring->sq_head++ & ring->sq_mask];
+        job->ring = ring;
+        job->next = NULL;
+        ring->pending++;
+        if (drv_ring_start(job) == 0) {
+            continue;
+        }
+        if (tail == NULL) {
+            head = job;
+        } else {
+            tail->next = job;
+        }
+        tail = job;
+    }
+    if (head == NULL) {
+        return (int)count;
+    }
+
+    pthread_once(&drv_ring_pool_once, drv_ring_pool_start);
+    if (drv_ring_pool_workers == 0) {
+        // No worker: Execute synchronous.
+        while (head != NULL) {
+            drv_ring_job_t* job = head;
+            head = job->next;
+            drv_ring_execute(job);
+        }
+        return (int)count;
+    }
+
+    pthread_mutex_lock(&drv_ring_pool_lock);
+    if (drv_ring_pool_tail == NULL) {
+        drv_ring_pool_head = head;
+    } else {
+        drv_ring_pool_tail->next = head;
+    }
+    drv_ring_pool_tail = tail;
+    pthread_cond_broadcast(&drv_ring_pool_cond);
+    pthread_mutex_unlock(&drv_ring_pool_lock);
+    return (int)count;
+}
+
+/**
+ * @brief drv_reap: Collect completions.
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ * @param (drv_cqe_t*) cqes: Returns the completions.
+ * @param (unsigned) count: Size of cqes.
+ * @param (unsigned) wait_min: Block until at least this number of completions is available.
+ *                             Limited to count and the number of submitted requests.
+ *
+ * @return (int): >= 0: Number of completions in cqes, -1: Failed. For reason see errno-variable.
+ */
+int drv_reap(drv_ring_t* ring, drv_cqe_t* cqes, unsigned count, unsigned wait_min) {
+    // Parameter check
+    if ((ring == NULL) || ((cqes == NULL) && (count > 0))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (wait_min > count) {
+        wait_min = count;
+    }
+    if (wait_min > ring->pending) {
+        wait_min = ring->pending;                   // Would never be completed.
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    while (ring->cq_tail - ring->cq_head < wait_min) {
+        pthread_cond_wait(&ring->cond, &ring->lock);
+    }
+    unsigned available = ring->cq_tail - ring->cq_head;
+    unsigned reaped = (available < count) ? available : count;
+    for (unsigned i = 0; i < reaped; i++) {
+        cqes[i] = ring->cq[ring->cq_head++ & ring->cq_mask];
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    ring->pending -= reaped;
+    return (int)reaped;
+}
+
+/**
+ * @brief drv_ring_complete: Finish a request started by a submit fop. Thread safe.
+ * Afterwards the submission entry must not be used anymore.
+ *
+ * @param (drv_ring_t*) ring: Ring passed to the submit fop.
+ * @param (const drv_sqe_t*) sqe: Submission entry passed to the submit fop.
+ * @param (ssize_t) result: >= 0: Result, < 0: -errno.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_ring_complete(drv_ring_t* ring, const drv_sqe_t* sqe, ssize_t result) {
+    // Parameter check: The entry must be one of the jobs of the ring.
+    if ((ring == NULL) || (sqe == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+    drv_ring_job_t* job = (drv_ring_job_t*)sqe;     // sqe is the first member of the job.
+    if ((job < ring->jobs) || (job > &ring->jobs[ring->cq_mask]) || (&job->sqe != sqe)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // No overflow check: drv_submit() submits only as many requests as the CQ has room for.
+    pthread_mutex_lock(&ring->lock);
+    ring->cq[ring->cq_tail++ & ring->cq_mask] = (drv_cqe_t){ .user_data = sqe->user_data, .result = result };
+    job->next = ring->free_jobs;
+    ring->free_jobs = job;
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->lock);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file    drv_ring.h
+ * @brief   Asynchronous driver I/O with submission and completion rings.
+ *
+ * @details
+ * A ring has a submission queue (SQ) and a completion queue (CQ) with twice as many
+ * entries. The caller fills entries of the SQ (drv_ring_get_sqe()), hands all of them
+ * over with one call of drv_submit() and collects the results from the CQ
+ * (drv_reap()):
+ *
+ *   drv_sqe_t* sqe = drv_ring_get_sqe(ring);
+ *   *sqe = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .buffer = buf, .len = 16, .user_data = 1 };
+ *   drv_submit(ring);
+ *   drv_reap(ring, cqes, 8, 1);
+ *
+ * Drivers with a submit fop start the request themselves and finish it later with
+ * drv_ring_complete(). Requests of all other drivers are executed by a shared pool of
+ * DRV_RING_WORKERS threads with the synchronous drv_fread()/drv_fwrite()/drv_fioctl(),
+ * so a slow driver blocks a worker instead of the submitting thread.
+ *
+ * Requests complete in any order. drv_submit() hands over only as many requests as the
+ * CQ has room for (submitted and not yet reaped), so the CQ never overflows.
+ * Like io_uring, a ring is used by one thread: drv_ring_get_sqe(), drv_submit(),
+ * drv_reap() and drv_ring_destroy() must not be called concurrently on the same ring.
+ * drv_ring_complete() may be called from any thread.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_RING_H_
+#define _DRV_RING_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_RING_MAX        (4096U)     /// Max. number of SQ entries of a ring.
+#define DRV_RING_WORKERS    (4U)        /// Threads of the worker pool for drivers without submit fop.
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_ring_create: Create a ring.
+ *
+ * @param (unsigned) entries: Number of SQ entries. Power of two, 1 .. DRV_RING_MAX. The CQ gets twice as many.
+ *
+ * @return (drv_ring_t*): NULL: Failed. For reason see errno-variable; other: Ring.
+ */
+drv_ring_t* drv_ring_create(unsigned entries);
+
+/**
+ * @brief drv_ring_destroy: Wait for all submitted requests and free the ring.
+ * Unsubmitted SQ entries and unreaped completions are dropped.
+ *
+ * @param (drv_ring_t*) ring: Ring. May be NULL.
+ */
+void drv_ring_destroy(drv_ring_t* ring);
+
+/**
+ * @brief drv_ring_get_sqe: Get the next free submission entry.
+ * The entry is queued, but not submitted until drv_submit().
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ *
+ * @return (drv_sqe_t*): NULL: SQ is full (errno = EBUSY) or ring invalid (errno = EINVAL); other: Entry to fill.
+ */
+drv_sqe_t* drv_ring_get_sqe(drv_ring_t* ring);
+
+/**
+ * @brief drv_submit: Submit all queued entries of the SQ.
+ * If the CQ hasn't enough room, the remaining entries stay queued for the next call.
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ *
+ * @return (int): >= 0: Number of submitted entries, -1: Failed. For reason see errno-variable
+ *                (EBUSY: Entries are queued, but the CQ is full. Reap first).
+ */
+int drv_submit(drv_ring_t* ring);
+
+/**
+ * @brief drv_reap: Collect completions.
+ *
+ * @param (drv_ring_t*) ring: Ring.
+ * @param (drv_cqe_t*) cqes: Returns the completions.
+ * @param (unsigned) count: Size of cqes.
+ * @param (unsigned) wait_min: Block until at least this number of completions is available.
+ *                             Limited to count and the number of submitted requests.
+ *
+ * @return (int): >= 0: Number of completions in cqes, -1: Failed. For reason see errno-variable.
+ */
+int drv_reap(drv_ring_t* ring, drv_cqe_t* cqes, unsigned count, unsigned wait_min);
+
+/**
+ * @brief drv_ring_complete: Finish a request started by a submit fop. Thread safe.
+ * Afterwards the submission entry must not be used anymore.
+ *
+ * @param (drv_ring_t*) ring: Ring passed to the submit fop.
+ * @param (const drv_sqe_t*) sqe: Submission entry passed to the submit fop.
+ * @param (ssize_t) result: >= 0: Result, < 0: -errno.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_ring_complete(drv_ring_t* ring, const drv_sqe_t* sqe, ssize_t result);
+
+#endif //_DRV_RING_H_
@@ -0,0 +1,288 @@
+/**
+ * @file    drv_static.c
+ * @brief   Link-time static driver table.
+ *
+ * @details
+ * Drivers, which are known at build time, can be registered with DRV_STATIC_REGISTER().
+ * The entries are placed in the dedicated linker section "drv_static" and picked up
+ * by the registry of the parent driver without any heap allocation.
+ * On the first use, the table is sorted in place by parent and driver name,
+ * so the drivers of a parent can be found by binary search. Registered names are found
+ * by a hash table, which is chained through the entries of the parent themselves
+ * (drv_static_entry_t::reg_head, reg_next). Duplicates are detected while it is built
+ * and sorted behind all other entries.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_static.h"
+#include "hash.h"
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+/*
+ * LOCAL Prototypes
+ */
+static int drv_static_compare(const drv_static_entry_t* a, const drv_static_entry_t* b);
+static void drv_static_sift_down(drv_static_entry_t* list, size_t root, size_t count);
+static void drv_static_sort(drv_static_entry_t* list, size_t count);
+static size_t drv_static_reject(drv_static_entry_t* entry);
+static size_t drv_static_index(drv_static_entry_t* list, size_t count);
+static size_t drv_static_lower_bound(const drv_static_entry_t* list, size_t count, const char* const name);
+static void drv_static_setup(void);
+
+/*
+ * LOCAL Variables
+ */
+// Begin and end of the linker section. Weak, so linking works without any static driver.
+extern drv_static_entry_t __start_drv_static[] __attribute__((weak));
+extern drv_static_entry_t __stop_drv_static[] __attribute__((weak));
+
+static pthread_once_t drv_static_once = PTHREAD_ONCE_INIT;
+static size_t drv_static_count = 0;                 // Number of valid entries, at the begin of the table.
+static int drv_static_error = 0;                    // EEXIST: Duplicates have been rejected.
+
+/*
+ * LOCAL Functions
+ */
+// Order: Valid entries first, then parent driver, then name of the driver (same driver twice: neighbours).
+static int drv_static_compare(const drv_static_entry_t* a, const drv_static_entry_t* b) {
+    if (a->rejected != b->rejected) {
+        return a->rejected ? 1 : -1;
+    }
+    if (*a->parent != *b->parent) {
+        return (*a->parent < *b->parent) ? -1 : 1;
+    }
+    int cmp = strcmp(a->driver->name, b->driver->name);
+    if ((cmp == 0) && (a->driver != b->driver)) {
+        return (a->driver < b->driver) ? -1 : 1;
+    }
+    return cmp;
+}
+
+static void drv_static_sift_down(drv_static_entry_t* list, size_t root, size_t count) {
+    for (size_t child = 2 * root + 1; child < count; root = child, child = 2 * root + 1) {
+        if ((child + 1 < count) && (drv_static_compare(&list[child], &list[child + 1]) < 0)) {
+            child++;
+        }
+        if (drv_static_compare(&list[root], &list[child]) >= 0) {
+            return;
+        }
+        drv_static_entry_t tmp = list[root];
+        list[root] = list[child];
+        list[child] = tmp;
+    }
+}
+
+// Heapsort: In place and without heap allocation (qsort() may allocate).
+static void drv_static_sort(drv_static_entry_t* list, size_t count) {
+    for (size_t i = count / 2; i > 0; i--) {
+        drv_static_sift_down(list, i - 1, count);
+    }
+    for (size_t i = count; i > 1; i--) {
+        drv_static_entry_t tmp = list[0];
+        list[0] = list[i - 1];
+        list[i - 1] = tmp;
+        drv_static_sift_down(list, 0, i - 1);
+    }
+}
+
+// Marks an entry as rejected. Returns 1, if it wasn't before.
+static size_t drv_static_reject(drv_static_entry_t* entry) {
+    size_t result = entry->rejected ? 0 : 1;
+    entry->rejected = true;
+    return result;
+}
+
+// Builds the hash tables of the registered names of every parent and marks duplicates as rejected.
+// Returns the number of rejected entries.
+static size_t drv_static_index(drv_static_entry_t* list, size_t count) {
+    size_t rejected = 0;
+    for (size_t begin = 0, end; begin < count; begin = end) {
+        for (end = begin + 1; (end < count) && (*list[end].parent == *list[begin].parent); end++);
+
+        // One bucket per entry of the parent, the heads are stored in the entries too.
+        drv_static_entry_t* slice = &list[begin];
+        size_t n = end - begin;
+        for (size_t i = 0; i < n; i++) {
+            slice[i].reg_head = 0;
+        }
+        for (size_t i = 0; i < n; i++) {
+            slice[i].reg_hash = hash_str(slice[i].name);
+            drv_static_entry_t* bucket = &slice[slice[i].reg_hash % n];
+            for (uint32_t j = bucket->reg_head; j != 0; j = slice[j - 1].reg_next) {
+                if ((slice[j - 1].reg_hash == slice[i].reg_hash) && (strcmp(slice[j - 1].name, slice[i].name) == 0)) {
+                    rejected += drv_static_reject(&slice[j - 1]) + drv_static_reject(&slice[i]);
+                }
+            }
+            slice[i].reg_next = bucket->reg_head;
+            bucket->reg_head = (uint32_t)(i + 1);
+
+            // The same driver twice is a neighbour by name.
+            if ((i > 0) && (slice[i - 1].driver == slice[i].driver)) {
+                rejected += drv_static_reject(&slice[i - 1]) + drv_static_reject(&slice[i]);
+            }
+        }
+    }
+    return rejected;
+}
+
+// Binary search for the first entry with a driver name >= name.
+static size_t drv_static_lower_bound(const drv_static_entry_t* list, size_t count, const char* const name) {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (strcmp(list[mid].driver->name, name) < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Sorts the table once, see drv_static_init().
+static void drv_static_setup(void) {
+    size_t count = (size_t)(__stop_drv_static - __start_drv_static);
+    drv_static_sort(__start_drv_static, count);
+
+    // Rejected entries are moved behind all others and are never found.
+    size_t rejected = drv_static_index(__start_drv_static, count);
+    if (rejected != 0) {
+        drv_static_sort(__start_drv_static, count);
+        (void)drv_static_index(__start_drv_static, count - rejected);
+        drv_static_error = EEXIST;
+    }
+    drv_static_count = count - rejected;
+
+    for (size_t i = 0; i < drv_static_count; i++) {
+        driver_ctx_t* ctx = __start_drv_static[i].driver->ctx;
+        if (ctx != NULL) {
+            ctx->parent = (driver_t*)*__start_drv_static[i].parent;
+            ctx->reg_name = __start_drv_static[i].name;
+            ctx->reg_name_hash = __start_drv_static[i].reg_hash;
+            ctx->reg_name_len = (uint32_t)strlen(ctx->reg_name);
+        }
+    }
+}
+
+/*
+ * Global Functions
+ */
+/**
+ * @brief drv_static_init: Sort the static driver table and set parent and registered name of the drivers.
+ * Called automaticly by the first lookup. Further calls only repeat the result. No heap allocation. Thread safe.
+ *
+ * @return (int): 0: Success, -1: Duplicates have been rejected (EEXIST). For reason see errno-variable.
+ */
+int drv_static_init(void) {
+    (void)pthread_once(&drv_static_once, drv_static_setup);
+    if (drv_static_error != 0) {
+        errno = drv_static_error;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief drv_static_get: Get the static drivers of a parent driver.
+ *
+ * @param (const driver_t* const) parent: Parent driver.
+ * @param (const drv_static_entry_t**) list: Returns the first entry of the parent. Entries are sorted by driver name.
+ *
+ * @return (size_t): Number of static drivers of the parent.
+ */
+size_t drv_static_get(const driver_t* const parent, const drv_static_entry_t** list) {
+    (void)drv_static_init();
+
+    // Binary search for the first entry of the parent. Rejected entries are behind count.
+    size_t count = drv_static_count;
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (*__start_drv_static[mid].parent < parent) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    size_t end = low;
+    while ((end < count) && (*__start_drv_static[end].parent == parent)) {
+        end++;
+    }
+
+    *list = (end > low) ? &__start_drv_static[low] : NULL;
+    return end - low;
+}
+
+/**
+ * @brief drv_static_find_by_name: Search a driver by its name in a list of static drivers (binary search).
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const char* const) name: Name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
+ */
+driver_t* drv_static_find_by_name(const drv_static_entry_t* list, size_t count, const char* const name) {
+    size_t index = drv_static_lower_bound(list, count, name);
+    if ((index < count) && (strcmp(list[index].driver->name, name) == 0)) {
+        return (driver_t*)list[index].driver;
+    }
+    return NULL;
+}
+
+/**
+ * @brief drv_static_find_by_reg_name: Search a driver by its registered name in a list of static drivers (hash table).
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const char* const) reg_name: Registered name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
+ */
+driver_t* drv_static_find_by_reg_name(const drv_static_entry_t* list, size_t count, const char* const reg_name) {
+    if (count == 0) {
+        return NULL;
+    }
+
+    // The list is sorted by driver name, registered names are found by the chained hash table of the parent.
+    uint32_t hash = hash_str(reg_name);
+    for (uint32_t j = list[hash % count].reg_head; j != 0; j = list[j - 1].reg_next) {
+        if ((list[j - 1].reg_hash == hash) && (strcmp(list[j - 1].name, reg_name) == 0)) {
+            return (driver_t*)list[j - 1].driver;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief drv_static_contains: Check, if a driver is in a list of static drivers.
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const driver_t* const) driver: Driver to search for.
+ *
+ * @return (bool): true: Driver is in list.
+ */
+bool drv_static_contains(const drv_static_entry_t* list, size_t count, const driver_t* const driver) {
+    // Several drivers may have the same name, check all of them.
+    for (size_t i = drv_static_lower_bound(list, count, driver->name);
+         (i < count) && (strcmp(list[i].driver->name, driver->name) == 0); i++) {
+        if (list[i].driver == driver) {
+            return true;
+        }
+    }
+    return false;
+}
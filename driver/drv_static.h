@@ -0,0 +1,122 @@
+/**
+ * @file    drv_static.h
+ * @brief   Link-time static driver table.
+ *
+ * @details
+ * Drivers, which are known at build time, can be registered with DRV_STATIC_REGISTER().
+ * The entries are placed in the dedicated linker section "drv_static" and picked up
+ * by the registry of the parent driver without any heap allocation.
+ * Static drivers can not be deregistered. Runtime registration works on top of the static set.
+ * Entries of a parent with the same registered name, or the same driver twice, are rejected:
+ * None of them is bound or found, drv_static_init() reports EEXIST.
+ *
+ * Example:
+ * @code
+ * static driver_t pin7 = { ... };
+ * DRV_STATIC_REGISTER(drv_core, "pin7", &pin7);
+ * @endcode
+ *
+ * @warning
+ * Requires a GNU compatible toolchain (section attribute, __start_/__stop_ symbols of the linker).
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_STATIC_H_
+#define _DRV_STATIC_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <driver_types.h>
+
+/*
+ * Types
+ */
+typedef struct drv_static_entry_s {
+    const driver_t* const* parent;                  // Handle of the parent driver (e.g. &drv_core).
+    const char* name;                               // Name, the driver is registered under.
+    const driver_t* driver;                         // Driver. Must be statically allocated.
+    uint32_t reg_hash;                              // Set by drv_static_init(): Hash of the registered name.
+    uint32_t reg_head;                              // Set by drv_static_init(): First entry (+1) of the hash bucket of this slot. 0: Empty.
+    uint32_t reg_next;                              // Set by drv_static_init(): Next entry (+1) in the same hash bucket. 0: Last.
+    bool rejected;                                  // Set by drv_static_init(): Duplicate, not bound.
+} drv_static_entry_t;
+
+/*
+ * DEFINEs
+ */
+#define DRV_STATIC_CONCAT_(a, b)    a##b
+#define DRV_STATIC_CONCAT(a, b)     DRV_STATIC_CONCAT_(a, b)
+
+/**
+ * @brief DRV_STATIC_REGISTER: Register a driver at link time.
+ *
+ * @param parent_handle: Handle (const driver_t*) of the parent driver, e.g. drv_core.
+ * @param reg_name: Name, the driver is registered under.
+ * @param drv: Address of the statically allocated driver_t.
+ */
+#define DRV_STATIC_REGISTER(parent_handle, reg_name, drv) \
+    static drv_static_entry_t DRV_STATIC_CONCAT(drv_static_entry_, __COUNTER__) \
+    __attribute__((used, section("drv_static"), aligned(sizeof(void*)))) = { .parent = &(parent_handle), .name = (reg_name), .driver = (drv) }
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_static_init: Sort the static driver table and set parent and registered name of the drivers.
+ * Called automaticly by the first lookup. Further calls only repeat the result. No heap allocation. Thread safe.
+ *
+ * @return (int): 0: Success, -1: Duplicates have been rejected (EEXIST). For reason see errno-variable.
+ */
+int drv_static_init(void);
+
+/**
+ * @brief drv_static_get: Get the static drivers of a parent driver.
+ *
+ * @param (const driver_t* const) parent: Parent driver.
+ * @param (const drv_static_entry_t**) list: Returns the first entry of the parent. Entries are sorted by driver name.
+ *
+ * @return (size_t): Number of static drivers of the parent.
+ */
+size_t drv_static_get(const driver_t* const parent, const drv_static_entry_t** list);
+
+/**
+ * @brief drv_static_find_by_name: Search a driver by its name in a list of static drivers (binary search).
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const char* const) name: Name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
+ */
+driver_t* drv_static_find_by_name(const drv_static_entry_t* list, size_t count, const char* const name);
+
+/**
+ * @brief drv_static_find_by_reg_name: Search a driver by its registered name in a list of static drivers (hash table).
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const char* const) reg_name: Registered name of the driver.
+ *
+ * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
+ */
+driver_t* drv_static_find_by_reg_name(const drv_static_entry_t* list, size_t count, const char* const reg_name);
+
+/**
+ * @brief drv_static_contains: Check, if a driver is in a list of static drivers.
+ *
+ * @param (const drv_static_entry_t*) list: Entries of a parent, see drv_static_get().
+ * @param (size_t) count: Number of entries.
+ * @param (const driver_t* const) driver: Driver to search for.
+ *
+ * @return (bool): true: Driver is in list.
+ */
+bool drv_static_contains(const drv_static_entry_t* list, size_t count, const driver_t* const driver);
+
+#endif //_DRV_STATIC_H_
@@ -0,0 +1,439 @@
+/**
+ * @file    drv_stats.c
+ * @brief   Call statistics of the dispatch layer per driver and operation.
+ *
+ * @details
+ * Every thread takes a table on its first counted call: The table of an ended thread, or a
+ * new one, which is linked into a global list. The list only grows. Tables of ended threads
+ * keep their counts, the next owner counts on. Only the owning thread writes a table; the counters are atomics with relaxed
+ * load and store (no read-modify-write), so readers see consistent 64 bit values.
+ * A driver is identified by its address. If a driver is freed and another one is created
+ * at the same address, their statistics are merged.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_stats.h"
+#include <errno.h>
+
+#ifdef DRV_STATS
+#include <hash.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * LOCAL Types
+ */
+typedef struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t errors;
+    _Atomic uint64_t latency_ns;
+    _Atomic int errno_error[DRV_STATS_ERRNOS];
+    _Atomic uint64_t errno_count[DRV_STATS_ERRNOS];
+    _Atomic uint64_t histogram[DRV_STATS_BUCKETS];
+} drv_stats_cell_t;
+
+typedef struct {
+    const driver_t* _Atomic driver;                 // Key. NULL: Free (or overflow entry).
+    char name[DRV_STATS_NAME_LEN];                  // Copy of the name, written before the key.
+    drv_stats_cell_t ops[DRV_STAT_OPS];
+} drv_stats_entry_t;
+
+typedef struct drv_stats_thread_s {
+    drv_stats_entry_t entries[DRV_STATS_DRIVERS];   // Open addressing by hash_ptr().
+    drv_stats_entry_t overflow;                     // Drivers without free entry.
+    atomic_bool in_use;                             // Table belongs to a thread.
+    struct drv_stats_thread_s* next;                // List of all tables.
+} drv_stats_thread_t;
+
+/*
+ * LOCAL Variables
+ */
+static _Thread_local drv_stats_thread_t* drv_stats_self = NULL;
+static drv_stats_thread_t* _Atomic drv_stats_threads = NULL;
+static pthread_once_t drv_stats_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t drv_stats_key;
+static const char* const drv_stats_op_names[DRV_STAT_OPS] = {
+    "open", "close", "read", "write", "ioctl", "register", "deregister",
+};
+
+/*
+ * LOCAL Functions
+ */
+// Adds to a counter of the own table. Only the owner writes, so no read-modify-write is needed.
+static inline void drv_stats_add(_Atomic uint64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static inline uint64_t drv_stats_load(_Atomic uint64_t* counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+// Thread exit: Hand the table over to the next thread. Its counts are kept.
+static void drv_stats_thread_exit(void* table) {
+    atomic_store_explicit(&((drv_stats_thread_t*)table)->in_use, false, memory_order_release);
+}
+
+static void drv_stats_key_create(void) {
+    (void)pthread_key_create(&drv_stats_key, drv_stats_thread_exit);
+}
+
+// Gets the table of the calling thread. On the first call it takes the table of an ended thread,
+// or allocates and links a new one.
+static drv_stats_thread_t* drv_stats_thread(void) {
+    if (drv_stats_self != NULL) {
+        return drv_stats_self;
+    }
+    (void)pthread_once(&drv_stats_key_once, drv_stats_key_create);
+
+    drv_stats_thread_t* self;
+    for (self = atomic_load_explicit(&drv_stats_threads, memory_order_acquire); self != NULL; self = self->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&self->in_use, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (self == NULL) {
+        self = calloc(1, sizeof(drv_stats_thread_t));
+        if (self == NULL) {
+            return NULL;
+        }
+        atomic_init(&self->in_use, true);
+        self->next = atomic_load_explicit(&drv_stats_threads, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&drv_stats_threads, &self->next, self,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    (void)pthread_setspecific(drv_stats_key, self);
+    drv_stats_self = self;
+    return self;
+}
+
+/**
+ * @brief drv_stats_find: Find the entry of a driver in a table.
+ *
+ * @param (drv_stats_thread_t*) thread: Table.
+ * @param (const driver_t*) driver: Driver. NULL: Overflow entry.
+ * @param (int) insert: true: Take a free entry, if the driver has none (owner only).
+ *
+ * @return (drv_stats_entry_t*): NULL: Not found; other: Entry.
+ */
+static drv_stats_entry_t* drv_stats_find(drv_stats_thread_t* thread, const driver_t* driver, int insert) {
+    if (driver == NULL) {
+        return &thread->overflow;
+    }
+    uint32_t index = hash_ptr(driver) & (DRV_STATS_DRIVERS - 1U);
+    for (uint32_t i = 0; i < DRV_STATS_DRIVERS; i++) {
+        drv_stats_entry_t* entry = &thread->entries[(index + i) & (DRV_STATS_DRIVERS - 1U)];
+        const driver_t* key = atomic_load_explicit(&entry->driver, memory_order_acquire);
+        if (key == driver) {
+            return entry;
+        }
+        if (key == NULL) {
+            if (!insert) {
+                return NULL;
+            }
+            if (driver->name != NULL) {
+                strncpy(entry->name, driver->name, DRV_STATS_NAME_LEN - 1U);
+            }
+            atomic_store_explicit(&entry->driver, driver, memory_order_release);
+            return entry;
+        }
+    }
+    return insert ? &thread->overflow : NULL;
+}
+
+// Adds the counters of a cell to the statistics.
+static void drv_stats_sum(drv_stats_t* stats, drv_stats_cell_t* cell) {
+    stats->calls += drv_stats_load(&cell->calls);
+    stats->bytes += drv_stats_load(&cell->bytes);
+    stats->errors += drv_stats_load(&cell->errors);
+    stats->latency_ns += drv_stats_load(&cell->latency_ns);
+    for (size_t i = 0; i < DRV_STATS_BUCKETS; i++) {
+        stats->histogram[i] += drv_stats_load(&cell->histogram[i]);
+    }
+    for (size_t i = 0; i < DRV_STATS_ERRNOS; i++) {
+        int error = atomic_load_explicit(&cell->errno_error[i], memory_order_relaxed);
+        if (error == 0) {
+            break;
+        }
+        // Merge by errno. Errnos without free slot are only counted in errors.
+        for (size_t j = 0; j < DRV_STATS_ERRNOS; j++) {
+            if ((stats->errnos[j].error == error) || (stats->errnos[j].error == 0)) {
+                stats->errnos[j].error = error;
+                stats->errnos[j].count += drv_stats_load(&cell->errno_count[i]);
+                break;
+            }
+        }
+    }
+}
+
+// Sums the statistics of a driver over all tables.
+static void drv_stats_collect(const driver_t* driver, drv_stat_op_t op, drv_stats_t* stats) {
+    memset(stats, 0, sizeof(drv_stats_t));
+    drv_stats_thread_t* thread = atomic_load_explicit(&drv_stats_threads, memory_order_acquire);
+    for (; thread != NULL; thread = thread->next) {
+        drv_stats_entry_t* entry = drv_stats_find(thread, driver, 0);
+        if (entry != NULL) {
+            drv_stats_sum(stats, &entry->ops[op]);
+        }
+    }
+}
+
+// Checks, if a driver has an entry in one of the tables before a table.
+static int drv_stats_seen(drv_stats_thread_t* first, drv_stats_thread_t* thread, const driver_t* driver) {
+    for (; first != thread; first = first->next) {
+        if (drv_stats_find(first, driver, 0) != NULL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Prints the statistics of all operations of a driver.
+static void drv_stats_print(FILE* out, const driver_t* driver, const char* name) {
+    for (int op = 0; op < DRV_STAT_OPS; op++) {
+        drv_stats_t stats;
+        drv_stats_collect(driver, (drv_stat_op_t)op, &stats);
+        if (stats.calls == 0) {
+            continue;
+        }
+        fprintf(out, "%-*s %-10s calls %llu bytes %llu errors %llu avg %llu ns\n",
+                (int)DRV_STATS_NAME_LEN, name, drv_stats_op_names[op],
+                (unsigned long long)stats.calls, (unsigned long long)stats.bytes,
+                (unsigned long long)stats.errors, (unsigned long long)(stats.latency_ns / stats.calls));
+        for (size_t i = 0; (i < DRV_STATS_ERRNOS) && (stats.errnos[i].error != 0); i++) {
+            fprintf(out, "    errno %d: %llu\n", stats.errnos[i].error, (unsigned long long)stats.errnos[i].count);
+        }
+        for (size_t i = 0; i < DRV_STATS_BUCKETS; i++) {
+            if (stats.histogram[i] != 0) {
+                fprintf(out, "    < %llu ns: %llu\n", 2ULL << i, (unsigned long long)stats.histogram[i]);
+            }
+        }
+    }
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_stats_get: Get the statistics of an operation of a driver, summed over all threads.
+ *
+ * @param (const driver_t*) driver: Driver. NULL: Drivers without own table entry.
+ * @param (drv_stat_op_t) op: Operation.
+ * @param (drv_stats_t*) stats: Returns the statistics.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_get(const driver_t* driver, drv_stat_op_t op, drv_stats_t* stats) {
+    // Parameter check
+    if (((unsigned)op >= DRV_STAT_OPS) || (stats == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+    drv_stats_collect(driver, op, stats);
+    return 0;
+}
+
+/**
+ * @brief drv_stats_properties: Get the number of statistic properties (see DRV_STAT_PROP()).
+ *
+ * @return (size_t): Number of properties. 0 without DRV_STATS.
+ */
+size_t drv_stats_properties(void) {
+    return DRV_STAT_OPS * DRV_STAT_FIELDS;
+}
+
+/**
+ * @brief drv_stats_property: Get a statistic value of a driver as property (PROP_STAT, unsigned 64 bit).
+ *
+ * @param (const driver_t*) driver: Driver.
+ * @param (size_t) id: Property id, see DRV_STAT_PROP().
+ *
+ * @return (property_t*): NULL: Failed. For reason see errno-variable; other: Property.
+ *                        Valid until the next call of the same thread.
+ */
+property_t* drv_stats_property(const driver_t* driver, size_t id) {
+    static _Thread_local property_t property;
+
+    // Parameter check
+    if ((driver == NULL) || (id >= DRV_STAT_OPS * DRV_STAT_FIELDS)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    drv_stats_t stats;
+    drv_stats_collect(driver, (drv_stat_op_t)(id / DRV_STAT_FIELDS), &stats);
+    const uint64_t values[DRV_STAT_FIELDS] = {
+        [DRV_STAT_CALLS] = stats.calls,
+        [DRV_STAT_BYTES] = stats.bytes,
+        [DRV_STAT_ERRORS] = stats.errors,
+        [DRV_STAT_LATENCY_NS] = stats.latency_ns,
+    };
+    memcpy(&property, &(property_t){ .type = PROP_STAT,
+                                     .property = { .type = TYPE_CLASS_INT | TYPE_UNSIGNED | TYPE_SIZE_64,
+                                                   .uval = values[id % DRV_STAT_FIELDS] } },
+           sizeof(property_t));
+    return &property;
+}
+
+/**
+ * @brief drv_stats_dump: Print the statistics of all drivers and operations with calls.
+ *
+ * @param (FILE*) out: Output stream.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_dump(FILE* out) {
+    // Parameter check
+    if (out == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    drv_stats_thread_t* first = atomic_load_explicit(&drv_stats_threads, memory_order_acquire);
+    for (drv_stats_thread_t* thread = first; thread != NULL; thread = thread->next) {
+        for (size_t i = 0; i < DRV_STATS_DRIVERS; i++) {
+            drv_stats_entry_t* entry = &thread->entries[i];
+            const driver_t* driver = atomic_load_explicit(&entry->driver, memory_order_acquire);
+            if ((driver != NULL) && !drv_stats_seen(first, thread, driver)) {
+                drv_stats_print(out, driver, entry->name);
+            }
+        }
+    }
+    drv_stats_print(out, NULL, "(other)");
+    return 0;
+}
+
+/**
+ * @brief drv_stats_reset: Clear all statistics. Calls running at the same time may be lost or kept.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_reset(void) {
+    drv_stats_thread_t* thread = atomic_load_explicit(&drv_stats_threads, memory_order_acquire);
+    for (; thread != NULL; thread = thread->next) {
+        for (size_t i = 0; i <= DRV_STATS_DRIVERS; i++) {
+            drv_stats_entry_t* entry = (i < DRV_STATS_DRIVERS) ? &thread->entries[i] : &thread->overflow;
+            for (size_t op = 0; op < DRV_STAT_OPS; op++) {
+                drv_stats_cell_t* cell = &entry->ops[op];
+                atomic_store_explicit(&cell->calls, 0, memory_order_relaxed);
+                atomic_store_explicit(&cell->bytes, 0, memory_order_relaxed);
+                atomic_store_explicit(&cell->errors, 0, memory_order_relaxed);
+                atomic_store_explicit(&cell->latency_ns, 0, memory_order_relaxed);
+                for (size_t j = 0; j < DRV_STATS_ERRNOS; j++) {
+                    atomic_store_explicit(&cell->errno_error[j], 0, memory_order_relaxed);
+                    atomic_store_explicit(&cell->errno_count[j], 0, memory_order_relaxed);
+                }
+                for (size_t j = 0; j < DRV_STATS_BUCKETS; j++) {
+                    atomic_store_explicit(&cell->histogram[j], 0, memory_order_relaxed);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief drv_stats_now: Get the start time of a call (used by DRV_STATS_START()).
+ *
+ * @return (uint64_t): Monotonic time [ns].
+ */
+uint64_t drv_stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief drv_stats_record: Count a call in the table of the calling thread (used by DRV_STATS_RECORD()).
+ * Keeps errno.
+ *
+ * @param (const driver_t*) driver: Driver whose fop was called.
+ * @param (drv_stat_op_t) op: Operation.
+ * @param (uint64_t) start: Start time of drv_stats_now().
+ * @param (int) failed: true: Call failed with errno.
+ * @param (size_t) bytes: Moved bytes of a successful call.
+ */
+void drv_stats_record(const driver_t* driver, drv_stat_op_t op, uint64_t start, int failed, size_t bytes) {
+    int error = errno;
+    uint64_t latency = drv_stats_now() - start;
+    drv_stats_thread_t* thread = drv_stats_thread();
+    if (thread == NULL) {
+        errno = error;
+        return;                                     // No memory: Not counted.
+    }
+
+    drv_stats_cell_t* cell = &drv_stats_find(thread, driver, 1)->ops[op];
+    drv_stats_add(&cell->calls, 1);
+    drv_stats_add(&cell->latency_ns, latency);
+    size_t bucket = (latency < 2U) ? 0 : (size_t)(63 - __builtin_clzll(latency));
+    drv_stats_add(&cell->histogram[(bucket < DRV_STATS_BUCKETS) ? bucket : DRV_STATS_BUCKETS - 1U], 1);
+    if (!failed) {
+        drv_stats_add(&cell->bytes, bytes);
+        return;
+    }
+
+    drv_stats_add(&cell->errors, 1);
+    for (size_t i = 0; i < DRV_STATS_ERRNOS; i++) {
+        int slot = atomic_load_explicit(&cell->errno_error[i], memory_order_relaxed);
+        if (slot == 0) {
+            atomic_store_explicit(&cell->errno_error[i], error, memory_order_relaxed);
+        }
+        if ((slot == 0) || (slot == error)) {
+            drv_stats_add(&cell->errno_count[i], 1);
+            break;
+        }
+    }
+    errno = error;
+}
+
+#else // DRV_STATS
+
+// Compiled out: No statistics.
+
+int drv_stats_get(const driver_t* driver, drv_stat_op_t op, drv_stats_t* stats) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+size_t drv_stats_properties(void) {
+    return 0;
+}
+
+property_t* drv_stats_property(const driver_t* driver, size_t id) {
+    errno = ENOTSUP;
+    return NULL;
+}
+
+int drv_stats_dump(FILE* out) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+int drv_stats_reset(void) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+uint64_t drv_stats_now(void) {
+    return 0;
+}
+
+void drv_stats_record(const driver_t* driver, drv_stat_op_t op, uint64_t start, int failed, size_t bytes) {
+}
+
+#endif // DRV_STATS
@@ -0,0 +1,157 @@
+/**
+ * @file    drv_stats.h
+ * @brief   Call statistics of the dispatch layer per driver and operation.
+ *
+ * @details
+ * With DRV_STATS defined (CMake option DRV_STATS), driver.c counts for every driver and
+ * operation the calls, moved bytes, errors by errno and a histogram of the latencies
+ * with logarithmic buckets. The key is the driver whose fop is called: The base driver
+ * for open and (de)registration, the driver itself for all other operations.
+ * Calls through bound handles (drv_bind()) are not counted.
+ *
+ * Every thread counts into its own table, so counting needs no locks and no shared
+ * cache lines. Reading (drv_stats_get(), drv_stats_dump()) sums the tables of all
+ * threads, including threads which have already ended.
+ *
+ * Without DRV_STATS, DRV_STATS_START()/DRV_STATS_RECORD() expand to nothing and the
+ * functions of this module fail with ENOTSUP.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_STATS_H_
+#define _DRV_STATS_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_STATS_DRIVERS   (32U)       /// Drivers with own statistics per thread. Power of two. More are counted as driver NULL.
+#define DRV_STATS_BUCKETS   (32U)       /// Latency buckets: Bucket i counts [2^i, 2^(i+1)) ns, bucket 0 also 0 ns, the last all above.
+#define DRV_STATS_ERRNOS    (8U)        /// Different errnos counted per operation. Further errnos are only counted in errors.
+#define DRV_STATS_NAME_LEN  (24U)       /// Max. length of a driver name in drv_stats_dump() incl. '\0'.
+
+/*
+ * Types
+ */
+typedef enum {
+    DRV_STAT_OPEN,
+    DRV_STAT_CLOSE,
+    DRV_STAT_READ,                                  // Incl. drv_readv() and drv_fread().
+    DRV_STAT_WRITE,                                 // Incl. drv_writev() and drv_fwrite().
+    DRV_STAT_IOCTL,                                 // Incl. drv_ioctl_batch() (one call per batch) and drv_fioctl().
+    DRV_STAT_REGISTER,                              // Incl. drv_register_many() (one call per batch).
+    DRV_STAT_DEREGISTER,                            // Incl. drv_deregister_many() (one call per batch).
+    DRV_STAT_OPS
+} drv_stat_op_t;
+
+// Values of an operation as properties, see drv_stats_property().
+typedef enum {
+    DRV_STAT_CALLS,
+    DRV_STAT_BYTES,
+    DRV_STAT_ERRORS,
+    DRV_STAT_LATENCY_NS,
+    DRV_STAT_FIELDS
+} drv_stat_field_t;
+
+// Property id of a value of an operation.
+#define DRV_STAT_PROP(op, field)    ((size_t)(op) * DRV_STAT_FIELDS + (size_t)(field))
+
+// Statistics of one operation of a driver.
+typedef struct {
+    uint64_t calls;                                 // Number of calls.
+    uint64_t bytes;                                 // Moved bytes of successful reads and writes.
+    uint64_t errors;                                // Failed calls.
+    uint64_t latency_ns;                            // Sum of the latencies.
+    struct {
+        int error;                                  // errno. 0: Unused.
+        uint64_t count;                             // Failed calls with this errno.
+    } errnos[DRV_STATS_ERRNOS];
+    uint64_t histogram[DRV_STATS_BUCKETS];          // Calls per latency bucket.
+} drv_stats_t;
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_stats_get: Get the statistics of an operation of a driver, summed over all threads.
+ *
+ * @param (const driver_t*) driver: Driver. NULL: Drivers without own table entry.
+ * @param (drv_stat_op_t) op: Operation.
+ * @param (drv_stats_t*) stats: Returns the statistics.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_get(const driver_t* driver, drv_stat_op_t op, drv_stats_t* stats);
+
+/**
+ * @brief drv_stats_properties: Get the number of statistic properties (see DRV_STAT_PROP()).
+ *
+ * @return (size_t): Number of properties. 0 without DRV_STATS.
+ */
+size_t drv_stats_properties(void);
+
+/**
+ * @brief drv_stats_property: Get a statistic value of a driver as property (PROP_STAT, unsigned 64 bit).
+ *
+ * @param (const driver_t*) driver: Driver.
+ * @param (size_t) id: Property id, see DRV_STAT_PROP().
+ *
+ * @return (property_t*): NULL: Failed. For reason see errno-variable; other: Property.
+ *                        Valid until the next call of the same thread.
+ */
+property_t* drv_stats_property(const driver_t* driver, size_t id);
+
+/**
+ * @brief drv_stats_dump: Print the statistics of all drivers and operations with calls.
+ *
+ * @param (FILE*) out: Output stream.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_dump(FILE* out);
+
+/**
+ * @brief drv_stats_reset: Clear all statistics. Calls running at the same time may be lost or kept.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_stats_reset(void);
+
+/**
+ * @brief drv_stats_now: Get the start time of a call (used by DRV_STATS_START()).
+ *
+ * @return (uint64_t): Monotonic time [ns].
+ */
+uint64_t drv_stats_now(void);
+
+/**
+ * @brief drv_stats_record: Count a call in the table of the calling thread (used by DRV_STATS_RECORD()).
+ * Keeps errno.
+ *
+ * @param (const driver_t*) driver: Driver whose fop was called.
+ * @param (drv_stat_op_t) op: Operation.
+ * @param (uint64_t) start: Start time of drv_stats_now().
+ * @param (int) failed: true: Call failed with errno.
+ * @param (size_t) bytes: Moved bytes of a successful call.
+ */
+void drv_stats_record(const driver_t* driver, drv_stat_op_t op, uint64_t start, int failed, size_t bytes);
+
+#ifdef DRV_STATS
+#define DRV_STATS_START(start)                              uint64_t start = drv_stats_now()
+#define DRV_STATS_RECORD(driver, op, start, failed, bytes)  drv_stats_record((driver), (op), (start), (failed), (bytes))
+#else
+#define DRV_STATS_START(start)
+#define DRV_STATS_RECORD(driver, op, start, failed, bytes)  ((void)0)
+#endif
+
+#endif //_DRV_STATS_H_
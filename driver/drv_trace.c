@@ -0,0 +1,395 @@
+/**
+ * @file    drv_trace.c
+ * @brief   Binary trace of the driver calls in lock-free rings per thread.
+ *
+ * @details
+ * Every thread takes a ring on its first record: The ring of an ended thread, or a new one,
+ * which is linked into a global list. The list only grows. The records of an ended thread
+ * are kept, until the next owner overwrites them. Only the owning thread writes a ring: It fills the record and then publishes it by a
+ * release store of head. drv_trace_dump() copies the records and drops those, which
+ * the owner may have overwritten during the copy.
+ *
+ * The time stamps are read from the time stamp counter where available (x86: rdtsc,
+ * aarch64: cntvct_el0), otherwise from CLOCK_MONOTONIC. The dump header holds two
+ * pairs of ticks and ns, from which the decoder derives the tick rate.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_trace.h"
+#include <hash.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * LOCAL Types
+ */
+typedef struct {
+    const driver_t* driver;                         // NULL: Free.
+    uint64_t index;                                 // Index of the DRV_TRACE_NAME record.
+    char name[16];                                  // Copy of the name for drv_trace_dump().
+} drv_trace_name_t;
+
+typedef struct drv_trace_ring_s {
+    drv_trace_record_t records[DRV_TRACE_RECORDS];
+    _Atomic uint64_t head;                          // Number of records written.
+    _Atomic uint64_t start;                         // Index of the first record after drv_trace_clear().
+    uint32_t thread;                                // Number of the thread.
+    uint32_t generation;                            // drv_trace_generation, for which names is valid.
+    drv_trace_name_t names[DRV_TRACE_NAMES];        // Drivers with DRV_TRACE_NAME record, direct mapped by hash_ptr().
+    atomic_bool in_use;                             // Ring belongs to a thread.
+    struct drv_trace_ring_s* next;                  // List of all rings.
+} drv_trace_ring_t;
+
+/*
+ * Global Variables
+ */
+_Atomic int drv_trace_enabled = 0;
+
+/*
+ * LOCAL Variables
+ */
+static _Thread_local drv_trace_ring_t* drv_trace_self = NULL;
+static drv_trace_ring_t* _Atomic drv_trace_rings = NULL;
+static _Atomic uint32_t drv_trace_threads = 0;
+static pthread_once_t drv_trace_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t drv_trace_key;
+static _Atomic uint32_t drv_trace_generation = 0;   // Incremented by drv_trace_clear(): Names must be recorded again.
+static _Atomic int drv_trace_calibrated = 0;         // 1: Calibrating, 2: drv_trace_ticks0/drv_trace_ns0 valid.
+static uint64_t drv_trace_ticks0;                   // Calibration at the first drv_trace_enable().
+static uint64_t drv_trace_ns0;
+
+/*
+ * LOCAL Functions
+ */
+static uint64_t drv_trace_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t drv_trace_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return drv_trace_ns();
+#endif
+}
+
+// Thread exit: Hand the ring over to the next thread. Its records are kept.
+static void drv_trace_thread_exit(void* ring) {
+    atomic_store_explicit(&((drv_trace_ring_t*)ring)->in_use, false, memory_order_release);
+}
+
+static void drv_trace_key_create(void) {
+    (void)pthread_key_create(&drv_trace_key, drv_trace_thread_exit);
+}
+
+// Gets the ring of the calling thread. On the first call it takes the ring of an ended thread,
+// or allocates and links a new one.
+static drv_trace_ring_t* drv_trace_ring(void) {
+    if (drv_trace_self != NULL) {
+        return drv_trace_self;
+    }
+    (void)pthread_once(&drv_trace_key_once, drv_trace_key_create);
+
+    drv_trace_ring_t* self;
+    for (self = atomic_load_explicit(&drv_trace_rings, memory_order_acquire); self != NULL; self = self->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&self->in_use, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (self == NULL) {
+        self = calloc(1, sizeof(drv_trace_ring_t));
+        if (self == NULL) {
+            return NULL;
+        }
+        atomic_init(&self->in_use, true);
+        self->thread = atomic_fetch_add_explicit(&drv_trace_threads, 1, memory_order_relaxed);
+        self->generation = atomic_load_explicit(&drv_trace_generation, memory_order_relaxed);
+        self->next = atomic_load_explicit(&drv_trace_rings, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&drv_trace_rings, &self->next, self,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    (void)pthread_setspecific(drv_trace_key, self);
+    drv_trace_self = self;
+    return self;
+}
+
+// Gets the next record of the own ring. Published by drv_trace_publish().
+static inline drv_trace_record_t* drv_trace_next(drv_trace_ring_t* ring) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    return &ring->records[head & (DRV_TRACE_RECORDS - 1U)];
+}
+
+static inline void drv_trace_publish(drv_trace_ring_t* ring) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+}
+
+// Records the name of a driver, if it isn't known in the ring.
+static void drv_trace_name(drv_trace_ring_t* ring, const driver_t* driver, uint64_t time) {
+    uint32_t generation = atomic_load_explicit(&drv_trace_generation, memory_order_relaxed);
+    if (ring->generation != generation) {
+        memset(ring->names, 0, sizeof(ring->names));
+        ring->generation = generation;
+    }
+    drv_trace_name_t* name = &ring->names[hash_ptr(driver) & (DRV_TRACE_NAMES - 1U)];
+    if (name->driver == driver) {
+        return;
+    }
+    name->driver = driver;
+    name->index = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    memset(name->name, 0, sizeof(name->name));
+    if (driver->name != NULL) {
+        strncpy(name->name, driver->name, sizeof(name->name));
+    }
+
+    drv_trace_record_t* record = drv_trace_next(ring);
+    memset(record, 0, sizeof(drv_trace_record_t));
+    record->time = time;
+    record->driver = (uint64_t)(uintptr_t)driver;
+    record->op = DRV_TRACE_NAME;
+    memcpy(record->name, name->name, sizeof(record->name));
+    drv_trace_publish(ring);
+}
+
+/**
+ * @brief drv_trace_lost_names: Create DRV_TRACE_NAME records for the drivers of a ring,
+ * whose name record was overwritten, so the dump stays decodable.
+ *
+ * @param (const drv_trace_ring_t*) ring: Ring.
+ * @param (uint64_t) begin: Index of the first dumped record.
+ * @param (uint64_t) time: Time stamp of the first dumped record.
+ * @param (drv_trace_record_t*) records: Returns the name records. DRV_TRACE_NAMES entries.
+ *
+ * @return (uint32_t): Number of name records.
+ */
+static uint32_t drv_trace_lost_names(const drv_trace_ring_t* ring, uint64_t begin, uint64_t time, drv_trace_record_t* records) {
+    uint32_t count = 0;
+    if (ring->generation != atomic_load_explicit(&drv_trace_generation, memory_order_relaxed)) {
+        return 0;                                   // Names from before drv_trace_clear().
+    }
+    for (uint32_t i = 0; i < DRV_TRACE_NAMES; i++) {
+        const drv_trace_name_t* name = &ring->names[i];
+        if ((name->driver == NULL) || (name->index >= begin)) {
+            continue;
+        }
+        drv_trace_record_t* record = &records[count++];
+        memset(record, 0, sizeof(drv_trace_record_t));
+        record->time = time;
+        record->driver = (uint64_t)(uintptr_t)name->driver;
+        record->op = DRV_TRACE_NAME;
+        memcpy(record->name, name->name, sizeof(record->name));
+    }
+    return count;
+}
+
+// Takes the first calibration point of the time stamps, if not done yet.
+static void drv_trace_calibrate(void) {
+    int calibrated = 0;
+    if (atomic_compare_exchange_strong_explicit(&drv_trace_calibrated, &calibrated, 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        drv_trace_ns0 = drv_trace_ns();
+        drv_trace_ticks0 = drv_trace_ticks();
+        atomic_store_explicit(&drv_trace_calibrated, 2, memory_order_release);
+    }
+}
+
+static int drv_trace_write(FILE* out, const void* data, size_t size) {
+    if ((size != 0) && (fwrite(data, size, 1, out) != 1)) {
+        if (errno == 0) {
+            errno = EIO;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_trace_enable: Switch tracing on or off at runtime.
+ *
+ * @param (int) on: true: Record the following calls.
+ *
+ * @return (int): Previous state.
+ */
+int drv_trace_enable(int on) {
+    if (on) {
+        drv_trace_calibrate();
+    }
+    return atomic_exchange_explicit(&drv_trace_enabled, on ? 1 : 0, memory_order_relaxed);
+}
+
+/**
+ * @brief drv_trace_record: Append a record to the ring of the calling thread (used by DRV_TRACE()).
+ * Keeps errno. If the ring of the thread can't be allocated, the record is dropped.
+ *
+ * @param (const driver_t*) driver: Driver.
+ * @param (drv_trace_op_t) op: Operation.
+ * @param (int64_t) size: Size of the request, see drv_trace_op_t.
+ * @param (int64_t) result: Return value.
+ * @param (int) failed: true: Call failed, record errno.
+ */
+void drv_trace_record(const driver_t* driver, drv_trace_op_t op, int64_t size, int64_t result, int failed) {
+    int error = errno;
+    drv_trace_ring_t* ring = drv_trace_ring();
+    if (ring == NULL) {
+        errno = error;
+        return;                                     // No memory: Not recorded.
+    }
+
+    uint64_t time = drv_trace_ticks();
+    if (driver != NULL) {
+        drv_trace_name(ring, driver, time);
+    }
+    drv_trace_record_t* record = drv_trace_next(ring);
+    record->time = time;
+    record->driver = (uint64_t)(uintptr_t)driver;
+    record->size = size;
+    record->result = result;
+    record->op = (uint16_t)op;
+    record->error = failed ? (uint16_t)error : 0;
+    record->point = 0;
+    drv_trace_publish(ring);
+    errno = error;
+}
+
+/**
+ * @brief drv_trace_point: Append a tracepoint event to the ring of the calling thread
+ * (sink DRV_TP_SINK_TRACE, see drv_tracepoint.h). Recorded even if tracing is disabled.
+ * Keeps errno.
+ *
+ * @param (uint32_t) point: Tracepoint id.
+ * @param (int64_t) a0: First argument.
+ * @param (int64_t) a1: Second argument.
+ */
+void drv_trace_point(uint32_t point, int64_t a0, int64_t a1) {
+    int error = errno;
+    if (atomic_load_explicit(&drv_trace_calibrated, memory_order_relaxed) == 0) {
+        drv_trace_calibrate();                      // Tracepoints record without drv_trace_enable().
+    }
+    drv_trace_ring_t* ring = drv_trace_ring();
+    if (ring == NULL) {
+        errno = error;
+        return;                                     // No memory: Not recorded.
+    }
+
+    drv_trace_record_t* record = drv_trace_next(ring);
+    record->time = drv_trace_ticks();
+    record->driver = 0;
+    record->size = a0;
+    record->result = a1;
+    record->op = DRV_TRACE_POINT;
+    record->error = 0;
+    record->point = point;
+    drv_trace_publish(ring);
+    errno = error;
+}
+
+/**
+ * @brief drv_trace_dump: Write the records of all threads in binary format.
+ * Records written concurrently to the dump may be missing.
+ *
+ * @param (FILE*) out: Output stream. Open in binary mode.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_trace_dump(FILE* out) {
+    // Parameter check
+    if (out == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    drv_trace_ring_t* first = atomic_load_explicit(&drv_trace_rings, memory_order_acquire);
+    drv_trace_header_t header = {
+        .version = DRV_TRACE_VERSION,
+        .record_size = sizeof(drv_trace_record_t),
+        .ns = { 0, drv_trace_ns() },
+    };
+    memcpy(header.magic, DRV_TRACE_MAGIC, sizeof(header.magic));
+    header.ticks[1] = drv_trace_ticks();
+    if (atomic_load_explicit(&drv_trace_calibrated, memory_order_acquire) == 2) {
+        header.ticks[0] = drv_trace_ticks0;
+        header.ns[0] = drv_trace_ns0;
+    } else {
+        header.ticks[0] = header.ticks[1];
+        header.ns[0] = header.ns[1];
+    }
+    for (drv_trace_ring_t* ring = first; ring != NULL; ring = ring->next) {
+        header.threads++;
+    }
+
+    drv_trace_record_t* copy = malloc(sizeof(drv_trace_record_t) * (DRV_TRACE_NAMES + DRV_TRACE_RECORDS));
+    if (copy == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    errno = 0;
+    int result = drv_trace_write(out, &header, sizeof(header));
+    for (drv_trace_ring_t* ring = first; (ring != NULL) && (result == 0); ring = ring->next) {
+        uint64_t start = atomic_load_explicit(&ring->start, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t begin = (head > DRV_TRACE_RECORDS) ? head - DRV_TRACE_RECORDS : 0;
+        begin = (begin > start) ? begin : start;
+        drv_trace_record_t* records = copy + DRV_TRACE_NAMES;
+        for (uint64_t i = begin; i < head; i++) {
+            records[i - begin] = ring->records[i & (DRV_TRACE_RECORDS - 1U)];
+        }
+        // Drop the records, which the owner overwrote during the copy.
+        uint64_t end = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t valid = (end > DRV_TRACE_RECORDS) ? end - DRV_TRACE_RECORDS : 0;
+        uint64_t skip = (valid > begin) ? valid - begin : 0;
+        if (skip > head - begin) {
+            skip = head - begin;
+        }
+
+        uint32_t count = (uint32_t)(head - begin - skip);
+        uint32_t names = (count != 0) ? drv_trace_lost_names(ring, begin + skip, records[skip].time, copy) : 0;
+        // Lost names directly before the records.
+        memmove(records + skip - names, copy, sizeof(drv_trace_record_t) * names);
+
+        drv_trace_thread_t thread = {
+            .thread = ring->thread,
+            .count = names + count,
+            .lost = begin + skip - start,
+        };
+        result = drv_trace_write(out, &thread, sizeof(thread));
+        if (result == 0) {
+            result = drv_trace_write(out, records + skip - names, sizeof(drv_trace_record_t) * thread.count);
+        }
+    }
+    free(copy);
+    return result;
+}
+
+/**
+ * @brief drv_trace_clear: Drop the records of all threads.
+ */
+void drv_trace_clear(void) {
+    atomic_fetch_add_explicit(&drv_trace_generation, 1, memory_order_relaxed);
+    for (drv_trace_ring_t* ring = atomic_load_explicit(&drv_trace_rings, memory_order_acquire); ring != NULL; ring = ring->next) {
+        atomic_store_explicit(&ring->start, atomic_load_explicit(&ring->head, memory_order_relaxed), memory_order_relaxed);
+    }
+}
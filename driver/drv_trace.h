@@ -0,0 +1,163 @@
+/**
+ * @file    drv_trace.h
+ * @brief   Binary trace of the driver calls in lock-free rings per thread.
+ *
+ * @details
+ * While tracing is enabled (drv_trace_enable()), driver.c appends a fixed size record
+ * for every register, deregister, open, close, read, write and ioctl call to a ring of
+ * the calling thread: Time stamp, driver, operation, size, result and errno.
+ * Disabled, a call costs one relaxed load and a branch. Tracing is always compiled in.
+ *
+ * Every thread writes only its own ring, so recording needs no locks and no atomic
+ * read-modify-write. A ring keeps the last DRV_TRACE_RECORDS records; older ones are
+ * overwritten. The ring of an ended thread is continued by the next new thread.
+ * The first record of a driver in a ring is preceded by a DRV_TRACE_NAME
+ * record with (the start of) its name, so the trace can be decoded without the process.
+ *
+ * drv_trace_dump() writes all rings in the binary format below. The build tool
+ * drv_trace_decode (tools/) merges the rings by time and prints them as text:
+ *
+ *   drv_trace_header_t
+ *   threads * { drv_trace_thread_t, count * drv_trace_record_t }
+ *
+ * All values are in the byte order of the traced system.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_TRACE_H_
+#define _DRV_TRACE_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_TRACE_RECORDS   (4096U)             /// Records per thread. Power of two.
+#define DRV_TRACE_NAMES     (16U)               /// Drivers per thread, whose name was already recorded. Power of two.
+#define DRV_TRACE_MAGIC     "DRVTRACE"          /// Start of a dump (8 characters, without '\0').
+#define DRV_TRACE_VERSION   (1U)                /// Version of the dump format.
+
+/*
+ * Types
+ */
+typedef enum {
+    DRV_TRACE_NAME,                             // Name of a driver: name holds up to 16 characters (not terminated).
+    DRV_TRACE_REGISTER,                         // size: Number of drivers (drv_register_many()) or 1.
+    DRV_TRACE_DEREGISTER,                       // size: Number of drivers (drv_deregister_many()) or 1.
+    DRV_TRACE_OPEN,
+    DRV_TRACE_CLOSE,
+    DRV_TRACE_READ,                             // size: Requested bytes or iovcnt (drv_readv()).
+    DRV_TRACE_WRITE,                            // size: Requested bytes or iovcnt (drv_writev()).
+    DRV_TRACE_IOCTL,                            // size: ioctl id or number of requests (drv_ioctl_batch()).
+    DRV_TRACE_POINT,                            // Tracepoint (drv_tracepoint.h): point: Id, size: a0, result: a1, driver: 0.
+    DRV_TRACE_OPS
+} drv_trace_op_t;
+
+// One trace record (40 bytes).
+typedef struct {
+    uint64_t time;                              // Time stamp [ticks], see drv_trace_header_t.
+    uint64_t driver;                            // Address of the driver.
+    union {
+        struct {
+            int64_t size;                       // Size of the request, see drv_trace_op_t.
+            int64_t result;                     // Return value. open: 0 or -1.
+        };
+        char name[16];                          // DRV_TRACE_NAME.
+    };
+    uint16_t op;                                // drv_trace_op_t.
+    uint16_t error;                             // errno of a failed call, else 0.
+    uint32_t point;                             // DRV_TRACE_POINT: drv_tp_id_t, else 0.
+} drv_trace_record_t;
+
+// Start of a dump.
+typedef struct {
+    char magic[8];                              // DRV_TRACE_MAGIC.
+    uint32_t version;                           // DRV_TRACE_VERSION.
+    uint32_t record_size;                       // sizeof(drv_trace_record_t).
+    uint64_t ticks[2];                          // Time stamps at the first drv_trace_enable() and the dump ...
+    uint64_t ns[2];                             // ... and the same moments in monotonic ns. Convert ticks by interpolation.
+    uint32_t threads;                           // Number of following threads.
+    uint32_t reserved;
+} drv_trace_header_t;
+
+// Start of the records of a thread.
+typedef struct {
+    uint32_t thread;                            // Number of the ring (order of the first record). Continued by later threads.
+    uint32_t count;                             // Number of following records, oldest first.
+    uint64_t lost;                              // Records overwritten before the dump.
+} drv_trace_thread_t;
+
+/*
+ * Global Variables
+ */
+extern _Atomic int drv_trace_enabled;           // Use drv_trace_enable().
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_trace_enable: Switch tracing on or off at runtime.
+ *
+ * @param (int) on: true: Record the following calls.
+ *
+ * @return (int): Previous state.
+ */
+int drv_trace_enable(int on);
+
+/**
+ * @brief drv_trace_record: Append a record to the ring of the calling thread (used by DRV_TRACE()).
+ * Keeps errno. If the ring of the thread can't be allocated, the record is dropped.
+ *
+ * @param (const driver_t*) driver: Driver.
+ * @param (drv_trace_op_t) op: Operation.
+ * @param (int64_t) size: Size of the request, see drv_trace_op_t.
+ * @param (int64_t) result: Return value.
+ * @param (int) failed: true: Call failed, record errno.
+ */
+void drv_trace_record(const driver_t* driver, drv_trace_op_t op, int64_t size, int64_t result, int failed);
+
+/**
+ * @brief drv_trace_point: Append a tracepoint event to the ring of the calling thread
+ * (sink DRV_TP_SINK_TRACE, see drv_tracepoint.h). Recorded even if tracing is disabled.
+ * Keeps errno.
+ *
+ * @param (uint32_t) point: Tracepoint id.
+ * @param (int64_t) a0: First argument.
+ * @param (int64_t) a1: Second argument.
+ */
+void drv_trace_point(uint32_t point, int64_t a0, int64_t a1);
+
+/**
+ * @brief drv_trace_dump: Write the records of all threads in binary format.
+ * Records written concurrently to the dump may be missing.
+ *
+ * @param (FILE*) out: Output stream. Open in binary mode.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_trace_dump(FILE* out);
+
+/**
+ * @brief drv_trace_clear: Drop the records of all threads.
+ */
+void drv_trace_clear(void);
+
+// Record a call, if tracing is enabled.
+#define DRV_TRACE(driver, op, size, result, failed)                                             \
+    do {                                                                                        \
+        if (atomic_load_explicit(&drv_trace_enabled, memory_order_relaxed)) {                   \
+            drv_trace_record((driver), (op), (int64_t)(size), (int64_t)(result), (failed));     \
+        }                                                                                       \
+    } while (0)
+
+#endif //_DRV_TRACE_H_
@@ -0,0 +1,144 @@
+/**
+ * @file    drv_tracepoint.c
+ * @brief   Static tracepoints inside the registry and the base drivers.
+ *
+ * @details
+ * The keys are read by the tracepoints with a relaxed load, so enabling a tracepoint
+ * reaches other threads with a short delay. Events are delivered synchronously in the
+ * thread of the tracepoint.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_tracepoint.h"
+#include <errno.h>
+#include <stddef.h>
+
+#ifdef DRV_TRACEPOINTS
+#include <drv_trace.h>
+
+/*
+ * Global Variables
+ */
+_Atomic unsigned drv_tp_keys[DRV_TP_COUNT];
+
+/*
+ * LOCAL Variables
+ */
+#define DRV_TP_NAME(id, name) name,
+static const char* const drv_tp_names[DRV_TP_COUNT] = {
+    DRV_TP_LIST(DRV_TP_NAME)
+};
+#undef DRV_TP_NAME
+
+static drv_tp_callback_t _Atomic drv_tp_callback = NULL;
+static void* _Atomic drv_tp_user = NULL;
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_tracepoint_enable: Select the sinks of a tracepoint at runtime.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint. DRV_TP_COUNT: All tracepoints.
+ * @param (unsigned) sinks: DRV_TP_SINK_* flags. 0: Disable.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_tracepoint_enable(drv_tp_id_t id, unsigned sinks) {
+    // Parameter check
+    if (((unsigned)id > DRV_TP_COUNT) || ((sinks & ~(DRV_TP_SINK_TRACE | DRV_TP_SINK_CALLBACK)) != 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (unsigned i = 0; i < DRV_TP_COUNT; i++) {
+        if ((id == DRV_TP_COUNT) || (i == (unsigned)id)) {
+            atomic_store_explicit(&drv_tp_keys[i], sinks, memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief drv_tracepoint_callback: Set the callback for DRV_TP_SINK_CALLBACK.
+ * Set it before enabling the sink; events of a concurrent change may reach the old callback.
+ *
+ * @param (drv_tp_callback_t) callback: Callback. NULL: Drop the events.
+ * @param (void*) user: Passed to the callback.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_tracepoint_callback(drv_tp_callback_t callback, void* user) {
+    atomic_store_explicit(&drv_tp_user, user, memory_order_relaxed);
+    atomic_store_explicit(&drv_tp_callback, callback, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief drv_tracepoint_name: Get the name of a tracepoint.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint.
+ *
+ * @return (const char*): NULL: Unknown id; other: Name.
+ */
+const char* drv_tracepoint_name(drv_tp_id_t id) {
+    if ((unsigned)id >= DRV_TP_COUNT) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return drv_tp_names[id];
+}
+
+/**
+ * @brief drv_tracepoint_fire: Deliver an event to the sinks of the tracepoint (used by DRV_TRACEPOINT()).
+ * Keeps errno.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint.
+ * @param (int64_t) a0: First argument.
+ * @param (int64_t) a1: Second argument.
+ */
+void drv_tracepoint_fire(drv_tp_id_t id, int64_t a0, int64_t a1) {
+    int error = errno;
+    unsigned sinks = atomic_load_explicit(&drv_tp_keys[id], memory_order_relaxed);
+    if (sinks & DRV_TP_SINK_TRACE) {
+        drv_trace_point((uint32_t)id, a0, a1);
+    }
+    if (sinks & DRV_TP_SINK_CALLBACK) {
+        drv_tp_callback_t callback = atomic_load_explicit(&drv_tp_callback, memory_order_acquire);
+        if (callback != NULL) {
+            callback(id, a0, a1, atomic_load_explicit(&drv_tp_user, memory_order_relaxed));
+        }
+    }
+    errno = error;
+}
+
+#else // DRV_TRACEPOINTS
+
+_Atomic unsigned drv_tp_keys[DRV_TP_COUNT];
+
+int drv_tracepoint_enable(drv_tp_id_t id, unsigned sinks) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+int drv_tracepoint_callback(drv_tp_callback_t callback, void* user) {
+    errno = ENOTSUP;
+    return -1;
+}
+
+const char* drv_tracepoint_name(drv_tp_id_t id) {
+    errno = ENOTSUP;
+    return NULL;
+}
+
+void drv_tracepoint_fire(drv_tp_id_t id, int64_t a0, int64_t a1) {
+}
+
+#endif // DRV_TRACEPOINTS
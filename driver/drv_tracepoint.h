@@ -0,0 +1,160 @@
+/**
+ * @file    drv_tracepoint.h
+ * @brief   Static tracepoints inside the registry and the base drivers.
+ *
+ * @details
+ * A tracepoint marks an event inside a function with up to two integer arguments:
+ *
+ *   DRV_TRACEPOINT(REGISTRY_RESIZE, old_size, new_size);
+ *
+ * Without DRV_TRACEPOINTS (CMake option DRV_TRACEPOINTS) the macro compiles to nothing;
+ * the arguments are not evaluated. With it, every tracepoint is a predicted-not-taken
+ * branch on its key, a relaxed load of drv_tp_keys[id]. drv_tracepoint_enable() sets
+ * the key and selects the sinks of the event:
+ * - DRV_TP_SINK_TRACE: A DRV_TRACE_POINT record in the trace ring of the thread
+ *   (see drv_trace.h), independent of drv_trace_enable().
+ * - DRV_TP_SINK_CALLBACK: The function set with drv_tracepoint_callback().
+ *
+ * Tracepoints (id, name, arguments):
+ * | id                   | Location                               | a0                       | a1                      |
+ * |----------------------|----------------------------------------|--------------------------|-------------------------|
+ * | REGISTRY_ADD         | registry_add_drivers()                 | Number of drivers        | 0 or errno              |
+ * | REGISTRY_REMOVE      | registry_remove_drivers()              | Number of drivers        | 0 or errno              |
+ * | REGISTRY_RESIZE      | Driver list realloc                    | Old size                 | New size                |
+ * | REGISTRY_LOOKUP      | Hash index search                      | Probed slots (scan len.) | Index or -1             |
+ * | REGISTRY_GET_BY_NAME | registry_get_driver_by_name()          | 0: mph, 1: static, 2: index | 1: Found, 0: Not found |
+ * | REGISTRY_CONTENTION  | Writer lock of a concurrent registry   | Yields until locked      | 0                       |
+ * | DYN_ARRAY_RESIZE     | dyn_array realloc                      | Old elements             | New elements            |
+ * | DYN_ARRAY_SCAN       | dyn_array_find_free_index()            | Scanned elements         | Index or -1             |
+ * | CORE_REG_DRV         | drv_core reg_drv fop                   | 0 or errno               | 0                       |
+ * | CORE_DEREG_DRV       | drv_core dereg_drv fop                 | 0 or errno               | 0                       |
+ * | CORE_OPEN            | drv_core open fop                      | 0 or errno               | 0                       |
+ * | DIO_REG_DRV          | drv_dio reg_drv fop                    | 0 or errno               | 0                       |
+ * | DIO_DEREG_DRV        | drv_dio dereg_drv fop                  | 0 or errno               | 0                       |
+ * | DIO_OPEN             | drv_dio open fop                       | 0 or errno               | 0                       |
+ *
+ * Without DRV_TRACEPOINTS the functions of this module fail with ENOTSUP.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_TRACEPOINT_H_
+#define _DRV_TRACEPOINT_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stdatomic.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_TP_SINK_TRACE       (1U << 0)   /// Record the event in the trace ring of the thread.
+#define DRV_TP_SINK_CALLBACK    (1U << 1)   /// Call the callback of drv_tracepoint_callback().
+
+// All tracepoints as X(id, name). See table above.
+#define DRV_TP_LIST(X)                                  \
+    X(REGISTRY_ADD,         "registry_add")             \
+    X(REGISTRY_REMOVE,      "registry_remove")          \
+    X(REGISTRY_RESIZE,      "registry_resize")          \
+    X(REGISTRY_LOOKUP,      "registry_lookup")          \
+    X(REGISTRY_GET_BY_NAME, "registry_get_by_name")     \
+    X(REGISTRY_CONTENTION,  "registry_contention")      \
+    X(DYN_ARRAY_RESIZE,     "dyn_array_resize")         \
+    X(DYN_ARRAY_SCAN,       "dyn_array_scan")           \
+    X(CORE_REG_DRV,         "core_reg_drv")             \
+    X(CORE_DEREG_DRV,       "core_dereg_drv")           \
+    X(CORE_OPEN,            "core_open")                \
+    X(DIO_REG_DRV,          "dio_reg_drv")              \
+    X(DIO_DEREG_DRV,        "dio_dereg_drv")            \
+    X(DIO_OPEN,             "dio_open")
+
+/*
+ * Types
+ */
+#define DRV_TP_ID(id, name) DRV_TP_##id,
+typedef enum {
+    DRV_TP_LIST(DRV_TP_ID)
+    DRV_TP_COUNT                            // Number of tracepoints. drv_tracepoint_enable(): All tracepoints.
+} drv_tp_id_t;
+#undef DRV_TP_ID
+
+/**
+ * @brief drv_tp_callback_t: Receives the events of the tracepoints with DRV_TP_SINK_CALLBACK.
+ * Called in the thread and context of the tracepoint, partly with the writer lock of a registry held:
+ * Must not call driver or registry functions.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint.
+ * @param (int64_t) a0: First argument.
+ * @param (int64_t) a1: Second argument.
+ * @param (void*) user: User pointer of drv_tracepoint_callback().
+ */
+typedef void (*drv_tp_callback_t)(drv_tp_id_t id, int64_t a0, int64_t a1, void* user);
+
+/*
+ * Global Variables
+ */
+extern _Atomic unsigned drv_tp_keys[DRV_TP_COUNT];  // Sinks per tracepoint. Use drv_tracepoint_enable().
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_tracepoint_enable: Select the sinks of a tracepoint at runtime.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint. DRV_TP_COUNT: All tracepoints.
+ * @param (unsigned) sinks: DRV_TP_SINK_* flags. 0: Disable.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_tracepoint_enable(drv_tp_id_t id, unsigned sinks);
+
+/**
+ * @brief drv_tracepoint_callback: Set the callback for DRV_TP_SINK_CALLBACK.
+ * Set it before enabling the sink; events of a concurrent change may reach the old callback.
+ *
+ * @param (drv_tp_callback_t) callback: Callback. NULL: Drop the events.
+ * @param (void*) user: Passed to the callback.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_tracepoint_callback(drv_tp_callback_t callback, void* user);
+
+/**
+ * @brief drv_tracepoint_name: Get the name of a tracepoint.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint.
+ *
+ * @return (const char*): NULL: Unknown id; other: Name.
+ */
+const char* drv_tracepoint_name(drv_tp_id_t id);
+
+/**
+ * @brief drv_tracepoint_fire: Deliver an event to the sinks of the tracepoint (used by DRV_TRACEPOINT()).
+ * Keeps errno.
+ *
+ * @param (drv_tp_id_t) id: Tracepoint.
+ * @param (int64_t) a0: First argument.
+ * @param (int64_t) a1: Second argument.
+ */
+void drv_tracepoint_fire(drv_tp_id_t id, int64_t a0, int64_t a1);
+
+// Pads the arguments of DRV_TRACEPOINT() to two.
+#define DRV_TP_ARGS(a0, a1, ...)    (int64_t)(a0), (int64_t)(a1)
+
+#ifdef DRV_TRACEPOINTS
+#define DRV_TRACEPOINT(id, ...)                                                                         \
+    do {                                                                                                \
+        if (__builtin_expect(atomic_load_explicit(&drv_tp_keys[DRV_TP_##id], memory_order_relaxed) != 0, 0)) { \
+            drv_tracepoint_fire(DRV_TP_##id, DRV_TP_ARGS(__VA_ARGS__, 0, 0));                           \
+        }                                                                                               \
+    } while (0)
+#else
+// Not evaluated, but the arguments count as used.
+#define DRV_TRACEPOINT(id, ...)     ((void)sizeof((int64_t[]){ DRV_TP_ARGS(__VA_ARGS__, 0, 0) }))
+#endif
+
+#endif //_DRV_TRACEPOINT_H_
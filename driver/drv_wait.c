@@ -0,0 +1,235 @@
+/**
+ * @file    drv_wait.c
+ * @brief   Wait queues: Sleep until a driver signals a change.
+ *
+ * @details
+ * The list of a queue is protected by a spinlock, so a zero initialized queue is valid
+ * and static driver contexts need no initialization. drv_wait_wake() signals the waiters
+ * with the spinlock held; drv_wait_remove() takes it too, so after removing its entry
+ * a waiter can be destroyed safely.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "drv_wait.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/*
+ * LOCAL Functions
+ */
+static void drv_wait_lock(drv_wait_t* queue) {
+    while (atomic_exchange_explicit(&queue->lock, true, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void drv_wait_unlock(drv_wait_t* queue) {
+    atomic_store_explicit(&queue->lock, false, memory_order_release);
+}
+
+static void drv_waiter_signal(drv_waiter_t* waiter) {
+    if (waiter->fd >= 0) {
+        // Counter of the eventfd. EAGAIN (counter full) can be ignored: It is readable anyway.
+        uint64_t one = 1;
+        int error = errno;
+        (void)!write(waiter->fd, &one, sizeof(one));
+        errno = error;
+        return;
+    }
+    pthread_mutex_lock(&waiter->lock);
+    waiter->signaled = 1;
+    pthread_cond_signal(&waiter->cond);
+    pthread_mutex_unlock(&waiter->lock);
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief drv_waiter_init: Initialize a waiter.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ * @param (int) fd: eventfd to signal. -1: Waiter is a thread (drv_waiter_sleep()).
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_waiter_init(drv_waiter_t* waiter, int fd) {
+    // Parameter check
+    if (waiter == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pthread_condattr_t attr;
+    int result = pthread_condattr_init(&attr);
+    if (result == 0) {
+        result = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        if (result == 0) {
+            result = pthread_cond_init(&waiter->cond, &attr);
+        }
+        pthread_condattr_destroy(&attr);
+    }
+    if (result != 0) {
+        errno = result;
+        return -1;
+    }
+    result = pthread_mutex_init(&waiter->lock, NULL);
+    if (result != 0) {
+        pthread_cond_destroy(&waiter->cond);
+        errno = result;
+        return -1;
+    }
+    waiter->signaled = 0;
+    waiter->fd = fd;
+    return 0;
+}
+
+/**
+ * @brief drv_waiter_destroy: Release a waiter. It must not be registered anymore.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_waiter_destroy(drv_waiter_t* waiter) {
+    if (waiter != NULL) {
+        pthread_mutex_destroy(&waiter->lock);
+        pthread_cond_destroy(&waiter->cond);
+    }
+}
+
+/**
+ * @brief drv_waiter_reset: Forget the wakes before. Check the condition afterwards.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_waiter_reset(drv_waiter_t* waiter) {
+    pthread_mutex_lock(&waiter->lock);
+    waiter->signaled = 0;
+    pthread_mutex_unlock(&waiter->lock);
+}
+
+/**
+ * @brief drv_waiter_sleep: Sleep until woken (since the last drv_waiter_reset()) or the deadline.
+ *
+ * @param (drv_waiter_t*) waiter: Thread waiter.
+ * @param (const struct timespec*) deadline: Absolute CLOCK_MONOTONIC time. NULL: No deadline.
+ *
+ * @return (int): 0: Woken, -1: Failed. For reason see errno-variable (ETIMEDOUT: Deadline passed).
+ */
+int drv_waiter_sleep(drv_waiter_t* waiter, const struct timespec* deadline) {
+    int result = 0;
+    pthread_mutex_lock(&waiter->lock);
+    while ((!waiter->signaled) && (result == 0)) {
+        result = (deadline != NULL) ? pthread_cond_timedwait(&waiter->cond, &waiter->lock, deadline)
+                                    : pthread_cond_wait(&waiter->cond, &waiter->lock);
+    }
+    int signaled = waiter->signaled;
+    pthread_mutex_unlock(&waiter->lock);
+    if (!signaled) {
+        errno = result;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief drv_wait_add: Register a waiter in a wait queue.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (drv_wait_entry_t*) entry: Registration, valid until drv_wait_remove().
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_wait_add(drv_wait_t* queue, drv_wait_entry_t* entry, drv_waiter_t* waiter) {
+    entry->waiter = waiter;
+    entry->prev = NULL;
+    drv_wait_lock(queue);
+    entry->next = queue->head;
+    if (queue->head != NULL) {
+        queue->head->prev = entry;
+    }
+    queue->head = entry;
+    drv_wait_unlock(queue);
+}
+
+/**
+ * @brief drv_wait_remove: Remove a registration. Afterwards no wake accesses entry or its waiter.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (drv_wait_entry_t*) entry: Registration of drv_wait_add().
+ */
+void drv_wait_remove(drv_wait_t* queue, drv_wait_entry_t* entry) {
+    drv_wait_lock(queue);
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        queue->head = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    }
+    drv_wait_unlock(queue);
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+/**
+ * @brief drv_wait_remove_fd: Find and remove the registration of an eventfd waiter.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (int) fd: eventfd of the waiter.
+ *
+ * @return (drv_wait_entry_t*): NULL: Not registered; other: Removed registration.
+ */
+drv_wait_entry_t* drv_wait_remove_fd(drv_wait_t* queue, int fd) {
+    if (fd < 0) {
+        return NULL;
+    }
+    drv_wait_entry_t* entry;
+    drv_wait_lock(queue);
+    for (entry = queue->head; (entry != NULL) && (entry->waiter->fd != fd); entry = entry->next);
+    drv_wait_unlock(queue);
+    // Only the owner of the eventfd removes its entry, so it can't vanish in between.
+    if (entry != NULL) {
+        drv_wait_remove(queue, entry);
+        return entry;
+    }
+    return NULL;
+}
+
+/**
+ * @brief drv_wait_wake: Wake all waiters of a wait queue. May be called from any thread.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ */
+void drv_wait_wake(drv_wait_t* queue) {
+    drv_wait_lock(queue);
+    for (drv_wait_entry_t* entry = queue->head; entry != NULL; entry = entry->next) {
+        drv_waiter_signal(entry->waiter);
+    }
+    drv_wait_unlock(queue);
+}
+
+/**
+ * @brief drv_wait_deadline: Convert a timeout into an absolute deadline for drv_waiter_sleep().
+ *
+ * @param (struct timespec*) deadline: Returns the deadline (CLOCK_MONOTONIC).
+ * @param (long) timeout_ms: Timeout [ms] from now. >= 0.
+ */
+void drv_wait_deadline(struct timespec* deadline, long timeout_ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
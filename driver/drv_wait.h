@@ -0,0 +1,127 @@
+/**
+ * @file    drv_wait.h
+ * @brief   Wait queues: Sleep until a driver signals a change.
+ *
+ * @details
+ * A wait queue (drv_wait_t, e.g. driver_ctx_t::wait) holds the entries of the waiters
+ * interested in a driver. A waiter is a sleeping thread or an eventfd. One waiter can be
+ * registered in many queues at once (see drv_poll()); drv_wait_wake() of any of them
+ * wakes it.
+ *
+ * Without lost wakeups:
+ * @code
+ * drv_wait_add(queue, &entry, &waiter);
+ * for (;;) {
+ *     drv_waiter_reset(&waiter);
+ *     if (condition) break;                   // Checked after the reset ...
+ *     drv_waiter_sleep(&waiter, deadline);    // ... so a wake in between ends the sleep at once.
+ * }
+ * drv_wait_remove(queue, &entry);
+ * @endcode
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_WAIT_H_
+#define _DRV_WAIT_H_
+
+/*
+ * INCLUDEs
+ */
+#include <pthread.h>
+#include <time.h>
+#include <driver_types.h>
+
+/*
+ * Types
+ */
+// A thread or an eventfd waiting in one or more wait queues.
+struct drv_waiter_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;                            // Uses CLOCK_MONOTONIC.
+    int signaled;                                   // true: Woken since the last drv_waiter_reset().
+    int fd;                                         // >= 0: eventfd, woken by adding 1. -1: Thread.
+};
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_waiter_init: Initialize a waiter.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ * @param (int) fd: eventfd to signal. -1: Waiter is a thread (drv_waiter_sleep()).
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_waiter_init(drv_waiter_t* waiter, int fd);
+
+/**
+ * @brief drv_waiter_destroy: Release a waiter. It must not be registered anymore.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_waiter_destroy(drv_waiter_t* waiter);
+
+/**
+ * @brief drv_waiter_reset: Forget the wakes before. Check the condition afterwards.
+ *
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_waiter_reset(drv_waiter_t* waiter);
+
+/**
+ * @brief drv_waiter_sleep: Sleep until woken (since the last drv_waiter_reset()) or the deadline.
+ *
+ * @param (drv_waiter_t*) waiter: Thread waiter.
+ * @param (const struct timespec*) deadline: Absolute CLOCK_MONOTONIC time. NULL: No deadline.
+ *
+ * @return (int): 0: Woken, -1: Failed. For reason see errno-variable (ETIMEDOUT: Deadline passed).
+ */
+int drv_waiter_sleep(drv_waiter_t* waiter, const struct timespec* deadline);
+
+/**
+ * @brief drv_wait_add: Register a waiter in a wait queue.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (drv_wait_entry_t*) entry: Registration, valid until drv_wait_remove().
+ * @param (drv_waiter_t*) waiter: Waiter.
+ */
+void drv_wait_add(drv_wait_t* queue, drv_wait_entry_t* entry, drv_waiter_t* waiter);
+
+/**
+ * @brief drv_wait_remove: Remove a registration. Afterwards no wake accesses entry or its waiter.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (drv_wait_entry_t*) entry: Registration of drv_wait_add().
+ */
+void drv_wait_remove(drv_wait_t* queue, drv_wait_entry_t* entry);
+
+/**
+ * @brief drv_wait_remove_fd: Find and remove the registration of an eventfd waiter.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ * @param (int) fd: eventfd of the waiter.
+ *
+ * @return (drv_wait_entry_t*): NULL: Not registered; other: Removed registration.
+ */
+drv_wait_entry_t* drv_wait_remove_fd(drv_wait_t* queue, int fd);
+
+/**
+ * @brief drv_wait_wake: Wake all waiters of a wait queue. May be called from any thread.
+ *
+ * @param (drv_wait_t*) queue: Wait queue.
+ */
+void drv_wait_wake(drv_wait_t* queue);
+
+/**
+ * @brief drv_wait_deadline: Convert a timeout into an absolute deadline for drv_waiter_sleep().
+ *
+ * @param (struct timespec*) deadline: Returns the deadline (CLOCK_MONOTONIC).
+ * @param (long) timeout_ms: Timeout [ms] from now. >= 0.
+ */
+void drv_wait_deadline(struct timespec* deadline, long timeout_ms);
+
+#endif //_DRV_WAIT_H_
@@ -4,7 +4,8 @@
  *
  * @details
  * This module provides a dynamic array that can store pointers.
- * If the array ist full, it will be automaticly expanded.
+ * If the array ist full, it will be automaticly expanded by a geometric factor.
+ * Each element can only be stored once. Elements are found in constant time.
  *
  * @author  Roman Buchert <roman.buchert@googlemail.com>
  * @date    2025-08-05
@@ -12,10 +13,26 @@
  */
 
 #include "dyn_array.h"
+#include "drv_tracepoint.h"
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
+static int dyn_array_resize(dyn_array_t* array, size_t elements) {
+    void** new_ptr = realloc(array->list, elements * sizeof(void*));
+    if (new_ptr == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (elements > array->elements) {
+        memset(&new_ptr[array->elements], 0, (elements - array->elements) * sizeof(void*));
+    }
+    DRV_TRACEPOINT(DYN_ARRAY_RESIZE, array->elements, elements);
+    array->list = new_ptr;
+    array->elements = elements;
+    return 0;
+}
+
 int dyn_array_add(dyn_array_t* array, void* element) {
     if ((array == NULL) || (element == NULL)) {
         errno = EINVAL;
@@ -24,14 +41,11 @@ int dyn_array_add(dyn_array_t* array, void* element) {
 
     /* Realloc, if list is full */
     if (array->used == array->elements) {
-        void** new_ptr = realloc(array->list, (array->elements + DYN_ARRAY_REALLOC_ELEMENTS) * sizeof(void*));
-        if (new_ptr == NULL) {
-            errno = ENOMEM;
+        size_t factor = (array->growth_factor < 2) ? DYN_ARRAY_GROWTH_FACTOR : array->growth_factor;
+        size_t elements = (array->elements == 0) ? DYN_ARRAY_REALLOC_ELEMENTS : array->elements * factor;
+        if (dyn_array_resize(array, elements) != 0) {
             return -1;
         }
-        memset(&new_ptr[array->elements], 0, DYN_ARRAY_REALLOC_ELEMENTS * sizeof(void*));
-        array->list = new_ptr;
-        array->elements += DYN_ARRAY_REALLOC_ELEMENTS;
     }
 
     /* Get free index */
@@ -40,11 +54,57 @@ int dyn_array_add(dyn_array_t* array, void* element) {
         return -1;
     }
 
+    /* Fails, if the element is already stored. */
+    if (ptr_index_insert(&array->index, element, index) != 0) {
+        return -1;
+    }
+
     array->list[index] = element;
     array->used++;
     return 0;
 }
 
+int dyn_array_reserve(dyn_array_t* array, size_t elements) {
+    if (array == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (elements <= array->elements) {
+        return 0;
+    }
+    return dyn_array_resize(array, elements);
+}
+
+int dyn_array_compact(dyn_array_t* array) {
+    if (array == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (array->list == NULL) {
+        return 0;
+    }
+
+    /* Move the elements down, keeping their order. Indexes of elements may change! */
+    size_t used = 0;
+    ptr_index_clear(&array->index);
+    for (size_t i = 0; i < array->elements; i++) {
+        if (array->list[i] != NULL) {
+            (void)ptr_index_insert(&array->index, array->list[i], used);   // Capacity is kept, can't fail.
+            array->list[used++] = array->list[i];
+        }
+    }
+    memset(&array->list[used], 0, (array->elements - used) * sizeof(void*));
+
+    /* Release memory. If shrinking fails, the array just keeps its size. */
+    size_t elements = (used < DYN_ARRAY_REALLOC_ELEMENTS) ? DYN_ARRAY_REALLOC_ELEMENTS : used;
+    if (elements < array->elements) {
+        (void)dyn_array_resize(array, elements);
+    }
+    return 0;
+}
+
 ssize_t dyn_array_find_free_index(dyn_array_t* array) {
     if (array == NULL) {
         errno = EINVAL;
@@ -53,9 +113,11 @@ ssize_t dyn_array_find_free_index(dyn_array_t* array) {
     
     for (size_t i = 0; i < array->elements; i++) {
         if (array->list[i] == NULL) {
+            DRV_TRACEPOINT(DYN_ARRAY_SCAN, i + 1, i);
             return i;
         }
     }
+    DRV_TRACEPOINT(DYN_ARRAY_SCAN, array->elements, -1);
     errno = ENOENT;
     return -1;
 }
@@ -66,10 +128,9 @@ ssize_t dyn_array_find_element(dyn_array_t* array, void* element) {
         return -1;
     }
 
-    for (size_t i = 0; i < array->elements; i++) {
-        if (array->list[i] == element) {
-            return i;
-        }
+    ssize_t index = ptr_index_find(&array->index, element);
+    if (index >= 0) {
+        return index;
     }
     errno = ENOENT;
     return -1;
@@ -104,6 +165,7 @@ int dyn_array_remove_element(dyn_array_t* array, void* element) {
         return -1;
     }
 
+    (void)ptr_index_remove(&array->index, element);
     array->list[index] = NULL;
     array->used--;
 
@@ -111,6 +173,7 @@ int dyn_array_remove_element(dyn_array_t* array, void* element) {
         free(array->list);
         array->list = NULL;
         array->elements = 0;
+        ptr_index_free(&array->index);
     }
     return 0;
 }
\ No newline at end of file
@@ -4,7 +4,8 @@
  *
  * @details
  * This module provides a dynamic array that can store pointers.
- * If the array ist full, it will be automaticly expanded.
+ * If the array ist full, it will be automaticly expanded by a geometric factor.
+ * Each element can only be stored once. Elements are found in constant time.
  *
  * @author  Roman Buchert <roman.buchert@googlemail.com>
  * @date    2025-08-05
@@ -15,8 +16,10 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <sys/types.h>
+#include "ptr_index.h"
 
-#define DYN_ARRAY_REALLOC_ELEMENTS (8U)
+#define DYN_ARRAY_REALLOC_ELEMENTS (8U)      /// Initial number of elements.
+#define DYN_ARRAY_GROWTH_FACTOR (2U)          /// Default factor to grow the array by, if full.
 
 typedef struct dyn_array_s dyn_array_t;
 
@@ -24,10 +27,25 @@ struct dyn_array_s {
     size_t elements;
     size_t used;
     void** list;
+    size_t growth_factor;                   // Factor to grow the array by, if full. < 2: DYN_ARRAY_GROWTH_FACTOR.
+    ptr_index_t index;                      // Index element -> index in list.
 };
 
+/**
+ * @brief dyn_array_add: Add an element to the array. If the array is full, it is expanded.
+ * An element already stored is rejected (EEXIST), it is never stored twice.
+ *
+ * @param (dyn_array_t*) array: Array to add to.
+ * @param (void*) element: Element to add. Must not be NULL.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
 int dyn_array_add(dyn_array_t* array, void* element);
 
+int dyn_array_reserve(dyn_array_t* array, size_t elements);
+
+int dyn_array_compact(dyn_array_t* array);
+
 ssize_t dyn_array_find_free_index(dyn_array_t* array);
 
 ssize_t dyn_array_find_element(dyn_array_t* array, void* element);
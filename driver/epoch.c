@@ -0,0 +1,312 @@
+/**
+ * @file    epoch.c
+ * @brief   Epoch based reclamation for lock-free readers.
+ *
+ * @details
+ * Every reader thread owns a record with the global epoch at the time it entered
+ * its critical section (0: not active). Retired data is tagged with the global epoch,
+ * then the epoch is advanced. The data can be released, if all active readers
+ * entered in a later epoch. Writers collect after retiring, and the last reader,
+ * which leaves its critical section while data is pending, collects as well.
+ * Reader records are reused after their thread has terminated.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "epoch.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*
+ * DEFINEs
+ */
+#define EPOCH_CACHE_LINE    (64U)               /// Size of a cache line.
+
+/*
+ * LOCAL Types
+ */
+// Every record has its own cache line, so readers in different threads never share one.
+typedef struct epoch_record_s {
+    _Alignas(EPOCH_CACHE_LINE) _Atomic uint64_t epoch;  // Epoch of the active critical section. 0: Not active.
+    atomic_bool in_use;                             // Record belongs to a thread.
+    size_t depth;                                   // Nesting depth of the thread.
+    struct epoch_record_s* next;                    // Next record. Records are never freed.
+} epoch_record_t;
+
+typedef struct epoch_retired_s {
+    void* ptr;                                      // Data to release.
+    void (*release)(void*);                         // Release function.
+    uint64_t epoch;                                 // Epoch, in which the data has been retired.
+    struct epoch_retired_s* next;
+} epoch_retired_t;
+
+/*
+ * LOCAL Variables
+ */
+static _Atomic uint64_t epoch_global = 1;
+static _Atomic(epoch_record_t*) epoch_records = NULL;
+static _Thread_local epoch_record_t* epoch_self = NULL;
+
+static pthread_once_t epoch_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t epoch_key;
+
+// Retired data. Only accessed by writers, which are serialized by the mutex.
+static pthread_mutex_t epoch_lock = PTHREAD_MUTEX_INITIALIZER;
+static epoch_retired_t* epoch_retired = NULL;
+static _Atomic size_t epoch_retired_count = 0;       // Changed under epoch_lock, read by epoch_exit() without it.
+static atomic_bool epoch_reclaim_again = false;     // A reader found epoch_lock held: The holder collects again.
+
+static void epoch_reclaim(void);
+
+/*
+ * LOCAL Functions
+ */
+// Thread exit: Hand the record over to the next thread. A thread terminated inside a
+// critical section must not block the reclamation, nor pass its nesting depth on.
+static void epoch_thread_exit(void* data) {
+    epoch_record_t* record = data;
+    record->depth = 0;
+    atomic_store(&record->epoch, 0);
+    atomic_store(&record->in_use, false);
+    if (atomic_load(&epoch_retired_count) != 0) {
+        epoch_reclaim();
+    }
+}
+
+static void epoch_key_create(void) {
+    (void)pthread_key_create(&epoch_key, epoch_thread_exit);
+}
+
+/**
+ * @brief epoch_acquire_record: Get a reader record for the calling thread.
+ *
+ * @return (epoch_record_t*): NULL: No memory; other: Record of the thread.
+ */
+static epoch_record_t* epoch_acquire_record(void) {
+    (void)pthread_once(&epoch_key_once, epoch_key_create);
+
+    // Reuse a record of a terminated thread.
+    epoch_record_t* record;
+    for (record = atomic_load(&epoch_records); record != NULL; record = record->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&record->in_use, &expected, true)) {
+            break;
+        }
+    }
+
+    if (record == NULL) {
+        record = aligned_alloc(EPOCH_CACHE_LINE, sizeof(epoch_record_t));
+        if (record == NULL) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        memset(record, 0, sizeof(epoch_record_t));
+        atomic_init(&record->in_use, true);
+        record->next = atomic_load(&epoch_records);
+        while (!atomic_compare_exchange_weak(&epoch_records, &record->next, record));
+    }
+
+    (void)pthread_setspecific(epoch_key, record);
+    epoch_self = record;
+    return record;
+}
+
+/**
+ * @brief epoch_min_active: Get the oldest epoch of all active readers.
+ *
+ * @param (const epoch_record_t*) skip: Record to ignore (the caller). May be NULL.
+ *
+ * @return (uint64_t): Oldest epoch. UINT64_MAX: No active reader.
+ */
+static uint64_t epoch_min_active(const epoch_record_t* skip) {
+    uint64_t min = UINT64_MAX;
+    for (epoch_record_t* record = atomic_load(&epoch_records); record != NULL; record = record->next) {
+        uint64_t epoch = atomic_load(&record->epoch);
+        if ((record != skip) && (epoch != 0) && (epoch < min)) {
+            min = epoch;
+        }
+    }
+    return min;
+}
+
+/**
+ * @brief epoch_collect: Unlink all retired data, which can't be seen by any active reader.
+ * epoch_lock must be held. The data is released by epoch_release() after unlocking, so the
+ * release functions may use the epoch API themselves.
+ *
+ * @return (epoch_retired_t*): List of data to release.
+ */
+static epoch_retired_t* epoch_collect(void) {
+    uint64_t min = epoch_min_active(NULL);
+    epoch_retired_t* ready = NULL;
+    epoch_retired_t** link = &epoch_retired;
+    while (*link != NULL) {
+        epoch_retired_t* retired = *link;
+        if (retired->epoch < min) {
+            *link = retired->next;
+            retired->next = ready;
+            ready = retired;
+            epoch_retired_count--;
+        }
+        else {
+            link = &retired->next;
+        }
+    }
+    return ready;
+}
+
+/**
+ * @brief epoch_release: Release a list of epoch_collect().
+ *
+ * @param (epoch_retired_t*) ready: List of data to release.
+ */
+static void epoch_release(epoch_retired_t* ready) {
+    while (ready != NULL) {
+        epoch_retired_t* next = ready->next;
+        ready->release(ready->ptr);
+        free(ready);
+        ready = next;
+    }
+}
+
+/**
+ * @brief epoch_reclaim: Collect and release retired data without blocking. If epoch_lock is held,
+ * the holder collects again after unlocking (see epoch_reclaim_again).
+ */
+static void epoch_reclaim(void) {
+    atomic_store(&epoch_reclaim_again, true);
+    while (atomic_load(&epoch_reclaim_again) && (pthread_mutex_trylock(&epoch_lock) == 0)) {
+        atomic_store(&epoch_reclaim_again, false);
+        epoch_retired_t* ready = epoch_collect();
+        pthread_mutex_unlock(&epoch_lock);
+        epoch_release(ready);
+    }
+}
+
+/**
+ * @brief epoch_wait: Wait until no active reader has entered in or before an epoch.
+ *
+ * @param (uint64_t) epoch: Epoch to wait for.
+ * @param (const epoch_record_t*) skip: Record to ignore (the caller). May be NULL.
+ */
+static void epoch_wait(uint64_t epoch, const epoch_record_t* skip) {
+    while (epoch_min_active(skip) <= epoch) {
+        sched_yield();
+    }
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief epoch_enter: Start a read side critical section. May be nested.
+ * The first call of a thread allocates its reader record.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int epoch_enter(void) {
+    epoch_record_t* record = epoch_self;
+    if ((record == NULL) && ((record = epoch_acquire_record()) == NULL)) {
+        return -1;
+    }
+
+    if (record->depth++ == 0) {
+        // Sequentially consistent: The writer either sees this record active or the reader sees the new data.
+        atomic_store(&record->epoch, atomic_load(&epoch_global));
+    }
+    return 0;
+}
+
+/**
+ * @brief epoch_exit: End a read side critical section.
+ * Leaving the outermost section releases the retired data, which no reader can see anymore.
+ * Never blocks: If a writer holds the lock, the writer releases it. Release functions run in the calling thread.
+ */
+void epoch_exit(void) {
+    epoch_record_t* record = epoch_self;
+    if ((record != NULL) && (record->depth > 0) && (--record->depth == 0)) {
+        // Sequentially consistent: Either the retiring writer sees this record inactive or the reader sees the data pending.
+        atomic_store(&record->epoch, 0);
+        if (atomic_load(&epoch_retired_count) != 0) {
+            epoch_reclaim();
+        }
+    }
+}
+
+/**
+ * @brief epoch_retire: Release data, as soon as no reader can access it anymore.
+ * The data must already be unreachable for new readers. Never fails: If no memory is
+ * available to defer the release, the call waits for the other active readers.
+ * May be called inside a read side critical section, if the caller doesn't access the data anymore.
+ *
+ * @param (void*) ptr: Data to release. NULL: Nothing to do.
+ * @param (void (*)(void*)) release: Function to release the data, e.g. free().
+ */
+void epoch_retire(void* ptr, void (*release)(void*)) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&epoch_lock);
+    uint64_t epoch = atomic_fetch_add(&epoch_global, 1);
+    epoch_retired_t* retired = malloc(sizeof(epoch_retired_t));
+    if (retired == NULL) {
+        // No memory to defer: Wait for the other readers, which may still see the data.
+        pthread_mutex_unlock(&epoch_lock);
+        epoch_wait(epoch, epoch_self);
+        release(ptr);
+        return;
+    }
+
+    retired->ptr = ptr;
+    retired->release = release;
+    retired->epoch = epoch;
+    retired->next = epoch_retired;
+    epoch_retired = retired;
+    epoch_retired_count++;
+    epoch_retired_t* ready = epoch_collect();
+    pthread_mutex_unlock(&epoch_lock);
+    epoch_release(ready);
+    if (atomic_load(&epoch_reclaim_again)) {
+        epoch_reclaim();
+    }
+}
+
+/**
+ * @brief epoch_synchronize: Wait until all readers, which are active now, have left
+ * their critical section and release all retired data.
+ * Must not be called inside a read side critical section.
+ */
+void epoch_synchronize(void) {
+    pthread_mutex_lock(&epoch_lock);
+    epoch_wait(atomic_fetch_add(&epoch_global, 1), NULL);
+    epoch_retired_t* ready = epoch_collect();
+    pthread_mutex_unlock(&epoch_lock);
+    epoch_release(ready);
+    if (atomic_load(&epoch_reclaim_again)) {
+        epoch_reclaim();
+    }
+}
+
+/**
+ * @brief epoch_pending: Get the number of retired, but not yet released, data.
+ *
+ * @return (size_t): Number of pending releases.
+ */
+size_t epoch_pending(void) {
+    pthread_mutex_lock(&epoch_lock);
+    size_t count = epoch_retired_count;
+    pthread_mutex_unlock(&epoch_lock);
+    return count;
+}
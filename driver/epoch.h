@@ -0,0 +1,83 @@
+/**
+ * @file    epoch.h
+ * @brief   Epoch based reclamation for lock-free readers.
+ *
+ * @details
+ * Readers enclose every access to shared, atomically published data with
+ * epoch_enter() / epoch_exit(). Readers never block and never allocate after
+ * their first call.
+ * A writer, which replaced published data, hands the old data to epoch_retire().
+ * It is released as soon as no reader, which could still see it, is active: By the
+ * next writer or by the last of those readers in its epoch_exit().
+ *
+ * Example:
+ * @code
+ * // Reader
+ * epoch_enter();
+ * data_t* data = atomic_load(&shared);
+ * ...
+ * epoch_exit();
+ *
+ * // Writer
+ * data_t* old = atomic_exchange(&shared, new_data);
+ * epoch_retire(old, free);
+ * @endcode
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _EPOCH_H_
+#define _EPOCH_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief epoch_enter: Start a read side critical section. May be nested.
+ * The first call of a thread allocates its reader record.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int epoch_enter(void);
+
+/**
+ * @brief epoch_exit: End a read side critical section.
+ * Leaving the outermost section releases the retired data, which no reader can see anymore.
+ * Never blocks: If a writer holds the lock, the writer releases it. Release functions run in the calling thread.
+ */
+void epoch_exit(void);
+
+/**
+ * @brief epoch_retire: Release data, as soon as no reader can access it anymore.
+ * The data must already be unreachable for new readers. Never fails: If no memory is
+ * available to defer the release, the call waits for the other active readers.
+ * May be called inside a read side critical section, if the caller doesn't access the data anymore.
+ *
+ * @param (void*) ptr: Data to release. NULL: Nothing to do.
+ * @param (void (*)(void*)) release: Function to release the data, e.g. free().
+ */
+void epoch_retire(void* ptr, void (*release)(void*));
+
+/**
+ * @brief epoch_synchronize: Wait until all readers, which are active now, have left
+ * their critical section and release all retired data.
+ * Must not be called inside a read side critical section.
+ */
+void epoch_synchronize(void);
+
+/**
+ * @brief epoch_pending: Get the number of retired, but not yet released, data.
+ *
+ * @return (size_t): Number of pending releases.
+ */
+size_t epoch_pending(void);
+
+#endif //_EPOCH_H_
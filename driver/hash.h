@@ -0,0 +1,150 @@
+/**
+ * @file    hash.h
+ * @brief   Hash functions for the lookup tables of the driver modules.
+ *
+ * @details
+ * This module provides small, inline hash functions which are shared by the
+ * lookup tables of the driver modules (e.g. the name index of the registry).
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _HASH_H_
+#define _HASH_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * DEFINEs
+ */
+#define HASH_FNV_OFFSET     (2166136261UL)  /// FNV-1a 32 bit offset basis.
+#define HASH_FNV_PRIME      (16777619UL)    /// FNV-1a 32 bit prime.
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief hash_str_seed: Calculate the FNV-1a hash of a zero terminated string with a given start value.
+ *
+ * @param (const char*) str: String to hash.
+ * @param (uint32_t) seed: Start value of the hash (offset basis).
+ *
+ * @return (uint32_t): Hash of the string.
+ */
+static inline uint32_t hash_str_seed(const char* str, uint32_t seed) {
+    uint32_t hash = seed;
+    while (*str != '\0') {
+        hash ^= (uint8_t)*str++;
+        hash *= HASH_FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief hash_str: Calculate the FNV-1a hash of a zero terminated string.
+ *
+ * @param (const char*) str: String to hash.
+ *
+ * @return (uint32_t): Hash of the string.
+ */
+static inline uint32_t hash_str(const char* str) {
+    return hash_str_seed(str, HASH_FNV_OFFSET);
+}
+
+/**
+ * @brief hash_str_len: Calculate the FNV-1a hash and the length of a zero terminated string in one pass.
+ *
+ * @param (const char*) str: String to hash.
+ * @param (size_t*) len: Returns the length of the string.
+ *
+ * @return (uint32_t): Hash of the string (same as hash_str()).
+ */
+static inline uint32_t hash_str_len(const char* str, size_t* len) {
+    const char* begin = str;
+    uint32_t hash = HASH_FNV_OFFSET;
+    while (*str != '\0') {
+        hash ^= (uint8_t)*str++;
+        hash *= HASH_FNV_PRIME;
+    }
+    *len = (size_t)(str - begin);
+    return hash;
+}
+
+/**
+ * @brief hash_mix: Mix the bits of a 32 bit value (finalizer of MurmurHash3).
+ *
+ * @param (uint32_t) key: Value to mix.
+ *
+ * @return (uint32_t): Mixed value.
+ */
+static inline uint32_t hash_mix(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bUL;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35UL;
+    key ^= key >> 16;
+    return key;
+}
+
+/**
+ * @brief hash_ptr: Calculate the hash of a pointer.
+ * The low bits of pointers are mostly zero (alignment), so the bits are mixed
+ * (finalizer of MurmurHash3) before the hash is used as table index.
+ *
+ * @param (const void*) ptr: Pointer to hash.
+ *
+ * @return (uint32_t): Hash of the pointer.
+ */
+static inline uint32_t hash_ptr(const void* ptr) {
+    uint64_t key = (uint64_t)(uintptr_t)ptr;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+/**
+ * @brief hash_table_backshift: Close the hole of a removed entry in a linear probing table.
+ * The following entries of the probe sequence are shifted back, so no tombstones are needed.
+ *
+ * @param (void*) table: Table (array of entries).
+ * @param (size_t) entry_size: Size of an entry [bytes].
+ * @param (size_t) mask: Number of entries of the table - 1. The number of entries is a power of 2.
+ * @param (size_t) hole: Position of the removed entry.
+ * @param (bool (*)(const void*)) used: Returns true, if an entry is used.
+ * @param (size_t (*)(const void*)) home: Returns the hash of a used entry. Its home position is hash & mask.
+ *
+ * @return (size_t): Position, which is empty afterwards. Must be cleared by the caller.
+ */
+static inline size_t hash_table_backshift(void* table, size_t entry_size, size_t mask, size_t hole,
+                                          bool (*used)(const void* entry), size_t (*home)(const void* entry)) {
+    char* entries = table;
+    size_t j = hole;
+    for (;;) {
+        j = (j + 1) & mask;
+        const void* entry = entries + j * entry_size;
+        if (!used(entry)) {
+            break;
+        }
+        size_t pos = home(entry) & mask;
+        // Entry j may only be moved to the hole, if its home position is not within (hole, j].
+        if (((j > hole) && ((pos <= hole) || (pos > j))) ||
+            ((j < hole) && ((pos <= hole) && (pos > j)))) {
+            memcpy(entries + hole * entry_size, entry, entry_size);
+            hole = j;
+        }
+    }
+    return hole;
+}
+
+#endif //_HASH_H_
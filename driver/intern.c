@@ -0,0 +1,183 @@
+/**
+ * @file    intern.c
+ * @brief   Name interning.
+ *
+ * @details
+ * Open addressing hash table (linear probing) over the interned names.
+ * Names are never removed, so no tombstones are needed.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "intern.h"
+#include "hash.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+/*
+ * LOCAL Types
+ */
+typedef struct intern_entry_s {
+    const char* str;                                // Interned name. NULL: Entry is empty.
+    uint32_t hash;                                  // Hash of the name.
+    uint32_t len;                                   // Length of the name.
+} intern_entry_t;
+
+/*
+ * LOCAL Variables
+ */
+static intern_entry_t* intern_table = NULL;
+static size_t intern_size = 0;                      // Number of entries of the table. Power of 2.
+static size_t intern_used = 0;                      // Number of interned names.
+static pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * LOCAL Functions
+ */
+/**
+ * @brief intern_grow: Double the table (or allocate the initial one) and reinsert all names.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int intern_grow(void) {
+    size_t new_size = (intern_size == 0) ? INTERN_MIN_SIZE : intern_size * 2;
+    intern_entry_t* new_table = calloc(new_size, sizeof(intern_entry_t));
+    if (new_table == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    size_t mask = new_size - 1;
+    for (size_t i = 0; i < intern_size; i++) {
+        if (intern_table[i].str == NULL) {
+            continue;
+        }
+        size_t j = intern_table[i].hash & mask;
+        while (new_table[j].str != NULL) {
+            j = (j + 1) & mask;
+        }
+        new_table[j] = intern_table[i];
+    }
+
+    free(intern_table);
+    intern_table = new_table;
+    intern_size = new_size;
+    return 0;
+}
+
+/**
+ * @brief intern_insert: Search a name and insert a copy, if not found. intern_lock must be held.
+ *
+ * @param (const char*) str: Name to intern.
+ * @param (uint32_t) str_hash: Hash of the name.
+ * @param (size_t) str_len: Length of the name.
+ *
+ * @return (const char*) NULL: Failed, for reason see errno-variable; other: Interned name.
+ */
+static const char* intern_insert(const char* str, uint32_t str_hash, size_t str_len) {
+    // Search: Hash and length are compared before the bytes.
+    size_t mask = intern_size - 1;
+    for (size_t i = str_hash & mask; (intern_table != NULL) && (intern_table[i].str != NULL); i = (i + 1) & mask) {
+        if ((intern_table[i].hash == str_hash) && (intern_table[i].len == str_len) &&
+            (memcmp(intern_table[i].str, str, str_len) == 0)) {
+            return intern_table[i].str;
+        }
+    }
+
+    // Not found: Copy and insert.
+    if ((2 * (intern_used + 1) > intern_size) && (intern_grow() != 0)) {
+        return NULL;
+    }
+    char* copy = malloc(str_len + 1);
+    if (copy == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(copy, str, str_len + 1);
+
+    mask = intern_size - 1;
+    size_t i = str_hash & mask;
+    while (intern_table[i].str != NULL) {
+        i = (i + 1) & mask;
+    }
+    intern_table[i].str = copy;
+    intern_table[i].hash = str_hash;
+    intern_table[i].len = (uint32_t)str_len;
+    intern_used++;
+    return copy;
+}
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief intern_str: Get the interned copy of a name. The name is copied on first use.
+ * If the table is filled to 50%, it will be expanded automaticly.
+ *
+ * @param (const char*) str: Name to intern.
+ * @param (uint32_t*) hash: Optional (may be NULL). Returns the hash of the name (see hash_str()).
+ * @param (uint32_t*) len: Optional (may be NULL). Returns the length of the name.
+ *
+ * @return (const char*) NULL: Failed, for reason see errno-variable; other: Interned name.
+ */
+const char* intern_str(const char* str, uint32_t* hash, uint32_t* len) {
+    // Parameter check
+    if (str == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t str_len;
+    uint32_t str_hash = hash_str_len(str, &str_len);
+    if (str_len > UINT32_MAX) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    if (hash != NULL) {
+        *hash = str_hash;
+    }
+    if (len != NULL) {
+        *len = (uint32_t)str_len;
+    }
+
+    pthread_mutex_lock(&intern_lock);
+    const char* interned = intern_insert(str, str_hash, str_len);
+    pthread_mutex_unlock(&intern_lock);
+    return interned;
+}
+
+/**
+ * @brief intern_count: Get the number of distinct interned names.
+ *
+ * @return (size_t): Number of names.
+ */
+size_t intern_count(void) {
+    pthread_mutex_lock(&intern_lock);
+    size_t count = intern_used;
+    pthread_mutex_unlock(&intern_lock);
+    return count;
+}
+
+/**
+ * @brief intern_free: Release all interned names.
+ * All pointers returned by intern_str() become invalid. Only for shutdown.
+ */
+void intern_free(void) {
+    pthread_mutex_lock(&intern_lock);
+    for (size_t i = 0; i < intern_size; i++) {
+        free((void*)intern_table[i].str);
+    }
+    free(intern_table);
+    intern_table = NULL;
+    intern_size = 0;
+    intern_used = 0;
+    pthread_mutex_unlock(&intern_lock);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file    intern.h
+ * @brief   Name interning.
+ *
+ * @details
+ * This module stores every distinct name once. Interning the same name twice
+ * returns the same pointer, so identical names across the driver tree share
+ * their storage and interned names can be compared by pointer.
+ * Length and hash of the name are calculated once, when it is interned.
+ * Interned names live until intern_free() is called. All functions are thread safe.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _INTERN_H_
+#define _INTERN_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * DEFINEs
+ */
+#define INTERN_MIN_SIZE     (32U)   /// Minimum number of entries of the table. Power of 2.
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief intern_str: Get the interned copy of a name. The name is copied on first use.
+ * If the table is filled to 50%, it will be expanded automaticly.
+ *
+ * @param (const char*) str: Name to intern.
+ * @param (uint32_t*) hash: Optional (may be NULL). Returns the hash of the name (see hash_str()).
+ * @param (uint32_t*) len: Optional (may be NULL). Returns the length of the name.
+ *
+ * @return (const char*) NULL: Failed, for reason see errno-variable; other: Interned name.
+ */
+const char* intern_str(const char* str, uint32_t* hash, uint32_t* len);
+
+/**
+ * @brief intern_count: Get the number of distinct interned names.
+ *
+ * @return (size_t): Number of names.
+ */
+size_t intern_count(void);
+
+/**
+ * @brief intern_free: Release all interned names.
+ * All pointers returned by intern_str() become invalid. Only for shutdown.
+ */
+void intern_free(void);
+
+#endif //_INTERN_H_
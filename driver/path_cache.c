@@ -0,0 +1,103 @@
+/**
+ * @file    path_cache.c
+ * @brief   Cache of resolved driver paths.
+ *
+ * @details
+ * Direct mapped cache: The hash of base driver and path selects exactly one entry.
+ * Entries are valid as long as no driver has been removed since they were stored.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "path_cache.h"
+#include "registry.h"
+#include "hash.h"
+#include <string.h>
+
+/*
+ * LOCAL Types
+ */
+typedef struct path_cache_entry_s {
+    const driver_t* base;                           // Driver the path starts at. NULL: Entry is empty.
+    driver_t* dir;                                  // Parent driver of the last path component.
+    uint32_t hash;                                  // Hash of base driver and path.
+    uint32_t generation;                            // Registry generation at the time of insertion.
+    char path[PATH_CACHE_PATH_MAX];                 // Path.
+} path_cache_entry_t;
+
+/*
+ * LOCAL Variables
+ */
+// Per thread, so concurrent lookups need no synchronization.
+static _Thread_local path_cache_entry_t path_cache[PATH_CACHE_SIZE];
+
+/*
+ * Global Functions
+ */
+
+/**
+ * @brief path_cache_hash: Calculate the hash of a path relative to a base driver.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ *
+ * @return (uint32_t): Hash.
+ */
+uint32_t path_cache_hash(const driver_t* const base_driver, const char* const path) {
+    return hash_str(path) ^ hash_ptr(base_driver);
+}
+
+/**
+ * @brief path_cache_lookup: Get the cached directory of a path.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ * @param (uint32_t) hash: Hash of the path, see path_cache_hash().
+ *
+ * @return (driver_t*): NULL: Not cached or invalid; other: Parent driver of the last path component.
+ */
+driver_t* path_cache_lookup(const driver_t* const base_driver, const char* const path, uint32_t hash) {
+    const path_cache_entry_t* entry = &path_cache[hash & (PATH_CACHE_SIZE - 1)];
+    if ((entry->base == base_driver) &&
+        (entry->hash == hash) &&
+        (entry->generation == registry_generation()) &&
+        (strcmp(entry->path, path) == 0)) {
+        return entry->dir;
+    }
+    return NULL;
+}
+
+/**
+ * @brief path_cache_insert: Store the resolved directory of a path. Replaces the entry with the same slot.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ * @param (uint32_t) hash: Hash of the path, see path_cache_hash().
+ * @param (driver_t*) dir: Parent driver of the last path component.
+ * @param (uint32_t) generation: Registry generation read before dir was resolved (see registry_generation()).
+ */
+void path_cache_insert(const driver_t* const base_driver, const char* const path, uint32_t hash, driver_t* dir, uint32_t generation) {
+    size_t len = strlen(path);
+    if (len >= PATH_CACHE_PATH_MAX) {
+        return;
+    }
+
+    path_cache_entry_t* entry = &path_cache[hash & (PATH_CACHE_SIZE - 1)];
+    entry->base = base_driver;
+    entry->dir = dir;
+    entry->hash = hash;
+    entry->generation = generation;
+    memcpy(entry->path, path, len + 1);
+}
+
+/**
+ * @brief path_cache_clear: Invalidate all entries of the calling thread.
+ */
+void path_cache_clear(void) {
+    memset(path_cache, 0, sizeof(path_cache));
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    path_cache.h
+ * @brief   Cache of resolved driver paths.
+ *
+ * @details
+ * drv_open_path() stores the resolved directory (parent of the last path component)
+ * of a path in this cache, so repeated opens of the same path need a single hash probe
+ * instead of one lookup per path component.
+ * The cache is direct mapped, statically allocated per thread and never touches the heap.
+ * Every entry stores the registry generation (see registry_generation()), so all
+ * entries become invalid, when a driver is removed from any registry.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _PATH_CACHE_H_
+#define _PATH_CACHE_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define PATH_CACHE_SIZE     (64U)       /// Number of entries. Power of 2.
+#define PATH_CACHE_PATH_MAX (64U)       /// Max. length of a cached path incl. '\0'. Longer paths are not cached.
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief path_cache_hash: Calculate the hash of a path relative to a base driver.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ *
+ * @return (uint32_t): Hash.
+ */
+uint32_t path_cache_hash(const driver_t* const base_driver, const char* const path);
+
+/**
+ * @brief path_cache_lookup: Get the cached directory of a path.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ * @param (uint32_t) hash: Hash of the path, see path_cache_hash().
+ *
+ * @return (driver_t*): NULL: Not cached or invalid; other: Parent driver of the last path component.
+ */
+driver_t* path_cache_lookup(const driver_t* const base_driver, const char* const path, uint32_t hash);
+
+/**
+ * @brief path_cache_insert: Store the resolved directory of a path. Replaces the entry with the same slot.
+ *
+ * @param (const driver_t* const) base_driver: Driver the path starts at.
+ * @param (const char* const) path: Path.
+ * @param (uint32_t) hash: Hash of the path, see path_cache_hash().
+ * @param (driver_t*) dir: Parent driver of the last path component.
+ * @param (uint32_t) generation: Registry generation read before dir was resolved (see registry_generation()).
+ */
+void path_cache_insert(const driver_t* const base_driver, const char* const path, uint32_t hash, driver_t* dir, uint32_t generation);
+
+/**
+ * @brief path_cache_clear: Invalidate all entries of the calling thread.
+ */
+void path_cache_clear(void);
+
+#endif //_PATH_CACHE_H_
@@ -18,7 +18,8 @@ typedef struct property_list_s property_list_t;
 
 typedef enum property_type_e {
     PROP_UNKNOWN,
-    PROP_LIST
+    PROP_LIST,
+    PROP_STAT                                           //Statistic value of the dispatch layer (see drv_stats.h).
 } property_type_t;
 
 struct property_s {
@@ -0,0 +1,223 @@
+/**
+ * @file    ptr_index.c
+ * @brief   Pointer to slot index.
+ *
+ * @details
+ * This module provides an open addressing hash table, which maps a pointer
+ * (e.g. a driver_t*) to the slot it is stored in. It is used by the registry
+ * and the dynamic array for constant time identity checks and removal.
+ * If the table is filled to 50%, it will be automaticly expanded.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include "ptr_index.h"
+#include "hash.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*
+ * LOCAL Prototypes
+ */
+static void ptr_index_put(ptr_index_entry_t* entries, size_t size, const void* key, size_t slot);
+static bool ptr_index_used(const void* entry);
+static size_t ptr_index_home(const void* entry);
+
+/*
+ * LOCAL Functions
+ */
+/**
+ * @brief ptr_index_put: Put a pointer into a table (linear probing). The table must have an empty entry.
+ *
+ * @param (ptr_index_entry_t*) entries: Table to put the pointer to.
+ * @param (size_t) size: Number of entries of the table.
+ * @param (const void*) key: Pointer to put.
+ * @param (size_t) slot: Slot, the pointer is stored in.
+ */
+static void ptr_index_put(ptr_index_entry_t* entries, size_t size, const void* key, size_t slot) {
+    size_t mask = size - 1;
+    size_t i = hash_ptr(key) & mask;
+    while (entries[i].key != NULL) {
+        i = (i + 1) & mask;
+    }
+    entries[i].key = key;
+    entries[i].slot = slot;
+}
+
+// Callbacks of hash_table_backshift().
+static bool ptr_index_used(const void* entry) {
+    return ((const ptr_index_entry_t*)entry)->key != NULL;
+}
+
+static size_t ptr_index_home(const void* entry) {
+    return hash_ptr(((const ptr_index_entry_t*)entry)->key);
+}
+
+/*
+ * Global Functions
+ */
+/**
+ * @brief ptr_index_reserve: Expand the table, so count pointers can be stored without reallocation.
+ *
+ * @param (ptr_index_t*) index: Index to expand.
+ * @param (size_t) count: Number of pointers to store.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+int ptr_index_reserve(ptr_index_t* index, size_t count) {
+    // Parameter check
+    if (index == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Keep the load factor at max. 50%.
+    size_t size = (index->size == 0) ? PTR_INDEX_MIN_SIZE : index->size;
+    while (size < (2 * count)) {
+        size <<= 1;
+    }
+    if (size == index->size) {
+        return 0;
+    }
+
+    ptr_index_entry_t* entries = calloc(size, sizeof(ptr_index_entry_t));
+    if (entries == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for (size_t i = 0; i < index->size; i++) {
+        if (index->entries[i].key != NULL) {
+            ptr_index_put(entries, size, index->entries[i].key, index->entries[i].slot);
+        }
+    }
+    free(index->entries);
+    index->entries = entries;
+    index->size = size;
+    return 0;
+}
+
+/**
+ * @brief ptr_index_insert: Insert a pointer into the index.
+ * If the table is filled to 50%, it will be expanded automaticly.
+ *
+ * @param (ptr_index_t*) index: Index to insert to.
+ * @param (const void*) key: Pointer to insert. Must not be NULL.
+ * @param (size_t) slot: Slot, the pointer is stored in.
+ *
+ * @return (int) 0: Success, -1: Failed (EEXIST: Pointer already in index). For reason, see errno-variable.
+ */
+int ptr_index_insert(ptr_index_t* index, const void* key, size_t slot) {
+    // Parameter check
+    if ((index == NULL) || (key == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (ptr_index_find(index, key) >= 0) {
+        errno = EEXIST;
+        return -1;
+    }
+
+    if (ptr_index_reserve(index, index->used + 1) != 0) {
+        return -1;
+    }
+
+    ptr_index_put(index->entries, index->size, key, slot);
+    index->used++;
+    return 0;
+}
+
+/**
+ * @brief ptr_index_find: Get the slot of a pointer.
+ *
+ * @param (const ptr_index_t*) index: Index to search in.
+ * @param (const void*) key: Pointer to search for.
+ *
+ * @return (ssize_t): -1: Pointer not found; other: Slot of the pointer.
+ */
+ssize_t ptr_index_find(const ptr_index_t* index, const void* key) {
+    if ((index == NULL) || (index->entries == NULL) || (key == NULL)) {
+        return -1;
+    }
+
+    size_t mask = index->size - 1;
+    for (size_t i = hash_ptr(key) & mask; index->entries[i].key != NULL; i = (i + 1) & mask) {
+        if (index->entries[i].key == key) {
+            return (ssize_t)index->entries[i].slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief ptr_index_remove: Remove a pointer from the index.
+ * The following entries of the probe sequence are shifted back, so no tombstones are needed.
+ *
+ * @param (ptr_index_t*) index: Index to remove from.
+ * @param (const void*) key: Pointer to remove.
+ *
+ * @return (int) 0: Success, -1: Failed (ENOENT: Pointer not in index). For reason, see errno-variable.
+ */
+int ptr_index_remove(ptr_index_t* index, const void* key) {
+    // Parameter check
+    if ((index == NULL) || (key == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (index->entries == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    // Search for the entry.
+    size_t mask = index->size - 1;
+    size_t i = hash_ptr(key) & mask;
+    while (index->entries[i].key != key) {
+        if (index->entries[i].key == NULL) {
+            errno = ENOENT;
+            return -1;
+        }
+        i = (i + 1) & mask;
+    }
+
+    i = hash_table_backshift(index->entries, sizeof(ptr_index_entry_t), mask, i, ptr_index_used, ptr_index_home);
+    index->entries[i].key = NULL;
+    index->entries[i].slot = 0;
+    index->used--;
+    return 0;
+}
+
+/**
+ * @brief ptr_index_clear: Remove all pointers from the index. The memory is kept.
+ *
+ * @param (ptr_index_t*) index: Index to clear.
+ */
+void ptr_index_clear(ptr_index_t* index) {
+    if ((index == NULL) || (index->entries == NULL)) {
+        return;
+    }
+    memset(index->entries, 0, index->size * sizeof(ptr_index_entry_t));
+    index->used = 0;
+}
+
+/**
+ * @brief ptr_index_free: Free the allocated table.
+ *
+ * @param (ptr_index_t*) index: Index to free.
+ */
+void ptr_index_free(ptr_index_t* index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->entries);
+    index->entries = NULL;
+    index->size = 0;
+    index->used = 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file    ptr_index.h
+ * @brief   Pointer to slot index.
+ *
+ * @details
+ * This module provides an open addressing hash table, which maps a pointer
+ * (e.g. a driver_t*) to the slot it is stored in. It is used by the registry
+ * and the dynamic array for constant time identity checks and removal.
+ * If the table is filled to 50%, it will be automaticly expanded.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _PTR_INDEX_H_
+#define _PTR_INDEX_H_
+
+/*
+ * INCLUDEs
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * DEFINEs
+ */
+#define PTR_INDEX_MIN_SIZE      (16U)   /// Minimum number of entries of the table. Power of 2.
+
+/*
+ * Types
+ */
+typedef struct ptr_index_entry_s {
+    const void* key;                                // Pointer. NULL: Entry is empty.
+    size_t slot;                                    // Slot, the pointer is stored in.
+} ptr_index_entry_t;
+
+typedef struct ptr_index_s {
+    ptr_index_entry_t* entries;                     // Hash table.
+    size_t size;                                    // Number of entries of the table. Power of 2.
+    size_t used;                                    // Number of used entries.
+} ptr_index_t;
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief ptr_index_reserve: Expand the table, so count pointers can be stored without reallocation.
+ *
+ * @param (ptr_index_t*) index: Index to expand.
+ * @param (size_t) count: Number of pointers to store.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+int ptr_index_reserve(ptr_index_t* index, size_t count);
+
+/**
+ * @brief ptr_index_insert: Insert a pointer into the index.
+ * If the table is filled to 50%, it will be expanded automaticly.
+ *
+ * @param (ptr_index_t*) index: Index to insert to.
+ * @param (const void*) key: Pointer to insert. Must not be NULL.
+ * @param (size_t) slot: Slot, the pointer is stored in.
+ *
+ * @return (int) 0: Success, -1: Failed (EEXIST: Pointer already in index). For reason, see errno-variable.
+ */
+int ptr_index_insert(ptr_index_t* index, const void* key, size_t slot);
+
+/**
+ * @brief ptr_index_find: Get the slot of a pointer.
+ *
+ * @param (const ptr_index_t*) index: Index to search in.
+ * @param (const void*) key: Pointer to search for.
+ *
+ * @return (ssize_t): -1: Pointer not found; other: Slot of the pointer.
+ */
+ssize_t ptr_index_find(const ptr_index_t* index, const void* key);
+
+/**
+ * @brief ptr_index_remove: Remove a pointer from the index.
+ *
+ * @param (ptr_index_t*) index: Index to remove from.
+ * @param (const void*) key: Pointer to remove.
+ *
+ * @return (int) 0: Success, -1: Failed (ENOENT: Pointer not in index). For reason, see errno-variable.
+ */
+int ptr_index_remove(ptr_index_t* index, const void* key);
+
+/**
+ * @brief ptr_index_clear: Remove all pointers from the index. The memory is kept.
+ *
+ * @param (ptr_index_t*) index: Index to clear.
+ */
+void ptr_index_clear(ptr_index_t* index);
+
+/**
+ * @brief ptr_index_free: Free the allocated table.
+ *
+ * @param (ptr_index_t*) index: Index to free.
+ */
+void ptr_index_free(ptr_index_t* index);
+
+#endif //_PTR_INDEX_H_
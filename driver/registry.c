@@ -20,105 +20,1025 @@
  * INCLUDEs
  */
 #include "registry.h"
+#include "hash.h"
+#include "epoch.h"
+#include "drv_tracepoint.h"
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <stdbool.h>
+#include <sched.h>
+
+/*
+ * LOCAL Prototypes
+ */
+static size_t registry_index_size_for(size_t list_size);
+static const char* registry_key(const driver_t* const driver, bool reg_name);
+static uint32_t registry_key_hash(const driver_t* const driver, bool reg_name);
+static void registry_index_insert(registry_index_entry_t* index, size_t index_size, uint32_t hash, size_t slot);
+static void registry_index_erase(registry_index_entry_t* index, size_t index_size, uint32_t hash, size_t slot);
+static bool registry_index_used(const void* entry);
+static size_t registry_index_home(const void* entry);
+static void registry_index_fill(registry_t* registry, registry_index_entry_t* name_index, registry_index_entry_t* reg_name_index, size_t index_size);
+static int registry_index_rebuild(registry_t* registry, size_t index_size);
+static int registry_resize(registry_t* registry, size_t new_size);
+static int registry_compact_to(registry_t* registry, size_t new_size);
+static int registry_prepare(registry_t* registry, size_t count);
+static int registry_insert(registry_t* registry, const driver_t* const driver);
+static void registry_unlink(registry_t* registry, ssize_t index, const driver_t* const driver);
+static void registry_erase(registry_t* registry, ssize_t index, const driver_t* const driver);
+static void registry_shrink(registry_t* registry);
+static ssize_t registry_index_find(const registry_snapshot_t* const view, const char* const key, bool reg_name);
+static const registry_snapshot_t* registry_view(const registry_t* const registry, registry_snapshot_t* local);
+static const registry_snapshot_t* registry_read_begin(const registry_t* const registry, registry_snapshot_t* local);
+static void registry_read_end(const registry_t* const registry);
+static void registry_write_lock(registry_t* registry);
+static void registry_write_unlock(registry_t* registry);
+static registry_snapshot_t* registry_snapshot_alloc(const registry_t* const registry);
+static void registry_snapshot_publish(registry_t* registry, registry_snapshot_t* snapshot);
+static int registry_publish(registry_t* registry);
+static int registry_add_locked(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors);
+static int registry_remove_locked(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors);
+static int registry_replace_locked(registry_t* registry, const driver_t* const old_driver, const driver_t* const new_driver);
+
+/*
+ * LOCAL Variables
+ */
+// Incremented on every removal of a driver. Caches of resolved drivers (e.g. path_cache) compare it to detect stale entries.
+static _Atomic uint32_t registry_generation_cntr = 0;
+
+// Snapshot of a concurrent registry, which has not been published yet.
+static const registry_snapshot_t registry_empty = { 0 };
+
+/*
+ * LOCAL Functions
+ */
+/**
+ * @brief registry_index_size_for: Get the size of the hash indexes for a list size.
+ * The indexes are kept at a load factor of max. 50%, to keep the probe sequences short.
+ *
+ * @param (size_t) list_size: Number of elements of the driver list.
+ *
+ * @return (size_t): Number of entries of each hash index. Power of 2.
+ */
+static size_t registry_index_size_for(size_t list_size) {
+    size_t index_size = REGISTRY_INDEX_MIN_SIZE;
+    while (index_size < (2 * list_size)) {
+        index_size <<= 1;
+    }
+    return index_size;
+}
+
+/**
+ * @brief registry_key: Get the key of a driver for one of the hash indexes.
+ *
+ * @param (const driver_t* const) driver: Driver to get the key from.
+ * @param (bool) reg_name: true: Registered name, false: Name of the driver.
+ *
+ * @return (const char*): NULL: Driver has no key; other: Key of the driver.
+ */
+static const char* registry_key(const driver_t* const driver, bool reg_name) {
+    if (!reg_name) {
+        return driver->name;
+    }
+    return (driver->ctx != NULL) ? driver->ctx->reg_name : NULL;
+}
+
+/**
+ * @brief registry_key_hash: Get the hash of the key of a driver.
+ * The hash of the registered name is precomputed by drv_register() and taken from the context.
+ *
+ * @param (const driver_t* const) driver: Driver to get the hash from. The key must not be NULL.
+ * @param (bool) reg_name: true: Registered name, false: Name of the driver.
+ *
+ * @return (uint32_t): Hash of the key.
+ */
+static uint32_t registry_key_hash(const driver_t* const driver, bool reg_name) {
+    if (reg_name && (driver->ctx->reg_name_len != 0)) {
+        return driver->ctx->reg_name_hash;
+    }
+    return hash_str(registry_key(driver, reg_name));
+}
+
+/**
+ * @brief registry_index_insert: Insert a list index into a hash index (linear probing).
+ * The index must have at least one empty entry.
+ *
+ * @param (registry_index_entry_t*) index: Hash index to insert to.
+ * @param (size_t) index_size: Number of entries of the hash index.
+ * @param (uint32_t) hash: Hash of the key.
+ * @param (size_t) slot: Index of the driver in the driver list.
+ */
+static void registry_index_insert(registry_index_entry_t* index, size_t index_size, uint32_t hash, size_t slot) {
+    size_t mask = index_size - 1;
+    size_t i = hash & mask;
+    while (index[i].slot != 0) {
+        i = (i + 1) & mask;
+    }
+    index[i].hash = hash;
+    index[i].slot = (uint32_t)(slot + 1);
+}
+
+/**
+ * @brief registry_index_erase: Remove a list index from a hash index.
+ * The following entries of the probe sequence are shifted back, so no tombstones are needed.
+ *
+ * @param (registry_index_entry_t*) index: Hash index to remove from.
+ * @param (size_t) index_size: Number of entries of the hash index.
+ * @param (uint32_t) hash: Hash of the key.
+ * @param (size_t) slot: Index of the driver in the driver list.
+ */
+static void registry_index_erase(registry_index_entry_t* index, size_t index_size, uint32_t hash, size_t slot) {
+    size_t mask = index_size - 1;
+    size_t i = hash & mask;
+
+    // Search for the entry.
+    while (index[i].slot != (uint32_t)(slot + 1)) {
+        if (index[i].slot == 0) {
+            // Not found at the expected position. The key was changed after registration, search whole index.
+            for (i = 0; (i < index_size) && (index[i].slot != (uint32_t)(slot + 1)); i++);
+            if (i == index_size) {
+                return;                             // Not in index.
+            }
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    i = hash_table_backshift(index, sizeof(registry_index_entry_t), mask, i, registry_index_used, registry_index_home);
+    index[i].hash = 0;
+    index[i].slot = 0;
+}
+
+// Callbacks of hash_table_backshift().
+static bool registry_index_used(const void* entry) {
+    return ((const registry_index_entry_t*)entry)->slot != 0;
+}
+
+static size_t registry_index_home(const void* entry) {
+    return ((const registry_index_entry_t*)entry)->hash;
+}
+
+/**
+ * @brief registry_index_rebuild: Reallocate both hash indexes and insert all registered drivers.
+ *
+ * @param (registry_t*) registry: Registry to rebuild the indexes of.
+ * @param (size_t) index_size: New number of entries of each hash index. Power of 2.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_index_rebuild(registry_t* registry, size_t index_size) {
+    registry_index_entry_t* name_index = calloc(index_size, sizeof(registry_index_entry_t));
+    registry_index_entry_t* reg_name_index = calloc(index_size, sizeof(registry_index_entry_t));
+    if ((name_index == NULL) || (reg_name_index == NULL)) {
+        free(name_index);
+        free(reg_name_index);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    registry_index_fill(registry, name_index, reg_name_index, index_size);
+    return 0;
+}
+
+/**
+ * @brief registry_index_fill: Insert all registered drivers into new (empty) hash indexes and replace the old ones.
+ *
+ * @param (registry_t*) registry: Registry to fill the indexes of.
+ * @param (registry_index_entry_t*) name_index: New, zeroed hash index over the names.
+ * @param (registry_index_entry_t*) reg_name_index: New, zeroed hash index over the registered names.
+ * @param (size_t) index_size: Number of entries of each new hash index. Power of 2.
+ */
+static void registry_index_fill(registry_t* registry, registry_index_entry_t* name_index, registry_index_entry_t* reg_name_index, size_t index_size) {
+    for (size_t i = 0; i < registry->driver_list_size; i++) {
+        const driver_t* driver = registry->driver_list[i];
+        if (driver == NULL) {
+            continue;
+        }
+        registry_index_insert(name_index, index_size, hash_str(driver->name), i);
+        if (registry_key(driver, true) != NULL) {
+            registry_index_insert(reg_name_index, index_size, registry_key_hash(driver, true), i);
+        }
+    }
+
+    free(registry->name_index);
+    free(registry->reg_name_index);
+    registry->name_index = name_index;
+    registry->reg_name_index = reg_name_index;
+    registry->index_size = index_size;
+}
+
+/**
+ * @brief registry_resize: Reallocate the driver list and the occupancy bitmap.
+ * When shrinking, all slots beyond new_size must be free.
+ * The hash indexes are not touched.
+ *
+ * @param (registry_t*) registry: Registry to resize.
+ * @param (size_t) new_size: New number of elements of the driver list.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_resize(registry_t* registry, size_t new_size) {
+    size_t old_size = registry->driver_list_size;
+    // Resize the occupancy bitmap first. A bitmap larger than the list is harmless, if resizing the list fails.
+    size_t words = REGISTRY_MAP_WORDS(registry->driver_list_size);
+    size_t new_words = REGISTRY_MAP_WORDS(new_size);
+    if (new_words > words) {
+        uint64_t* new_map = realloc(registry->used_map, new_words * sizeof(uint64_t));
+        if (new_map == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        memset(new_map + words, 0, (new_words - words) * sizeof(uint64_t));
+        registry->used_map = new_map;
+    }
+
+    // Same for the slot generations. New slots start above all generations ever handed out.
+    if (new_size > registry->driver_list_size) {
+        uint32_t* new_generations = realloc(registry->generations, new_size * sizeof(uint32_t));
+        if (new_generations == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        for (size_t i = registry->driver_list_size; i < new_size; i++) {
+            new_generations[i] = registry->generation_floor;
+        }
+        registry->generations = new_generations;
+    }
+
+    driver_t** new_list = realloc(registry->driver_list, new_size * sizeof(driver_t*));
+    if (new_list == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    // Clear new allocated memory.
+    if (new_size > registry->driver_list_size) {
+        memset(new_list + registry->driver_list_size, 0, (new_size - registry->driver_list_size) * sizeof(driver_t*));
+    }
+    registry->driver_list = new_list;
+    registry->driver_list_size = new_size;
+    DRV_TRACEPOINT(REGISTRY_RESIZE, old_size, new_size);
+
+    // Release the generations beyond the shrunken list. Handles of these slots must stay stale.
+    if (new_size < old_size) {
+        for (size_t i = new_size; i < old_size; i++) {
+            if (registry->generations[i] > registry->generation_floor) {
+                registry->generation_floor = registry->generations[i];
+            }
+        }
+        uint32_t* new_generations = realloc(registry->generations, new_size * sizeof(uint32_t));
+        if ((new_generations != NULL) || (new_size == 0)) {
+            registry->generations = new_generations;
+        }
+    }
+
+    // Release the bitmap words beyond the shrunken list.
+    if (new_words < words) {
+        uint64_t* new_map = realloc(registry->used_map, new_words * sizeof(uint64_t));
+        if (new_map != NULL) {
+            registry->used_map = new_map;
+        }
+        if (registry->free_hint > new_words) {
+            registry->free_hint = new_words;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief registry_compact_to: Move all registered drivers to the beginning of the list and shrink it.
+ * The order of the drivers is kept. The indexes of the drivers change!
+ *
+ * @param (registry_t*) registry: Registry to compact.
+ * @param (size_t) new_size: New number of elements of the driver list. Must be >= driver_list_used.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_compact_to(registry_t* registry, size_t new_size) {
+    // Allocate the new hash indexes first, so a failing allocation leaves the registry untouched.
+    size_t index_size = registry_index_size_for(new_size);
+    registry_index_entry_t* name_index = calloc(index_size, sizeof(registry_index_entry_t));
+    registry_index_entry_t* reg_name_index = calloc(index_size, sizeof(registry_index_entry_t));
+    if ((name_index == NULL) || (reg_name_index == NULL)) {
+        free(name_index);
+        free(reg_name_index);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // Move the drivers down. The pointer index keeps its capacity, so reinserting can't fail.
+    size_t used = 0;
+    ptr_index_clear(&registry->driver_index);
+    for (size_t i = 0; i < registry->driver_list_size; i++) {
+        if (registry->driver_list[i] != NULL) {
+            (void)ptr_index_insert(&registry->driver_index, registry->driver_list[i], used);
+            if (i != used) {
+                registry->generations[i]++;         // Handles of the old slot become stale.
+            }
+            registry->driver_list[used++] = registry->driver_list[i];
+        }
+    }
+    memset(registry->driver_list + used, 0, (registry->driver_list_size - used) * sizeof(driver_t*));
+
+    // Rebuild the occupancy bitmap.
+    memset(registry->used_map, 0, REGISTRY_MAP_WORDS(registry->driver_list_size) * sizeof(uint64_t));
+    for (size_t w = 0; w < used / REGISTRY_MAP_BITS; w++) {
+        registry->used_map[w] = UINT64_MAX;
+    }
+    if (used % REGISTRY_MAP_BITS) {
+        registry->used_map[used / REGISTRY_MAP_BITS] = (1ULL << (used % REGISTRY_MAP_BITS)) - 1;
+    }
+    registry->free_hint = used / REGISTRY_MAP_BITS;
+
+    // Release memory. If shrinking fails, the list just keeps its size.
+    (void)registry_resize(registry, new_size);
+
+    registry_index_fill(registry, name_index, reg_name_index, index_size);
+    return 0;
+}
+
+/**
+ * @brief registry_index_find: Search a driver by one of the hash indexes.
+ *
+ * @param (const registry_snapshot_t* const) view: Lookup data of the registry, see registry_read_begin().
+ * @param (const char* const) key: Name or registered name of the driver.
+ * @param (bool) reg_name: true: Search by registered name, false: Search by name.
+ *
+ * @return (ssize_t): -1: Driver not found; other: Index of the driver
+ */
+static ssize_t registry_index_find(const registry_snapshot_t* const view, const char* const key, bool reg_name) {
+    const registry_index_entry_t* index = reg_name ? view->reg_name_index : view->name_index;
+    if (index == NULL) {
+        return -1;
+    }
+
+    size_t len;
+    uint32_t hash = hash_str_len(key, &len);
+    size_t mask = view->index_size - 1;
+    ssize_t found = -1;
+    size_t i;
+    for (i = hash & mask; index[i].slot != 0; i = (i + 1) & mask) {
+        if (index[i].hash != hash) {
+            continue;
+        }
+        size_t slot = index[i].slot - 1;
+        const driver_t* driver = view->driver_list[slot];
+        const char* driver_key = (driver != NULL) ? registry_key(driver, reg_name) : NULL;
+        if (driver_key == NULL) {
+            continue;
+        }
+        // Interned registered names: Same pointer is a match, different length is none.
+        if (driver_key == key) {
+            found = (ssize_t)slot;
+            break;
+        }
+        if (reg_name && (driver->ctx->reg_name_len != 0)) {
+            if ((driver->ctx->reg_name_len == len) && (memcmp(driver_key, key, len) == 0)) {
+                found = (ssize_t)slot;
+                break;
+            }
+            continue;
+        }
+        if (strcmp(driver_key, key) == 0) {
+            found = (ssize_t)slot;
+            break;
+        }
+    }
+    // Scan length: Probed slots incl. the last one.
+    DRV_TRACEPOINT(REGISTRY_LOOKUP, ((i - (hash & mask)) & mask) + 1, found);
+    return found;
+}
+
+/**
+ * @brief registry_view: Get the lookup data of the registry itself (not the published snapshot).
+ *
+ * @param (const registry_t* const) registry: Registry.
+ * @param (registry_snapshot_t*) local: Storage for the view.
+ *
+ * @return (const registry_snapshot_t*): local.
+ */
+static const registry_snapshot_t* registry_view(const registry_t* const registry, registry_snapshot_t* local) {
+    local->driver_list = registry->driver_list;
+    local->driver_list_size = registry->driver_list_size;
+    local->generations = registry->generations;
+    local->name_index = registry->name_index;
+    local->reg_name_index = registry->reg_name_index;
+    local->index_size = registry->index_size;
+    local->driver_index = registry->driver_index;
+    return local;
+}
+
+/**
+ * @brief registry_read_begin: Get the lookup data of a registry for a reader.
+ * Concurrent mode: Enters an epoch and returns the published snapshot. The snapshot
+ * stays valid until registry_read_end(). Otherwise: The data of the registry itself.
+ *
+ * @param (const registry_t* const) registry: Registry to read.
+ * @param (registry_snapshot_t*) local: Storage for the view of a non concurrent registry.
+ *
+ * @return (const registry_snapshot_t*): NULL: Failed, for reason see errno-variable; other: Lookup data.
+ */
+static const registry_snapshot_t* registry_read_begin(const registry_t* const registry, registry_snapshot_t* local) {
+    if (registry->policy.concurrent) {
+        if (epoch_enter() != 0) {
+            return NULL;
+        }
+        const registry_snapshot_t* snapshot = atomic_load(&((registry_t*)registry)->snapshot);
+        return (snapshot != NULL) ? snapshot : &registry_empty;
+    }
+
+    return registry_view(registry, local);
+}
+
+/**
+ * @brief registry_read_end: Release the lookup data of registry_read_begin().
+ *
+ * @param (const registry_t* const) registry: Registry read.
+ */
+static void registry_read_end(const registry_t* const registry) {
+    if (registry->policy.concurrent) {
+        epoch_exit();
+    }
+}
+
+/**
+ * @brief registry_write_lock: Serialize the writers of a concurrent registry. Readers are not blocked.
+ *
+ * @param (registry_t*) registry: Registry to lock.
+ */
+static void registry_write_lock(registry_t* registry) {
+    if (registry->policy.concurrent) {
+        size_t yields = 0;
+        while (atomic_exchange_explicit(&registry->writer_lock, true, memory_order_acquire)) {
+            sched_yield();
+            yields++;
+        }
+        if (yields != 0) {
+            DRV_TRACEPOINT(REGISTRY_CONTENTION, yields);
+        }
+    }
+}
+
+/**
+ * @brief registry_write_unlock: Release the writer lock of a concurrent registry.
+ *
+ * @param (registry_t*) registry: Registry to unlock.
+ */
+static void registry_write_unlock(registry_t* registry) {
+    if (registry->policy.concurrent) {
+        atomic_store_explicit(&registry->writer_lock, false, memory_order_release);
+    }
+}
+
+/**
+ * @brief registry_snapshot_alloc: Allocate a snapshot for the current sizes of the lookup data.
+ *
+ * @param (const registry_t* const) registry: Registry to allocate the snapshot for.
+ *
+ * @return (registry_snapshot_t*): NULL: Failed, for reason see errno-variable; other: Snapshot, see registry_snapshot_publish().
+ */
+static registry_snapshot_t* registry_snapshot_alloc(const registry_t* const registry) {
+    // One block: Header, driver list, pointer index, name index, registered name index, generations.
+    size_t list_bytes = registry->driver_list_size * sizeof(driver_t*);
+    size_t ptr_bytes = registry->driver_index.size * sizeof(ptr_index_entry_t);
+    size_t index_bytes = registry->index_size * sizeof(registry_index_entry_t);
+    size_t generation_bytes = registry->driver_list_size * sizeof(uint32_t);
+    registry_snapshot_t* snapshot = malloc(sizeof(registry_snapshot_t) + list_bytes + ptr_bytes + 2 * index_bytes + generation_bytes);
+    if (snapshot == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief registry_snapshot_publish: Copy the lookup data of a concurrent registry into a snapshot and publish it.
+ * The old snapshot is released, when no reader uses it anymore.
+ *
+ * @param (registry_t*) registry: Registry to publish. Writer lock must be held.
+ * @param (registry_snapshot_t*) snapshot: Snapshot of registry_snapshot_alloc(). The sizes of the lookup data must not have changed since.
+ */
+static void registry_snapshot_publish(registry_t* registry, registry_snapshot_t* snapshot) {
+    size_t list_bytes = registry->driver_list_size * sizeof(driver_t*);
+    size_t ptr_bytes = registry->driver_index.size * sizeof(ptr_index_entry_t);
+    size_t index_bytes = registry->index_size * sizeof(registry_index_entry_t);
+    size_t generation_bytes = registry->driver_list_size * sizeof(uint32_t);
+
+    char* data = (char*)(snapshot + 1);
+    snapshot->driver_list = (registry->driver_list != NULL) ? memcpy(data, registry->driver_list, list_bytes) : NULL;
+    snapshot->driver_list_size = registry->driver_list_size;
+    data += list_bytes;
+    snapshot->driver_index = registry->driver_index;
+    snapshot->driver_index.entries = (registry->driver_index.entries != NULL) ? memcpy(data, registry->driver_index.entries, ptr_bytes) : NULL;
+    data += ptr_bytes;
+    snapshot->name_index = (registry->name_index != NULL) ? memcpy(data, registry->name_index, index_bytes) : NULL;
+    data += index_bytes;
+    snapshot->reg_name_index = (registry->reg_name_index != NULL) ? memcpy(data, registry->reg_name_index, index_bytes) : NULL;
+    snapshot->index_size = registry->index_size;
+    data += index_bytes;
+    snapshot->generations = (registry->generations != NULL) ? memcpy(data, registry->generations, generation_bytes) : NULL;
+
+    epoch_retire(atomic_exchange(&registry->snapshot, snapshot), free);
+}
+
+/**
+ * @brief registry_publish: Copy the lookup data of a concurrent registry into a new snapshot and publish it.
+ * Nothing to do in non concurrent mode.
+ *
+ * @param (registry_t*) registry: Registry to publish. Writer lock must be held.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_publish(registry_t* registry) {
+    if (!registry->policy.concurrent) {
+        return 0;
+    }
+
+    registry_snapshot_t* snapshot = registry_snapshot_alloc(registry);
+    if (snapshot == NULL) {
+        return -1;
+    }
+    registry_snapshot_publish(registry, snapshot);
+    return 0;
+}
+
+/**
+ * @brief registry_prepare: Check the registry and make space for a number of drivers.
+ * Afterwards count drivers can be inserted without any allocation.
+ *
+ * @param (registry_t*) registry: Registry to prepare.
+ * @param (size_t) count: Number of drivers to be inserted.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_prepare(registry_t* registry, size_t count) {
+    // Konsistenz check.
+    if (((registry->driver_list == NULL) != (registry->driver_list_size == 0)) ||
+        ((registry->used_map == NULL) != (registry->driver_list_size == 0)) ||
+        ((registry->generations == NULL) != (registry->driver_list_size == 0)) ||
+        (registry->driver_list_used > registry->driver_list_size)) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    // The list grows geometrically, so registering N drivers costs O(log N) reallocs.
+    if (registry->driver_list_size - registry->driver_list_used < count) {
+        size_t factor = (registry->policy.growth_factor < 2) ? REGISTRY_GROWTH_FACTOR : registry->policy.growth_factor;
+        size_t new_size = (registry->driver_list_size == 0) ? REGISTRY_EXPAND_SIZE : registry->driver_list_size * factor;
+        while (new_size - registry->driver_list_used < count) {
+            new_size *= factor;
+        }
+        if (registry_resize(registry, new_size) != 0) {
+            return -1;
+        }
+    }
+
+    // Resize the hash indexes, if the driver list has grown.
+    if (registry->index_size < registry_index_size_for(registry->driver_list_size)) {
+        if (registry_index_rebuild(registry, registry_index_size_for(registry->driver_list_size)) != 0) {
+            return -1;
+        }
+    }
+
+    // Expand the pointer index, so inserting the drivers can't fail later.
+    return ptr_index_reserve(&registry->driver_index, registry->driver_list_used + count);
+}
+
+/**
+ * @brief registry_insert: Insert a driver into a prepared registry.
+ * A driver will only be inserted, if neither a driver with the same registered name
+ * nor the same driver_t* is registered.
+ *
+ * @param (registry_t*) registry: Registry with space for the driver (see registry_prepare()).
+ * @param (const driver_t* const) driver: Driver to be inserted.
+ *
+ * @return (int) 0: Success, -1: Failed (EEXIST). For reason, see errno-variable.
+ */
+static int registry_insert(registry_t* registry, const driver_t* const driver) {
+    // Doublication check, also against the link-time registered drivers.
+    const char* reg_name = registry_key(driver, true);
+    registry_snapshot_t view;
+    if (((reg_name != NULL) && (registry_index_find(registry_view(registry, &view), reg_name, true) != -1)) ||
+        (ptr_index_find(&registry->driver_index, driver) != -1) ||
+        ((reg_name != NULL) && (drv_static_find_by_reg_name(registry->static_list, registry->static_count, reg_name) != NULL)) ||
+        (drv_static_contains(registry->static_list, registry->static_count, driver))) {
+        errno = EEXIST;
+        return -1;
+    }
+
+    /*
+     * Get free index.
+     * Since the registry is prepared, there is a free space in the list.
+     */
+    ssize_t free_index = registry_get_free_index(registry);
+    registry->driver_list[free_index] = (driver_t*)driver;
+    registry->driver_list_used++;
+    registry->used_map[free_index / REGISTRY_MAP_BITS] |= (1ULL << (free_index % REGISTRY_MAP_BITS));
+    registry->free_hint = free_index / REGISTRY_MAP_BITS;   // All words below are full.
+    (void)ptr_index_insert(&registry->driver_index, driver, free_index);
+
+    // Update the hash indexes.
+    registry_index_insert(registry->name_index, registry->index_size, hash_str(driver->name), free_index);
+    if (reg_name != NULL) {
+        registry_index_insert(registry->reg_name_index, registry->index_size, registry_key_hash(driver, true), free_index);
+    }
+    return 0;
+}
+
+/**
+ * @brief registry_unlink: Remove a driver from the list and all indexes. The list is not compacted.
+ * Slot generations and the removal generation are kept: Only for drivers, which have never been
+ * visible outside of the registry (rollback).
+ *
+ * @param (registry_t*) registry: Registry to remove the driver from.
+ * @param (ssize_t) index: Index of the driver in the list.
+ * @param (const driver_t* const) driver: Driver to be removed.
+ */
+static void registry_unlink(registry_t* registry, ssize_t index, const driver_t* const driver) {
+    // Remove the driver from the hash indexes.
+    (void)ptr_index_remove(&registry->driver_index, driver);
+    registry_index_erase(registry->name_index, registry->index_size, hash_str(driver->name), index);
+    const char* reg_name = registry_key(driver, true);
+    if (reg_name != NULL) {
+        registry_index_erase(registry->reg_name_index, registry->index_size, registry_key_hash(driver, true), index);
+    }
+
+    // Remove the driver from the list.
+    registry->driver_list[index] = NULL;
+    registry->driver_list_used--;           //Since the driver is only removed if it has been registered, this ensures that "driver_list_used" is always > 0.
+    registry->used_map[index / REGISTRY_MAP_BITS] &= ~(1ULL << (index % REGISTRY_MAP_BITS));
+    if ((size_t)index / REGISTRY_MAP_BITS < registry->free_hint) {
+        registry->free_hint = index / REGISTRY_MAP_BITS;
+    }
+}
+
+/**
+ * @brief registry_erase: Remove a driver from the list and all indexes. The list is not compacted.
+ * Handles of the slot and cached lookups become stale.
+ *
+ * @param (registry_t*) registry: Registry to remove the driver from.
+ * @param (ssize_t) index: Index of the driver in the list.
+ * @param (const driver_t* const) driver: Driver to be removed.
+ */
+static void registry_erase(registry_t* registry, ssize_t index, const driver_t* const driver) {
+    // Invalidate all cached lookups.
+    registry_generation_cntr++;
+
+    registry_unlink(registry, index, driver);
+    registry->generations[index]++;
+
+    // Lock-free readers may still see the driver: Its release must wait for their epoch (see drv_deregister()).
+    if (registry->policy.concurrent && (driver->ctx != NULL)) {
+        atomic_store(&driver->ctx->epoch_release, true);
+    }
+}
+
+/**
+ * @brief registry_shrink: Compact the registry after mass deregistration, if the indexes don't need to be stable.
+ *
+ * @param (registry_t*) registry: Registry to shrink.
+ */
+static void registry_shrink(registry_t* registry) {
+    size_t ratio = (registry->policy.shrink_ratio < 2) ? REGISTRY_SHRINK_RATIO : registry->policy.shrink_ratio;
+    if ((!registry->policy.stable_index) && (!registry->policy.concurrent) &&
+        (registry->driver_list_size >= REGISTRY_SHRINK_MIN_SIZE) &&
+        (registry->driver_list_used * ratio <= registry->driver_list_size)) {
+        size_t factor = (registry->policy.growth_factor < 2) ? REGISTRY_GROWTH_FACTOR : registry->policy.growth_factor;
+        size_t new_size = registry->driver_list_used * factor;
+        (void)registry_compact_to(registry, (new_size < REGISTRY_EXPAND_SIZE) ? REGISTRY_EXPAND_SIZE : new_size);
+    }
+}
 
 /*
  * Global Functions
  */
 /**
- * @brief registry_add_driver: Add a driver to the list.
- * If the list is empty or full, it will be expanded automaticly.
- * It also checks, if the driver is already in the list and revode adding it.
- * 
- * A driver will only be registered, if
- * * A driver with the same registered name
- * * A driver with the same driver_t* driver
- * does not exist
+ * @brief registry_add_driver: Add a driver to the list.
+ * If the list is empty or full, it will be expanded automaticly.
+ * It also checks, if the driver is already in the list and revode adding it.
+ * 
+ * A driver will only be registered, if
+ * * A driver with the same registered name
+ * * A driver with the same driver_t* driver
+ * does not exist
+ *
+ * @param (registry_t*) registry: List, to add the driver to.
+ * @param (const driver_t* const) driver: Driver to be added.
+ * 
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+int registry_add_driver(registry_t* registry, const driver_t* const driver) {
+    // Parameter check
+    if ((registry == NULL) || (driver == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return registry_add_drivers(registry, &driver, 1, NULL);
+}
+
+/**
+ * @brief registry_add_locked: Add drivers to the list. See registry_add_drivers().
+ * Writer lock must be held.
+ *
+ * @param (registry_t*) registry: List, to add the drivers to.
+ * @param (const driver_t* const[]) drivers: Drivers to be added.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ */
+static int registry_add_locked(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors) {
+    /*
+     * Resize / initialize the drivers list, if neccessary.
+     * It makes it much easier to allocate memory first and then check whether the driver is already registered.
+     * The overhead of increasing the list size even though the driver isn't registered is negligible.
+     */
+    if (registry_prepare(registry, count) != 0) {
+        return -1;
+    }
+
+    // Add all drivers in one pass. Duplicates within the batch are found, since the drivers before are already added.
+    int first_error = 0;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        int result = 0;
+        if (drivers[i] == NULL) {
+            result = EINVAL;
+        }
+        else if (registry_insert(registry, drivers[i]) != 0) {
+            result = errno;
+        }
+        if (errors != NULL) {
+            errors[i] = result;
+        }
+        if (result != 0) {
+            if (first_error == 0) {
+                first_error = result;
+            }
+            if (errors == NULL) {
+                break;                              // No report requested, stop at the first error.
+            }
+        }
+    }
+
+    if (first_error == 0) {
+        return 0;
+    }
+
+    // Roll back. With report, all drivers without error were added. Without, all drivers before the failed one.
+    // They have never been visible, so handles and cached lookups stay valid.
+    for (size_t j = 0; j < i; j++) {
+        if ((errors != NULL) && (errors[j] != 0)) {
+            continue;
+        }
+        registry_unlink(registry, ptr_index_find(&registry->driver_index, drivers[j]), drivers[j]);
+        if (errors != NULL) {
+            errors[j] = ECANCELED;
+        }
+    }
+    errno = first_error;
+    return -1;
+}
+
+/**
+ * @brief registry_add_drivers: Add several drivers to the list at once.
+ * The space for all drivers is reserved once. Each driver is checked against the registry
+ * and the drivers before it in the batch. Either all drivers are added, or none.
+ *
+ * @param (registry_t*) registry: List, to add the drivers to.
+ * @param (const driver_t* const[]) drivers: Drivers to be added.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result: 0: Added,
+ *      ECANCELED: Valid, but not added because of another driver, other: errno of the driver.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable (Error of the first failed driver).
+ */
+int registry_add_drivers(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors) {
+    // Parameter check
+    if ((registry == NULL) || ((drivers == NULL) && (count > 0))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    registry_write_lock(registry);
+    int result = registry_add_locked(registry, drivers, count, errors);
+    if ((result == 0) && (registry_publish(registry) != 0)) {
+        // Readers can't see the drivers, so don't register them. They have never been visible.
+        for (size_t i = 0; i < count; i++) {
+            registry_unlink(registry, ptr_index_find(&registry->driver_index, drivers[i]), drivers[i]);
+            if (errors != NULL) {
+                errors[i] = ENOMEM;
+            }
+        }
+        errno = ENOMEM;
+        result = -1;
+    }
+    registry_write_unlock(registry);
+    DRV_TRACEPOINT(REGISTRY_ADD, count, (result == 0) ? 0 : errno);
+    return result;
+}
+
+/**
+ * @brief registry_remove_driver: Remove a driver from the list.
+ * If only a small part of a large list is used afterwards, the list is compacted
+ * automatically, unless the registry policy requests stable indexes.
+ *
+ * @param (registry_t*) registry: List, to remove the driver from.
+ * @param (const driver_t* const) driver: Driver to be removed.
+ * 
+ * @return (int) 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_remove_driver(registry_t* registry, const driver_t* const driver) {
+    // Parameter check
+    if ((registry == NULL) || (driver == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Link-time registered drivers can't be removed.
+    if (drv_static_contains(registry->static_list, registry->static_count, driver)) {
+        errno = EPERM;
+        return -1;
+    }
+
+    return registry_remove_drivers(registry, &driver, 1, NULL);
+}
+
+/**
+ * @brief registry_remove_locked: Remove drivers from the list. See registry_remove_drivers().
+ * Writer lock must be held.
+ *
+ * @param (registry_t*) registry: List, to remove the drivers from.
+ * @param (const driver_t* const[]) drivers: Drivers to be removed.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason see errno-variable.
+ */
+static int registry_remove_locked(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors) {
+    // Check all drivers first. Drivers listed twice are found with a temporary pointer index (not needed for one).
+    ptr_index_t batch = { 0 };
+    if ((count > 1) && (ptr_index_reserve(&batch, count) != 0)) {
+        return -1;
+    }
+    int first_error = 0;
+    for (size_t i = 0; i < count; i++) {
+        int result = 0;
+        if (drivers[i] == NULL) {
+            result = EINVAL;
+        }
+        else if (drv_static_contains(registry->static_list, registry->static_count, drivers[i])) {
+            result = EPERM;
+        }
+        else if (ptr_index_find(&registry->driver_index, drivers[i]) < 0) {
+            result = ENOENT;
+        }
+        else if ((count > 1) && (ptr_index_insert(&batch, drivers[i], i) != 0)) {
+            result = errno;                         // EEXIST: Listed twice.
+        }
+        if ((result != 0) && (first_error == 0)) {
+            first_error = result;
+        }
+        if (errors != NULL) {
+            errors[i] = result;
+        }
+    }
+    ptr_index_free(&batch);
+
+    if (first_error != 0) {
+        for (size_t i = 0; (errors != NULL) && (i < count); i++) {
+            if (errors[i] == 0) {
+                errors[i] = ECANCELED;
+            }
+        }
+        errno = first_error;
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        registry_erase(registry, ptr_index_find(&registry->driver_index, drivers[i]), drivers[i]);
+    }
+    registry_shrink(registry);
+    return 0;
+}
+
+
+/**
+ * @brief registry_remove_drivers: Remove several drivers from the list at once.
+ * Either all drivers are removed, or none. The list is compacted at most once afterwards.
  *
- * @param (registry_t*) registry: List, to add the driver to.
- * @param (const driver_t* const) driver: Driver to be added.
- * 
- * @return (int) 0: Success, -1: Failed. For reason, see errno-variable.
+ * @param (registry_t*) registry: List, to remove the drivers from.
+ * @param (const driver_t* const[]) drivers: Drivers to be removed.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result: 0: Removed,
+ *      ECANCELED: Valid, but not removed because of another driver, other: errno of the driver.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason see errno-variable (Error of the first failed driver).
  */
-int registry_add_driver(registry_t* registry, const driver_t* const driver) {
+int registry_remove_drivers(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors) {
     // Parameter check
-    if ((registry == NULL) || (driver == NULL)) {
+    if ((registry == NULL) || ((drivers == NULL) && (count > 0))) {
         errno = EINVAL;
         return -1;
     }
 
-    // Konsistenz check.
-    if (((registry->driver_list == NULL) != (registry->driver_list_size == 0)) ||
-        (registry->driver_list_used > registry->driver_list_size)) {
-        errno = EFAULT;
-        return -1;
+    registry_write_lock(registry);
+    // Concurrent mode: Allocate the snapshot first. Removing keeps the sizes (stable indexes), so
+    // publishing can't fail afterwards and the drivers never have to be put back.
+    registry_snapshot_t* snapshot = NULL;
+    int result = 0;
+    if (registry->policy.concurrent && ((snapshot = registry_snapshot_alloc(registry)) == NULL)) {
+        for (size_t i = 0; (errors != NULL) && (i < count); i++) {
+            errors[i] = ENOMEM;
+        }
+        result = -1;
     }
-
-    /*
-     * Resize / initialize the drivers list, if neccessary.
-     * It makes it much easier to allocate memory first and then check whether the driver is already registered.
-     * The overhead of increasing the list size even though the driver isn't registered is negligible.
-     */
-    if (registry->driver_list_size == registry->driver_list_used) {
-        size_t new_size = registry->driver_list_size + REGISTRY_EXPAND_SIZE;
-        driver_t** new_list = realloc(registry->driver_list, new_size * sizeof(driver_t*));
-        if (new_list == NULL) {
-            errno = ENOMEM;
-            return -1;
+    if (result == 0) {
+        result = registry_remove_locked(registry, drivers, count, errors);
+        if (snapshot != NULL) {
+            if (result == 0) {
+                registry_snapshot_publish(registry, snapshot);
+            } else {
+                free(snapshot);
+            }
         }
-        // Clear new allocated memory.
-        memset(new_list + registry->driver_list_size, 0, (new_size - registry->driver_list_size) * sizeof(driver_t*));
-        registry->driver_list = new_list;
-        registry->driver_list_size = new_size;
+    }
+    registry_write_unlock(registry);
+    DRV_TRACEPOINT(REGISTRY_REMOVE, count, (result == 0) ? 0 : errno);
+    return result;
+}
+
+/**
+ * @brief registry_replace_locked: Replace a driver. See registry_replace_driver(). Writer lock must be held.
+ *
+ * @param (registry_t*) registry: List, in which the driver is replaced.
+ * @param (const driver_t* const) old_driver: Registered driver.
+ * @param (const driver_t* const) new_driver: Driver, which takes its place.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason see errno-variable.
+ */
+static int registry_replace_locked(registry_t* registry, const driver_t* const old_driver, const driver_t* const new_driver) {
+    if (drv_static_contains(registry->static_list, registry->static_count, old_driver)) {
+        errno = EPERM;
+        return -1;
+    }
+    if (ptr_index_find(&registry->driver_index, old_driver) < 0) {
+        errno = ENOENT;
+        return -1;
     }
 
-    // Doublication check
-    if ((registry_get_index_by_reg_name(registry, driver->ctx->reg_name) != -1) ||
-        (registry_get_index_by_driver(registry, driver) != -1)) {
+    // Check the new driver first: It may only share its registered name with the old one.
+    const char* reg_name = registry_key(new_driver, true);
+    registry_snapshot_t view;
+    ssize_t owner = (reg_name != NULL) ? registry_index_find(registry_view(registry, &view), reg_name, true) : -1;
+    if (((owner != -1) && (registry->driver_list[owner] != old_driver)) ||
+        (ptr_index_find(&registry->driver_index, new_driver) != -1) ||
+        ((reg_name != NULL) && (drv_static_find_by_reg_name(registry->static_list, registry->static_count, reg_name) != NULL)) ||
+        (drv_static_contains(registry->static_list, registry->static_count, new_driver))) {
         errno = EEXIST;
         return -1;
     }
 
-    /*
-     * Get free index.
-     * Since we previously checked whether the list was full and expanded it if necessary,
-     * we ensure that there is a free space in the list.
-     */
-    ssize_t free_index = registry_get_free_index(registry);
-    registry->driver_list[free_index] = (driver_t*)driver;
-    registry->driver_list_used++;
+    // Allocate everything first, so the swap can't fail halfway.
+    if (registry_prepare(registry, 1) != 0) {
+        return -1;
+    }
+    registry_snapshot_t* snapshot = NULL;
+    if (registry->policy.concurrent && ((snapshot = registry_snapshot_alloc(registry)) == NULL)) {
+        return -1;
+    }
+
+    registry_erase(registry, ptr_index_find(&registry->driver_index, old_driver), old_driver);
+    (void)registry_insert(registry, new_driver);
+    if (snapshot != NULL) {
+        registry_snapshot_publish(registry, snapshot);
+    }
     return 0;
 }
 
 /**
- * @brief registry_remove_driver: Remove a driver from the list.
- * 
+ * @brief registry_replace_driver: Replace a registered driver by another one in one step.
+ * Lookups find either the old or the new driver, never none. Handles and cached lookups of the
+ * old driver become stale, as after registry_remove_driver().
  *
- * @param (registry_t*) registry: List, to remove the driver from.
- * @param (const driver_t* const) driver: Driver to be removed.
- * 
- * @return (int) 0: Success, -1: Failed. For reason see errno-variable.
+ * @param (registry_t*) registry: List, in which the driver is replaced.
+ * @param (const driver_t* const) old_driver: Registered driver to be removed.
+ * @param (const driver_t* const) new_driver: Driver to be added. Its registered name may equal the one of old_driver.
+ *
+ * @return (int) 0: Success, -1: Failed, nothing changed. For reason see errno-variable.
  */
-int registry_remove_driver(registry_t* registry, const driver_t* const driver) {
+int registry_replace_driver(registry_t* registry, const driver_t* const old_driver, const driver_t* const new_driver) {
     // Parameter check
-    if ((registry == NULL) || (driver == NULL)) {
+    if ((registry == NULL) || (old_driver == NULL) || (new_driver == NULL) || (old_driver == new_driver)) {
         errno = EINVAL;
         return -1;
     }
 
-    // Search for driver
-    ssize_t index = registry_get_index_by_driver(registry, driver);
-    if (index < 0) {
-        errno = ENOENT;
-        return -1;
-    }
-
-    // Remove the driver from the list.
-    registry->driver_list[index] = NULL;
-    registry->driver_list_used--;           //Since the driver is only removed if it has been registered, this ensures that "driver_list_used" is always > 0.
-    return 0;
+    registry_write_lock(registry);
+    int result = registry_replace_locked(registry, old_driver, new_driver);
+    registry_write_unlock(registry);
+    return result;
 }
 
 /**
@@ -142,6 +1062,15 @@ int registry_free_registry(registry_t* registry) {
         return -1;
     }
 
+    // Free slot generations. Keep the floor, so handles of a reused registry stay stale.
+    for (size_t i = 0; i < registry->driver_list_size; i++) {
+        if (registry->generations[i] > registry->generation_floor) {
+            registry->generation_floor = registry->generations[i];
+        }
+    }
+    free(registry->generations);
+    registry->generations = NULL;
+
     // Free driver list.
     // TODO: Should we handle, if it is already freed? Is this even possible?
     if (registry->driver_list != NULL) {
@@ -150,9 +1079,174 @@ int registry_free_registry(registry_t* registry) {
         registry->driver_list_size = 0;
     }
 
+    // Free pointer index.
+    ptr_index_free(&registry->driver_index);
+
+    // Free occupancy bitmap.
+    free(registry->used_map);
+    registry->used_map = NULL;
+    registry->free_hint = 0;
+
+    // Free hash indexes.
+    free(registry->name_index);
+    free(registry->reg_name_index);
+    registry->name_index = NULL;
+    registry->reg_name_index = NULL;
+    registry->index_size = 0;
+
+    // Free the snapshot of the readers, as soon as no reader uses it.
+    if (registry->policy.concurrent) {
+        epoch_retire(atomic_exchange(&registry->snapshot, NULL), free);
+        epoch_synchronize();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief registry_reserve: Reserve space for a number of drivers.
+ * Afterwards at least size drivers can be stored without reallocation.
+ *
+ * @param (registry_t*) registry: Registry to reserve the space in.
+ * @param (size_t) size: Number of drivers, the registry must be able to store.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_reserve(registry_t* registry, size_t size) {
+    // Parameter check
+    if (registry == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    registry_write_lock(registry);
+    int result = 0;
+    if (size > registry->driver_list_size) {
+        result = ((registry_resize(registry, size) != 0) ||
+                  (registry_index_rebuild(registry, registry_index_size_for(registry->driver_list_size)) != 0) ||
+                  (registry_publish(registry) != 0)) ? -1 : 0;
+    }
+    registry_write_unlock(registry);
+    return result;
+}
+
+/**
+ * @brief registry_compact: Move all drivers to the beginning of the list and release unused memory.
+ * The order of the drivers is kept, but their indexes may change.
+ * Not possible, if the registry policy requests stable indexes.
+ *
+ * @param (registry_t*) registry: Registry to compact.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_compact(registry_t* registry) {
+    // Parameter check
+    if (registry == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (registry->policy.stable_index) {
+        errno = EPERM;
+        return -1;
+    }
+
+    // Nothing allocated, nothing to compact.
+    if (registry->driver_list == NULL) {
+        return 0;
+    }
+
+    return registry_compact_to(registry, (registry->driver_list_used < REGISTRY_EXPAND_SIZE) ? REGISTRY_EXPAND_SIZE : registry->driver_list_used);
+}
+
+/**
+ * @brief registry_make_concurrent: Switch a registry to concurrent mode.
+ * Afterwards lookups may run in any number of threads in parallel to registration and
+ * deregistration. Lookups are lock-free: They read an atomically published snapshot of the
+ * lookup data, which is released by epoch based reclamation (see epoch.h).
+ * Writers are serialized by a spinlock and copy the snapshot on every change.
+ * The indexes of the drivers are stable (no compaction).
+ * Must be called, before the registry is shared between threads. Can't be undone.
+ *
+ * @param (registry_t*) registry: Registry to switch.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_make_concurrent(registry_t* registry) {
+    // Parameter check
+    if (registry == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (registry->policy.concurrent) {
+        return 0;
+    }
+
+    registry_policy_t policy = registry->policy;
+    registry->policy.stable_index = true;
+    registry->policy.concurrent = true;
+    if (registry_publish(registry) != 0) {
+        registry->policy = policy;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief registry_attach_static: Attach the link-time registered drivers of a parent to its registry.
+ * No heap allocation. The static drivers are found by the registry_get_driver_by_* functions,
+ * but have no index in the driver list and can't be removed.
+ *
+ * @param (registry_t*) registry: Registry of the parent driver.
+ * @param (const driver_t* const) parent: Parent driver, the registry belongs to.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_attach_static(registry_t* registry, const driver_t* const parent) {
+    // Parameter check
+    if ((registry == NULL) || (parent == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    registry->static_count = drv_static_get(parent, &registry->static_list);
+    registry->static_attached = true;
+    return 0;
+}
+
+/**
+ * @brief registry_attach_mph: Attach a build-time generated perfect hash table of the static driver names.
+ * The table is consulted first by registry_get_driver_by_name(). Call after registry_attach_static().
+ * No heap allocation.
+ *
+ * @param (registry_t*) registry: Registry of the parent driver.
+ * @param (const drv_mph_table_t*) mph: Generated table (see drv_mph.h).
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_attach_mph(registry_t* registry, const drv_mph_table_t* mph) {
+    // Parameter check
+    if ((registry == NULL) || (mph == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    drv_mph_bind(mph, registry->static_list, registry->static_count);
+    registry->mph = mph;
     return 0;
 }
 
+/**
+ * @brief registry_generation: Get the removal generation of all registries.
+ * The value changes on every removal of a driver, so cached lookups can be checked for validity.
+ *
+ * @return (uint32_t): Current generation.
+ */
+uint32_t registry_generation(void) {
+    return registry_generation_cntr;
+}
+
 /**
  * @brief registry_get_driver_by_name: Get driver handle by name.
  * 
@@ -162,17 +1256,32 @@ int registry_free_registry(registry_t* registry) {
  * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
  */
 driver_t* registry_get_driver_by_name(const registry_t* const registry, const char* const name) {
-    for(size_t i = 0; i < registry->driver_list_size; i++) {
-        if (registry->driver_list[i] == NULL) {
-            continue;
-        }
-        if ((strlen(registry->driver_list[i]->name) == strlen(name)) &&
-            (strcmp(registry->driver_list[i]->name, name) == 0)) {
-                return registry->driver_list[i];
-        }
+    driver_t* driver = drv_mph_find(registry->mph, name);
+    if (driver != NULL) {
+        DRV_TRACEPOINT(REGISTRY_GET_BY_NAME, 0, 1);
+        return driver;
     }
-    errno = ENOENT;
-    return NULL;
+
+    driver = drv_static_find_by_name(registry->static_list, registry->static_count, name);
+    if (driver != NULL) {
+        DRV_TRACEPOINT(REGISTRY_GET_BY_NAME, 1, 1);
+        return driver;
+    }
+
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return NULL;
+    }
+    ssize_t index = registry_index_find(view, name, false);
+    driver = (index >= 0) ? view->driver_list[index] : NULL;
+    registry_read_end(registry);
+    DRV_TRACEPOINT(REGISTRY_GET_BY_NAME, 2, driver != NULL);
+
+    if (driver == NULL) {
+        errno = ENOENT;
+    }
+    return driver;
 }
 
 /**
@@ -184,17 +1293,24 @@ driver_t* registry_get_driver_by_name(const registry_t* const registry, const ch
  * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
  */
 driver_t* registry_get_driver_by_reg_name(const registry_t* const registry, const char* const reg_name) {
-    for(size_t i = 0; i < registry->driver_list_size; i++) {
-        if ((registry->driver_list[i] == NULL) ||(registry->driver_list[i]->ctx == NULL)) {
-            continue;
-        }
-        if ((strlen(registry->driver_list[i]->ctx->reg_name) == strlen(reg_name)) &&
-            (strcmp(registry->driver_list[i]->ctx->reg_name, reg_name) == 0)) {
-                return registry->driver_list[i];
-        }
+    driver_t* driver = drv_static_find_by_reg_name(registry->static_list, registry->static_count, reg_name);
+    if (driver != NULL) {
+        return driver;
     }
-    errno = ENOENT;
-    return NULL;
+
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return NULL;
+    }
+    ssize_t index = registry_index_find(view, reg_name, true);
+    driver = (index >= 0) ? view->driver_list[index] : NULL;
+    registry_read_end(registry);
+
+    if (driver == NULL) {
+        errno = ENOENT;
+    }
+    return driver;
 }
 
 /**
@@ -206,11 +1322,19 @@ driver_t* registry_get_driver_by_reg_name(const registry_t* const registry, cons
  * @return (driver_t*): NULL: Driver not found; other: handle to the requested driver.
  */
 driver_t* registry_get_driver_by_index(const registry_t* const registry, size_t index) {
-    if (index < registry->driver_list_size) {
-        return registry->driver_list[index];
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return NULL;
     }
-    errno = ENOENT;
-    return NULL;
+    bool valid = (index < view->driver_list_size);
+    driver_t* driver = valid ? view->driver_list[index] : NULL;
+    registry_read_end(registry);
+
+    if (!valid) {
+        errno = ENOENT;
+    }
+    return driver;
 }
 
 /**
@@ -222,15 +1346,16 @@ driver_t* registry_get_driver_by_index(const registry_t* const registry, size_t
  * @return (ssize_t): -1: Driver not found; other: Index of the driver
  */
 ssize_t registry_get_index_by_name(const registry_t* const registry, const char* const name) {
-    ssize_t i;
-    for (i = 0; i < registry->driver_list_size; i++) {
-        if (registry->driver_list[i] == NULL) {
-            continue;
-        }
-        if ((strlen(registry->driver_list[i]->name) == strlen(name)) &&
-            (strcmp(registry->driver_list[i]->name, name) == 0)) {
-                return i;
-        }
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return -1;
+    }
+    ssize_t index = registry_index_find(view, name, false);
+    registry_read_end(registry);
+
+    if (index >= 0) {
+        return index;
     }
     errno = ENOENT;
     return -1;
@@ -245,19 +1370,21 @@ ssize_t registry_get_index_by_name(const registry_t* const registry, const char*
  * @return (ssize_t): -1: Driver not found; other: Index of the driver
  */
 ssize_t registry_get_index_by_reg_name(const registry_t* const registry, const char* const reg_name) {
-    ssize_t i;
-    if (registry->driver_list == NULL) {
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return -1;
+    }
+    bool empty = (view->driver_list == NULL);
+    ssize_t index = empty ? -1 : registry_index_find(view, reg_name, true);
+    registry_read_end(registry);
+
+    if (empty) {
         errno = EINVAL;
         return -1;
     }
-    for (i = 0; i < registry->driver_list_size; i++) {
-        if ((registry->driver_list[i] == NULL) || (registry->driver_list[i]->ctx == NULL)) {
-            continue;
-        }
-        if ((strlen(registry->driver_list[i]->ctx->reg_name) == strlen(reg_name)) &&
-            (strcmp(registry->driver_list[i]->ctx->reg_name, reg_name) == 0)) {
-                return i;
-        }
+    if (index >= 0) {
+        return index;
     }
     errno = ENOENT;
     return -1;
@@ -265,6 +1392,7 @@ ssize_t registry_get_index_by_reg_name(const registry_t* const registry, const c
 
 /**
  * @brief registry_get_index_by_driver: Get the index of the driver by the drivers handle.
+ * Constant time lookup in the pointer index of the registry.
  * 
  * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
  * @param (const driver_t* const) name: Name of the driver to get.
@@ -272,22 +1400,96 @@ ssize_t registry_get_index_by_reg_name(const registry_t* const registry, const c
  * @return (ssize_t): -1: Driver not found; other: Index of the driver
  */
 ssize_t registry_get_index_by_driver(const registry_t* const registry, const driver_t* const driver) {
-    ssize_t i;
-    if (registry->driver_list == NULL) {
-        errno = EINVAL;
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
         return -1;
     }
+    bool empty = (view->driver_list == NULL);
+    ssize_t index = empty ? -1 : ptr_index_find(&view->driver_index, driver);
+    registry_read_end(registry);
 
-    for (i = 0; i < registry->driver_list_size; i++) {
-        if (registry->driver_list[i] == driver) {
-            return i;
-        }
+    if (empty) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (index >= 0) {
+        return index;
     }
 
     errno = EEXIST;
     return -1;
 }
 
+/**
+ * @brief registry_get_handle: Get the handle of a registered driver.
+ * Constant time lookup in the pointer index of the registry. Link-time registered
+ * drivers have no index and therefore no handle.
+ *
+ * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
+ * @param (const driver_t* const) driver: Driver to get the handle of.
+ * @param (registry_handle_t*) handle: Returns the handle.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_get_handle(const registry_t* const registry, const driver_t* const driver, registry_handle_t* handle) {
+    // Parameter check
+    if ((registry == NULL) || (driver == NULL) || (handle == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return -1;
+    }
+    ssize_t index = (view->driver_list == NULL) ? -1 : ptr_index_find(&view->driver_index, driver);
+    if (index >= 0) {
+        handle->index = (uint32_t)index;
+        handle->generation = view->generations[index];
+    }
+    registry_read_end(registry);
+
+    if (index < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief registry_get_driver_by_handle: Get the driver of a handle.
+ * One array load and one compare: Fails with ESTALE, if the driver of the handle
+ * has been removed (or moved by compaction) since the handle was issued.
+ *
+ * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
+ * @param (registry_handle_t) handle: Handle, see registry_get_handle().
+ *
+ * @return (driver_t*): NULL: Handle is stale or invalid; other: Driver of the handle.
+ */
+driver_t* registry_get_driver_by_handle(const registry_t* const registry, registry_handle_t handle) {
+    // Parameter check
+    if (registry == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    registry_snapshot_t local;
+    const registry_snapshot_t* view = registry_read_begin(registry, &local);
+    if (view == NULL) {
+        return NULL;
+    }
+    driver_t* driver = ((handle.index < view->driver_list_size) && (view->generations[handle.index] == handle.generation)) ?
+                       view->driver_list[handle.index] : NULL;
+    registry_read_end(registry);
+
+    if (driver == NULL) {
+        errno = ESTALE;
+    }
+    return driver;
+}
+
 /**
  * @brief registry_get_free_index: Search for a free index in the drivers storage list.
  * 
@@ -300,9 +1502,16 @@ ssize_t registry_get_free_index(const registry_t* const registry) {
         errno = EINVAL;
         return -1;
     }
-    for(size_t i = 0; i < registry->driver_list_size; i++) {
-        if (registry->driver_list[i] == NULL) {
-            return i;
+    // All words below free_hint are full.
+    size_t words = REGISTRY_MAP_WORDS(registry->driver_list_size);
+    for (size_t w = registry->free_hint; w < words; w++) {
+        uint64_t free_bits = ~registry->used_map[w];
+        if (free_bits != 0) {
+            size_t index = w * REGISTRY_MAP_BITS + (size_t)__builtin_ctzll(free_bits);
+            if (index < registry->driver_list_size) {
+                return index;
+            }
+            break;                                  // Free bits beyond the end of the list.
         }
     }
     errno = ENOSPC;
@@ -323,14 +1532,7 @@ ssize_t registry_get_space(const registry_t* const registry) {
         return -1;
     }
 
-    ssize_t space = 0;
-    for (size_t i = 0; i < registry->driver_list_size; i++) {
-        if (registry->driver_list[i] == NULL) {
-            space++;
-        }
-    }
-
-    return space;
+    return (ssize_t)(registry->driver_list_size - registry->driver_list_used);
 }
 
 /**
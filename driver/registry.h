@@ -6,6 +6,8 @@
  * This module provides shared logic for adding, removing and querying
  * (sub)drivers in dynamic driver hierarchies.
  * It supports dynamic allocation and index-based lookup.
+ * Lookups by name and registered name use open addressing hash indexes,
+ * which are maintained by registry_add_driver() and registry_remove_driver().
  *
  * @warning
  * Parameters are not validated internally. Callers must ensure correctness!
@@ -30,7 +32,14 @@
 /*
  * DEFINEs
  */
-#define REGISTRY_EXPAND_SIZE    (8U)    /// Expand registry by this size, if necessary.
+#define REGISTRY_EXPAND_SIZE    (8U)    /// Initial size of the registry.
+#define REGISTRY_GROWTH_FACTOR  (2U)    /// Default factor to grow the registry by, if full.
+#define REGISTRY_SHRINK_RATIO   (4U)    /// Default ratio size/used, at which a registry is compacted automatically.
+#define REGISTRY_SHRINK_MIN_SIZE (64U)  /// Registries smaller than this are never compacted automatically.
+#define REGISTRY_INDEX_MIN_SIZE (16U)   /// Minimum number of entries of the name hash indexes. Power of 2.
+#define REGISTRY_MAP_BITS       (64U)   /// Number of slots per word of the occupancy bitmap.
+
+#define REGISTRY_MAP_WORDS(size) (((size) + REGISTRY_MAP_BITS - 1) / REGISTRY_MAP_BITS) /// Number of bitmap words for a list size.
 
 /*
  * Global Prototypes
@@ -50,7 +59,8 @@ int registry_add_driver(registry_t* registry, const driver_t* const driver);
 
 /**
  * @brief registry_remove_driver: Remove a driver from the list.
- * 
+ * If only a small part of a large list is used afterwards, the list is compacted
+ * automatically, unless the registry policy requests stable indexes.
  *
  * @param (registry_t*) registry: List, to remove the driver from.
  * @param (const driver_t* const) driver: Driver to be removed.
@@ -59,6 +69,48 @@ int registry_add_driver(registry_t* registry, const driver_t* const driver);
  */
 int registry_remove_driver(registry_t* registry, const driver_t* const driver);
 
+/**
+ * @brief registry_add_drivers: Add several drivers to the list at once.
+ * The space for all drivers is reserved once. Each driver is checked against the registry
+ * and the drivers before it in the batch. Either all drivers are added, or none.
+ *
+ * @param (registry_t*) registry: List, to add the drivers to.
+ * @param (const driver_t* const[]) drivers: Drivers to be added.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result: 0: Added,
+ *      ECANCELED: Valid, but not added because of another driver, other: errno of the driver.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason, see errno-variable (Error of the first failed driver).
+ */
+int registry_add_drivers(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors);
+
+/**
+ * @brief registry_remove_drivers: Remove several drivers from the list at once.
+ * Either all drivers are removed, or none. The list is compacted at most once afterwards.
+ *
+ * @param (registry_t*) registry: List, to remove the drivers from.
+ * @param (const driver_t* const[]) drivers: Drivers to be removed.
+ * @param (size_t) count: Number of drivers.
+ * @param (int*) errors: Optional (may be NULL). Per driver result: 0: Removed,
+ *      ECANCELED: Valid, but not removed because of another driver, other: errno of the driver.
+ *
+ * @return (int) 0: Success, -1: Failed. For reason see errno-variable (Error of the first failed driver).
+ */
+int registry_remove_drivers(registry_t* registry, const driver_t* const drivers[], size_t count, int* errors);
+
+/**
+ * @brief registry_replace_driver: Replace a registered driver by another one in one step.
+ * Lookups find either the old or the new driver, never none. Handles and cached lookups of the
+ * old driver become stale, as after registry_remove_driver().
+ *
+ * @param (registry_t*) registry: List, in which the driver is replaced.
+ * @param (const driver_t* const) old_driver: Registered driver to be removed.
+ * @param (const driver_t* const) new_driver: Driver to be added. Its registered name may equal the one of old_driver.
+ *
+ * @return (int) 0: Success, -1: Failed, nothing changed. For reason see errno-variable.
+ */
+int registry_replace_driver(registry_t* registry, const driver_t* const old_driver, const driver_t* const new_driver);
+
 /**
  * @brief registry_free_registry: Free the allocated registry.
  * Will only be freed, if empty (All entries in list are nullpointer).
@@ -69,6 +121,75 @@ int registry_remove_driver(registry_t* registry, const driver_t* const driver);
  */
 int registry_free_registry(registry_t* registry);
 
+/**
+ * @brief registry_reserve: Reserve space for a number of drivers.
+ * Afterwards at least size drivers can be stored without reallocation.
+ *
+ * @param (registry_t*) registry: Registry to reserve the space in.
+ * @param (size_t) size: Number of drivers, the registry must be able to store.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_reserve(registry_t* registry, size_t size);
+
+/**
+ * @brief registry_compact: Move all drivers to the beginning of the list and release unused memory.
+ * The order of the drivers is kept, but their indexes may change.
+ * Not possible, if the registry policy requests stable indexes.
+ *
+ * @param (registry_t*) registry: Registry to compact.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_compact(registry_t* registry);
+
+/**
+ * @brief registry_make_concurrent: Switch a registry to concurrent mode.
+ * Afterwards lookups may run in any number of threads in parallel to registration and
+ * deregistration. Lookups are lock-free: They read an atomically published snapshot of the
+ * lookup data, which is released by epoch based reclamation (see epoch.h).
+ * Writers are serialized by a spinlock and copy the snapshot on every change.
+ * The indexes of the drivers are stable (no compaction).
+ * Must be called, before the registry is shared between threads. Can't be undone.
+ *
+ * @param (registry_t*) registry: Registry to switch.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_make_concurrent(registry_t* registry);
+
+/**
+ * @brief registry_attach_static: Attach the link-time registered drivers of a parent to its registry.
+ * No heap allocation. The static drivers are found by the registry_get_driver_by_* functions,
+ * but have no index in the driver list and can't be removed.
+ *
+ * @param (registry_t*) registry: Registry of the parent driver.
+ * @param (const driver_t* const) parent: Parent driver, the registry belongs to.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_attach_static(registry_t* registry, const driver_t* const parent);
+
+/**
+ * @brief registry_attach_mph: Attach a build-time generated perfect hash table of the static driver names.
+ * The table is consulted first by registry_get_driver_by_name(). Call after registry_attach_static().
+ * No heap allocation.
+ *
+ * @param (registry_t*) registry: Registry of the parent driver.
+ * @param (const drv_mph_table_t*) mph: Generated table (see drv_mph.h).
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_attach_mph(registry_t* registry, const drv_mph_table_t* mph);
+
+/**
+ * @brief registry_generation: Get the removal generation of all registries.
+ * The value changes on every removal of a driver, so cached lookups can be checked for validity.
+ *
+ * @return (uint32_t): Current generation.
+ */
+uint32_t registry_generation(void);
+
 /**
  * @brief registry_get_driver_by_name: Get driver handle by name.
  * 
@@ -121,6 +242,7 @@ ssize_t registry_get_index_by_reg_name(const registry_t* const registry, const c
 
 /**
  * @brief registry_get_index_by_driver: Get the index of the driver by the drivers handle.
+ * Constant time lookup in the pointer index of the registry.
  * 
  * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
  * @param (const driver_t* const) name: Name of the driver to get.
@@ -129,8 +251,34 @@ ssize_t registry_get_index_by_reg_name(const registry_t* const registry, const c
  */
 ssize_t registry_get_index_by_driver(const registry_t* const registry, const driver_t* const driver);
 
+/**
+ * @brief registry_get_handle: Get the handle of a registered driver.
+ * Constant time lookup in the pointer index of the registry. Link-time registered
+ * drivers have no index and therefore no handle.
+ *
+ * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
+ * @param (const driver_t* const) driver: Driver to get the handle of.
+ * @param (registry_handle_t*) handle: Returns the handle.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int registry_get_handle(const registry_t* const registry, const driver_t* const driver, registry_handle_t* handle);
+
+/**
+ * @brief registry_get_driver_by_handle: Get the driver of a handle.
+ * One array load and one compare: Fails with ESTALE, if the driver of the handle
+ * has been removed (or moved by compaction) since the handle was issued.
+ *
+ * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
+ * @param (registry_handle_t) handle: Handle, see registry_get_handle().
+ *
+ * @return (driver_t*): NULL: Handle is stale or invalid; other: Driver of the handle.
+ */
+driver_t* registry_get_driver_by_handle(const registry_t* const registry, registry_handle_t handle);
+
 /**
  * @brief registry_get_free_index: Search for a free index in the drivers storage list.
+ * Returns the lowest free index. The occupancy bitmap is scanned a word (64 slots) at a time.
  * 
  * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
  * 
@@ -140,6 +288,7 @@ ssize_t registry_get_free_index(const registry_t* const registry);
 
 /**
  * @brief regsitry_get_space: Return the number of free elements.
+ * Constant time, the number of used elements is tracked by the registry.
  * 
  * @param (const registry_t* const) registry: Pointer to struct, where the drivers are stored in.
  * 
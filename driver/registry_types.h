@@ -11,13 +11,75 @@
  */
 #ifndef _REGISTRY_TYPES_H_
 #define _REGISTRY_TYPES_H_
+#include <stdbool.h>
+#include <stdatomic.h>
 #include "driver_types.h"
+#include "ptr_index.h"
+#include "drv_static.h"
+#include "drv_mph.h"
+
+/*
+ * Entry of the open addressing hash indexes of the registry.
+ */
+typedef struct registry_index_entry_s {
+    uint32_t hash;                                  // Hash of the key (name or registered name).
+    uint32_t slot;                                  // Index in driver_list + 1. 0: Entry is empty.
+} registry_index_entry_t;
+
+/*
+ * Handle of a registered driver: Slot in the driver list and generation of the slot.
+ * The generation of a slot changes, whenever its driver is removed or moved, so a handle
+ * of a removed driver never matches again (see registry_get_driver_by_handle()).
+ */
+typedef struct registry_handle_s {
+    uint32_t index;                                 // Index in driver_list.
+    uint32_t generation;                            // Generation of the slot at the time the handle was issued.
+} registry_handle_t;
+
+/*
+ * Growth and shrink policy of a registry. All zero: Defaults.
+ */
+typedef struct registry_policy_s {
+    uint8_t growth_factor;                          // Factor to grow the driver list by, if full. < 2: REGISTRY_GROWTH_FACTOR.
+    uint8_t shrink_ratio;                           // Compact, if size >= ratio * used. < 2: REGISTRY_SHRINK_RATIO.
+    bool stable_index;                              // true: The index of a registered driver never changes (no compaction).
+    bool concurrent;                                // true: Lock-free readers, see registry_make_concurrent(). Implies stable_index.
+} registry_policy_t;
+
+/*
+ * Read-only copy of the lookup data of a registry, published atomically in concurrent mode.
+ * Allocated as one block, released by epoch based reclamation (see epoch.h).
+ */
+typedef struct registry_snapshot_s {
+    driver_t** driver_list;
+    size_t driver_list_size;
+    uint32_t* generations;                          // Generation of every slot of driver_list.
+    registry_index_entry_t* name_index;             // Hash index over driver_t::name.
+    registry_index_entry_t* reg_name_index;         // Hash index over driver_ctx_t::reg_name.
+    size_t index_size;                              // Number of entries of each hash index. Power of 2.
+    ptr_index_t driver_index;                       // Index driver_t* -> index in driver_list.
+} registry_snapshot_t;
 
 typedef struct registry_s {
     driver_t** driver_list;
     size_t driver_list_size;
     size_t driver_list_used;
+    uint32_t* generations;                          // Generation of every slot of driver_list. Incremented, when the slot is vacated.
+    uint32_t generation_floor;                      // Generation of new slots. Above the generations of all released slots.
+    registry_index_entry_t* name_index;             // Hash index over driver_t::name.
+    registry_index_entry_t* reg_name_index;         // Hash index over driver_ctx_t::reg_name.
+    size_t index_size;                              // Number of entries of each hash index. Power of 2.
+    uint64_t* used_map;                             // Occupancy bitmap of driver_list. Bit set: Slot is used.
+    size_t free_hint;                               // Lowest word of used_map, which may contain a free slot.
+    ptr_index_t driver_index;                       // Index driver_t* -> index in driver_list.
+    registry_policy_t policy;                       // Growth and shrink policy.
+    const drv_static_entry_t* static_list;          // Link-time registered drivers (see drv_static.h). Not in driver_list.
+    size_t static_count;                            // Number of link-time registered drivers.
+    bool static_attached;                           // true: static_list is set up.
+    const drv_mph_table_t* mph;                     // Build-time perfect hash of the static driver names (see drv_mph.h). May be NULL.
+    _Atomic(registry_snapshot_t*) snapshot;         // Concurrent mode: Data of the readers. NULL: Empty.
+    atomic_bool writer_lock;                        // Concurrent mode: Serializes the writers.
 } registry_t;
 
 
-#endif // _REGISTRY_TYPES_H_
\ No newline at end of file
+#endif // _REGISTRY_TYPES_H_
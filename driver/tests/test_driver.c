@@ -1,11 +1,20 @@
 #include "unity.h"
 #include "driver.h"
+#include "registry.h"
+#include "path_cache.h"
+#include "hash.h"
+#include "epoch.h"
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
 
 static int tst_reg_drv(driver_t* base_driver, const char* name, driver_t* driver);
 static int tst_dereg_drv(driver_t* base_driver, driver_t* driver);
+static int tst_reg_drv_many(driver_t* base_driver, const char* const names[], driver_t* const drivers[], size_t count, int* errors);
 static driver_t* tst_open(driver_t* base_driver, const char* name);
 static int tst_close(driver_t* driver);
 static ssize_t tst_read(driver_t* base_driver, void* buffer, size_t count);
@@ -13,8 +22,14 @@ static ssize_t tst_write(driver_t* base_driver, const void* buffer, size_t count
 static int tst_ioctl(driver_t* base_driver, size_t id, void* param);
 static size_t tst_get_properties(driver_t* driver);
 static property_t* tst_get_property(driver_t* driver, size_t id);
+static driver_t* tst_tree_open(driver_t* base_driver, const char* name);
+static driver_t* tst_tree_lookup(driver_t* base_driver, const char* name);
+static int tst_tree_close(driver_t* driver);
+static int tst_tree_reg(driver_t* base_driver, const char* name, driver_t* driver);
+static int tst_tree_dereg(driver_t* base_driver, driver_t* driver);
 
 // ---- Dummy-Kontext und Treiber ----
+static const char* tst_reg_name;                    // Name of the last reg_drv or reg_drv_many call.
 
 
 // ---- Testobjekt ----
@@ -67,16 +82,63 @@ driver_t tst_driver = {
     .user = NULL,
 };
 
+// ---- Treiberbaum für drv_open_path: root/dio/port0/pin7 ----
+static driver_fops_t tst_tree_fops = {
+    .reg_drv = tst_tree_reg,
+    .dereg_drv = tst_tree_dereg,
+    .open = tst_tree_open,
+    .close = tst_tree_close,
+    .lookup = tst_tree_lookup,
+};
+
+static registry_t tst_reg_root, tst_reg_dio, tst_reg_port;
+static size_t tst_lookups = 0;
+
+static driver_ctx_t tst_ctx_root = { .open_max = 0 };
+static driver_ctx_t tst_ctx_dio = { .open_max = 0 };
+static driver_ctx_t tst_ctx_port = { .open_max = 0 };
+static driver_ctx_t tst_ctx_pin7 = { .open_max = 0 };
+static driver_ctx_t tst_ctx_pin8 = { .open_max = 0 };
+
+static driver_t tst_root = { .name = "root", .type = DRV_TEST, .fops = &tst_tree_fops, .ctx = &tst_ctx_root, .user = &tst_reg_root };
+static driver_t tst_dio = { .name = "dio", .type = DRV_TEST, .fops = &tst_tree_fops, .ctx = &tst_ctx_dio, .user = &tst_reg_dio };
+static driver_t tst_port = { .name = "port0", .type = DRV_TEST, .fops = &tst_tree_fops, .ctx = &tst_ctx_port, .user = &tst_reg_port };
+static driver_t tst_pin7 = { .name = "pin7", .type = DRV_GPIO_PIN, .ctx = &tst_ctx_pin7 };
+static driver_t tst_pin8 = { .name = "pin8", .type = DRV_GPIO_PIN, .ctx = &tst_ctx_pin8 };
+
+static void tst_tree_free(registry_t* reg) {
+    free(reg->driver_list);
+    free(reg->name_index);
+    free(reg->reg_name_index);
+    free(reg->used_map);
+    free(reg->generations);
+    ptr_index_free(&reg->driver_index);
+    memset(reg, 0, sizeof(registry_t));
+}
+
 #define TST_BUFFER_SIZE (1024U)
 char tst_buffer[TST_BUFFER_SIZE];
 
 // ---- Setup / Cleanup -----
 void test_driver_setUp(void)
 {
+    path_cache_clear();
+    tst_lookups = 0;
+    tst_ctx_dio.open_cntr = 0;
+    tst_ctx_port.open_cntr = 0;
+    tst_ctx_pin7.open_cntr = 0;
+    tst_ctx_pin7.refs = 0;
+    registry_add_driver(&tst_reg_root, &tst_dio);
+    registry_add_driver(&tst_reg_dio, &tst_port);
+    registry_add_driver(&tst_reg_port, &tst_pin7);
 }
 
 void test_driver_tearDown(void)
 {
+    tst_tree_free(&tst_reg_root);
+    tst_tree_free(&tst_reg_dio);
+    tst_tree_free(&tst_reg_port);
+    path_cache_clear();
 }
 
 // ---- Single Tests ----
@@ -87,6 +149,20 @@ void test_register_valid_driver_should_succeed(void) {
     TEST_ASSERT_EQUAL_PTR(&tst_base, tst_driver.ctx->parent);
 }
 
+void test_register_should_intern_name(void) {
+    char name[] = "BaseDriver";
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_base, name, &tst_driver));
+    TEST_ASSERT_TRUE(tst_driver.ctx->reg_name != name);          // Interned copy
+    TEST_ASSERT_EQUAL_STRING("BaseDriver", tst_driver.ctx->reg_name);
+    TEST_ASSERT_EQUAL_UINT(hash_str("BaseDriver"), tst_driver.ctx->reg_name_hash);
+    TEST_ASSERT_EQUAL_INT(strlen("BaseDriver"), tst_driver.ctx->reg_name_len);
+
+    // Identical names share their storage.
+    const char* reg_name = tst_driver.ctx->reg_name;
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_base, "BaseDriver", &tst_driver));
+    TEST_ASSERT_EQUAL_PTR(reg_name, tst_driver.ctx->reg_name);
+}
+
 void test_register_param_check_should_fail(void) {
 
     // base_driver == NULL
@@ -158,6 +234,89 @@ void test_deregister_no_reg_fop_should_fail() {
 
 }
 
+// ---- drv_replace ----
+void test_replace_param_check_should_fail(void) {
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "pin8", &tst_pin8));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_replace(NULL, &tst_pin8, &tst_pin7));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_replace(&tst_root, &tst_pin8, &tst_pin8));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    // Not registered at this base driver.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_replace(&tst_dio, &tst_pin8, &tst_pin7));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    // Base driver without replace_drv.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_replace(&tst_root, &tst_pin8, &tst_pin7));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&tst_reg_root, &tst_pin8));
+}
+
+// ---- drv_register_many / drv_deregister_many ----
+void test_register_many_should_succeed(void) {
+    char name[] = "BaseDriver";
+    const char* names[] = { name };
+    const driver_t* drivers[] = { &tst_driver };
+    int errors[1] = { -1 };
+
+    // Without reg_drv_many, the drivers are registered one by one. The fop gets the interned name, not the caller's.
+    TEST_ASSERT_EQUAL_INT(0, drv_register_many(&tst_base, names, drivers, 1, errors));
+    TEST_ASSERT_EQUAL_INT(0, errors[0]);
+    TEST_ASSERT_EQUAL_STRING("BaseDriver", tst_driver.ctx->reg_name);
+    TEST_ASSERT_EQUAL_PTR(tst_driver.ctx->reg_name, tst_reg_name);
+    TEST_ASSERT_EQUAL_PTR(&tst_base, tst_driver.ctx->parent);
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister_many(&tst_base, drivers, 1, errors));
+
+    // With reg_drv_many as well.
+    tst_reg_name = NULL;
+    tst_fops.reg_drv_many = tst_reg_drv_many;
+    TEST_ASSERT_EQUAL_INT(0, drv_register_many(&tst_base, names, drivers, 1, errors));
+    tst_fops.reg_drv_many = NULL;
+    TEST_ASSERT_EQUAL_PTR(tst_driver.ctx->reg_name, tst_reg_name);
+    TEST_ASSERT_TRUE(tst_reg_name != name);
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister_many(&tst_base, drivers, 1, errors));
+}
+
+void test_register_many_param_check_should_fail(void) {
+    const char* names[] = { "Driver1", "" };
+    const driver_t* drivers[] = { &tst_driver, &tst_driver };
+    int errors[2];
+
+    // base_driver == NULL
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_register_many(NULL, names, drivers, 2, errors));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    // names == NULL
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_register_many(&tst_base, NULL, drivers, 2, errors));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    // name is empty (""). Nothing is registered.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_register_many(&tst_base, names, drivers, 2, errors));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT(ECANCELED, errors[0]);
+    TEST_ASSERT_EQUAL_INT(EINVAL, errors[1]);
+}
+
+void test_register_many_no_fops_should_fail(void) {
+    const char* names[] = { "BaseDriver" };
+    const driver_t* drivers[] = { &tst_driver };
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_register_many(&tst_base_no_fops, names, drivers, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_deregister_many(&tst_base_no_fops, drivers, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+}
+
 // ---- drv_open ----
 void test_open_should_succeed() {
     TEST_ASSERT_EQUAL_PTR(0xCafeBabe, drv_open(&tst_base, "Test"));
@@ -193,6 +352,106 @@ void test_open_no_open_fop_should_fail() {
     tst_fops.open = tst_open;
 }
 
+// ---- drv_open_path ----
+void test_open_path_should_succeed(void) {
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(2, tst_lookups);
+    TEST_ASSERT_EQUAL_INT(1, tst_ctx_pin7.open_cntr);
+    TEST_ASSERT_EQUAL_INT(0, tst_ctx_dio.open_cntr);     // Intermediate drivers are not opened.
+    TEST_ASSERT_EQUAL_INT(0, tst_ctx_port.open_cntr);
+
+    // Single component: Same as drv_open()
+    TEST_ASSERT_EQUAL_PTR(&tst_dio, drv_open_path(&tst_root, "dio"));
+}
+
+void test_open_path_should_use_cache(void) {
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(2, tst_lookups);
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(2, tst_lookups);
+
+    // Same directory, other leaf
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&tst_reg_port, &tst_pin8));
+    TEST_ASSERT_EQUAL_PTR(&tst_pin8, drv_open_path(&tst_root, "dio/port0/pin8"));
+    TEST_ASSERT_EQUAL_INT(2, tst_lookups);
+
+    // Removal invalidates the cache
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&tst_reg_port, &tst_pin8));
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, "dio/port0/pin8"));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    TEST_ASSERT_EQUAL_INT(4, tst_lookups);
+}
+
+void test_open_path_removed_directory_should_fail(void) {
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&tst_reg_dio, &tst_port));
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+}
+
+// Entfernt einen anderen Treiber während des Auflösens, wie ein paralleles drv_deregister().
+static driver_t* tst_tree_lookup_racing(driver_t* base_driver, const char* name) {
+    (void)registry_remove_driver(&tst_reg_port, &tst_pin8);
+    return tst_tree_lookup(base_driver, name);
+}
+
+void test_open_path_removal_during_walk_should_not_be_cached(void) {
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&tst_reg_port, &tst_pin8));
+    tst_tree_fops.lookup = tst_tree_lookup_racing;
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    tst_tree_fops.lookup = tst_tree_lookup;
+    TEST_ASSERT_EQUAL_INT(2, tst_lookups);
+
+    // Stored with the generation from before the walk: The entry is stale, the path is walked again.
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(4, tst_lookups);
+}
+
+void test_open_path_without_lookup_fop_should_succeed(void) {
+    tst_tree_fops.lookup = NULL;
+    TEST_ASSERT_EQUAL_PTR(&tst_pin7, drv_open_path(&tst_root, "dio/port0/pin7"));
+    TEST_ASSERT_EQUAL_INT(0, tst_ctx_dio.open_cntr);     // Opened and closed again.
+    TEST_ASSERT_EQUAL_INT(0, tst_ctx_port.open_cntr);
+    tst_tree_fops.lookup = tst_tree_lookup;
+}
+
+void test_open_path_param_check_should_fail(void) {
+    static const char* const invalid[] = { "", "/dio", "dio/", "dio//port0" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        errno = 0;
+        TEST_ASSERT_NULL(drv_open_path(&tst_root, invalid[i]));
+        TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    }
+
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(NULL, "dio"));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    char long_path[DRV_PATH_MAX + 1];
+    memset(long_path, 'a', DRV_PATH_MAX);
+    long_path[DRV_PATH_MAX] = '\0';
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, long_path));
+    TEST_ASSERT_EQUAL_INT(ENAMETOOLONG, errno);
+}
+
+void test_open_path_invalid_component_should_fail(void) {
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, "dio/port1/pin7"));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+
+    // pin7 has no fops, so it can't have children.
+    errno = 0;
+    TEST_ASSERT_NULL(drv_open_path(&tst_root, "dio/port0/pin7/x"));
+    TEST_ASSERT_EQUAL_INT(ENOTDIR, errno);
+}
+
 // ---- drv_close ----
 void test_close_should_succeed() {
     TEST_ASSERT_EQUAL_INT(0, drv_close(&tst_driver));
@@ -218,6 +477,258 @@ void test_close_no_close_fop_should_fail() {
     tst_fops.close = drv_close;
 }
 
+// ---- drv_open_acquire / drv_open_release ----
+void test_open_acquire_should_respect_open_max(void) {
+    static driver_ctx_t ctx = { .open_max = 2 };
+    driver_t drv = { .name = "limited", .ctx = &ctx };
+
+    TEST_ASSERT_EQUAL_INT(0, drv_open_acquire(&drv));
+    TEST_ASSERT_EQUAL_INT(0, drv_open_acquire(&drv));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_acquire(&drv));
+    TEST_ASSERT_EQUAL_INT(EBUSY, errno);
+    TEST_ASSERT_EQUAL_INT(2, ctx.open_cntr);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_open_release(&drv));
+    TEST_ASSERT_EQUAL_INT(0, drv_open_release(&drv));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_release(&drv));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    TEST_ASSERT_EQUAL_INT(0, ctx.open_cntr);
+}
+
+void test_open_acquire_param_check_should_fail(void) {
+    driver_t drv = { .name = "no_ctx", .ctx = NULL };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_acquire(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_acquire(&drv));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_release(&drv));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+#define TST_CONTENTION_THREADS  (4U)
+#define TST_CONTENTION_ROUNDS   (20000U)
+#define TST_CONTENTION_MAX      (3U)
+
+static driver_ctx_t tst_ctx_contention = { .open_max = TST_CONTENTION_MAX };
+static driver_t tst_contention = { .name = "contention", .ctx = &tst_ctx_contention };
+static atomic_size_t tst_contention_active;
+static atomic_size_t tst_contention_errors;
+
+// Opens and closes the same driver. More than open_max concurrent opens are an error.
+static void* tst_contention_thread(void* arg) {
+    size_t* opened = arg;
+    for (size_t i = 0; i < TST_CONTENTION_ROUNDS; i++) {
+        if (drv_open_acquire(&tst_contention) != 0) {
+            continue;
+        }
+        (*opened)++;
+        if (atomic_fetch_add(&tst_contention_active, 1) >= TST_CONTENTION_MAX) {
+            atomic_fetch_add(&tst_contention_errors, 1);
+        }
+        atomic_fetch_sub(&tst_contention_active, 1);
+        if (drv_open_release(&tst_contention) != 0) {
+            atomic_fetch_add(&tst_contention_errors, 1);
+        }
+    }
+    return NULL;
+}
+
+void test_open_acquire_concurrent_should_never_exceed_open_max(void) {
+    pthread_t threads[TST_CONTENTION_THREADS];
+    size_t opened[TST_CONTENTION_THREADS] = { 0 };
+    for (size_t i = 0; i < TST_CONTENTION_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, tst_contention_thread, &opened[i]));
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < TST_CONTENTION_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        total += opened[i];
+    }
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&tst_contention_errors));
+    TEST_ASSERT_EQUAL_INT(0, tst_ctx_contention.open_cntr);
+    TEST_ASSERT_TRUE(total > 0);
+}
+
+void test_ctx_layout_should_allow_malloc(void) {
+    // Contexts from malloc() and embedded ones need no stricter alignment than any other object.
+    TEST_ASSERT_TRUE(_Alignof(driver_ctx_t) <= _Alignof(max_align_t));
+    // The counters don't share a cache line with the fixed fields or a neighbouring context.
+    TEST_ASSERT_TRUE(offsetof(driver_ctx_t, open_cntr) >= offsetof(driver_ctx_t, pad_fixed) + DRV_CACHE_LINE);
+    TEST_ASSERT_TRUE(sizeof(driver_ctx_t) - offsetof(driver_ctx_t, wait) - sizeof(drv_wait_t) >= DRV_CACHE_LINE);
+}
+
+// ---- Deregistration while open ----
+static int tst_hot_released;
+static atomic_bool tst_hot_in_read;
+static atomic_bool tst_hot_go;
+
+static ssize_t tst_hot_read(driver_t* driver, void* buffer, size_t count) {
+    // Blocks until the test lets it go, to simulate an operation in flight.
+    atomic_store(&tst_hot_in_read, true);
+    while (!atomic_load(&tst_hot_go)) {
+        sched_yield();
+    }
+    return (ssize_t)count;
+}
+
+static void tst_hot_release(driver_t* driver) {
+    tst_hot_released++;
+}
+
+static const driver_fops_t tst_hot_fops = {
+    .close = drv_open_release,
+    .read = tst_hot_read,
+    .release = tst_hot_release,
+};
+static driver_ctx_t tst_ctx_hot = { .open_max = 0 };
+static driver_t tst_hot = { .name = "hot", .type = DRV_GPIO_PIN, .fops = &tst_hot_fops, .ctx = &tst_ctx_hot };
+
+static void tst_hot_reset(void) {
+    tst_hot_released = 0;
+    atomic_store(&tst_hot_in_read, false);
+    atomic_store(&tst_hot_go, true);
+}
+
+void test_deregister_unused_driver_should_release(void) {
+    tst_hot_reset();
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+
+    // Released: Can be registered again.
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(2, tst_hot_released);
+}
+
+void test_deregister_open_driver_should_release_on_last_close(void) {
+    tst_hot_reset();
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    driver_t* drv_a = drv_open(&tst_root, "hot");
+    driver_t* drv_b = drv_open(&tst_root, "hot");
+    TEST_ASSERT_EQUAL_PTR(&tst_hot, drv_a);
+    TEST_ASSERT_EQUAL_PTR(&tst_hot, drv_b);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+
+    // No new opens and operations, even with a pointer from before.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_open_acquire(&tst_hot));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read(drv_a, tst_buffer, 1));
+    TEST_ASSERT_EQUAL_INT(ENODEV, errno);
+
+    // Not released yet: Can't be registered again.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(EBUSY, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv_a));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv_b));
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+}
+
+// Reads from the driver. The read blocks until tst_hot_go is set.
+static void* tst_hot_reader(void* arg) {
+    ssize_t* result = arg;
+    *result = drv_read(&tst_hot, tst_buffer, 1);
+    return NULL;
+}
+
+void test_deregister_should_wait_for_running_operation(void) {
+    tst_hot_reset();
+    atomic_store(&tst_hot_go, false);
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    driver_t* drv = drv_open(&tst_root, "hot");
+    TEST_ASSERT_EQUAL_PTR(&tst_hot, drv);
+
+    pthread_t thread;
+    ssize_t result = 0;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_hot_reader, &result));
+    while (!atomic_load(&tst_hot_in_read)) {
+        sched_yield();
+    }
+
+    // Deregistered and closed while the read is in flight.
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+
+    atomic_store(&tst_hot_go, true);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_INT(1, result);
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+}
+
+// Stays in an epoch until tst_hot_go is set, like a lock-free lookup.
+static void* tst_epoch_reader(void* arg) {
+    (void)arg;
+    epoch_enter();
+    atomic_store(&tst_hot_in_read, true);
+    while (!atomic_load(&tst_hot_go)) {
+        sched_yield();
+    }
+    epoch_exit();
+    return NULL;
+}
+
+static void tst_epoch_reader_start(pthread_t* thread) {
+    atomic_store(&tst_hot_go, false);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(thread, NULL, tst_epoch_reader, NULL));
+    while (!atomic_load(&tst_hot_in_read)) {
+        sched_yield();
+    }
+}
+
+void test_deregister_should_release_without_epoch(void) {
+    pthread_t thread;
+    tst_hot_reset();
+    tst_epoch_reader_start(&thread);
+
+    // Not concurrent: No reader can see the driver anymore, it's released at once.
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+    TEST_ASSERT_EQUAL_INT(0, epoch_pending());
+
+    atomic_store(&tst_hot_go, true);
+    pthread_join(thread, NULL);
+}
+
+void test_deregister_concurrent_should_release_after_epoch(void) {
+    registry_t reg = { 0 };
+    TEST_ASSERT_EQUAL_INT(0, registry_make_concurrent(&reg));
+    driver_t base = { .name = "conc", .type = DRV_TEST, .fops = &tst_tree_fops, .user = &reg };
+    pthread_t thread;
+    tst_hot_reset();
+    tst_epoch_reader_start(&thread);
+
+    // The reader may still see the driver in the old snapshot.
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&base, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&base, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+
+    // Released by the exit of the reader, without a further registry write.
+    atomic_store(&tst_hot_go, true);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+    TEST_ASSERT_EQUAL_INT(0, epoch_pending());
+
+    // Released: A non-concurrent registry releases it directly again.
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(2, tst_hot_released);
+    TEST_ASSERT_EQUAL_INT(0, registry_free_registry(&reg));
+}
+
 // ---- drv_read ----
 void test_read_should_succeed() {
     TEST_ASSERT_LESS_OR_EQUAL_INT(TST_BUFFER_SIZE, drv_read(&tst_driver, tst_buffer, TST_BUFFER_SIZE));
@@ -280,6 +791,165 @@ void test_write_no_write_fop_should_fail() {
     tst_fops.write = tst_write;
 }
 
+// ---- drv_readv / drv_writev ----
+static int tst_vec_calls;
+static size_t tst_vec_limit;                        // Max. bytes per call of the scalar fops.
+
+static ssize_t tst_vec_read(driver_t* driver, void* buffer, size_t count) {
+    tst_vec_calls++;
+    if (tst_vec_limit == 0) {
+        errno = EIO;
+        return -1;
+    }
+    size_t len = (count < tst_vec_limit) ? count : tst_vec_limit;
+    if (len > 0) {
+        memset(buffer, 'r', len);
+    }
+    tst_vec_limit -= len;
+    return (ssize_t)len;
+}
+
+static ssize_t tst_vec_write(driver_t* driver, const void* buffer, size_t count) {
+    tst_vec_calls++;
+    if (tst_vec_limit == 0) {
+        errno = EIO;
+        return -1;
+    }
+    size_t len = (count < tst_vec_limit) ? count : tst_vec_limit;
+    tst_vec_limit -= len;
+    return (ssize_t)len;
+}
+
+static ssize_t tst_vec_readv(driver_t* driver, const struct iovec* iov, int iovcnt) {
+    tst_vec_calls++;
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += (ssize_t)iov[i].iov_len;
+    }
+    return total;
+}
+
+static driver_fops_t tst_vec_fops = {
+    .read = tst_vec_read,
+    .write = tst_vec_write,
+};
+static driver_t tst_vec = { .name = "vec", .type = DRV_TEST, .fops = &tst_vec_fops };
+
+static void tst_vec_reset(size_t limit) {
+    tst_vec_calls = 0;
+    tst_vec_limit = limit;
+    tst_vec_fops.readv = NULL;
+    tst_vec_fops.writev = NULL;
+}
+
+void test_readv_fallback_should_fill_all_segments() {
+    char head[4] = { 0 };
+    char body[8] = { 0 };
+    struct iovec iov[] = { { head, sizeof(head) }, { NULL, 0 }, { body, sizeof(body) } };
+    tst_vec_reset(SIZE_MAX);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(head) + sizeof(body), drv_readv(&tst_vec, iov, 3));
+    TEST_ASSERT_EQUAL_INT(3, tst_vec_calls);
+    TEST_ASSERT_EQUAL_INT('r', head[3]);
+    TEST_ASSERT_EQUAL_INT('r', body[7]);
+}
+
+void test_readv_fallback_should_stop_at_short_read() {
+    char head[4] = { 0 };
+    char body[8] = { 0 };
+    struct iovec iov[] = { { head, sizeof(head) }, { body, sizeof(body) }, { tst_buffer, 4 } };
+    tst_vec_reset(6);
+
+    TEST_ASSERT_EQUAL_INT(6, drv_readv(&tst_vec, iov, 3));
+    TEST_ASSERT_EQUAL_INT(2, tst_vec_calls);
+    TEST_ASSERT_EQUAL_INT('r', body[1]);
+    TEST_ASSERT_EQUAL_INT(0, body[2]);
+}
+
+void test_readv_fallback_error_should_fail() {
+    struct iovec iov[] = { { tst_buffer, 4 } };
+    tst_vec_reset(0);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_vec, iov, 1));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);
+}
+
+void test_readv_should_use_native_fop() {
+    struct iovec iov[] = { { tst_buffer, 4 }, { tst_buffer + 4, 8 } };
+    tst_vec_reset(SIZE_MAX);
+    tst_vec_fops.readv = tst_vec_readv;
+
+    TEST_ASSERT_EQUAL_INT(12, drv_readv(&tst_vec, iov, 2));
+    TEST_ASSERT_EQUAL_INT(1, tst_vec_calls);
+    tst_vec_fops.readv = NULL;
+}
+
+void test_readv_param_check_should_fail() {
+    struct iovec iov[] = { { tst_buffer, 4 }, { NULL, 4 } };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(NULL, iov, 1));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_vec, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_vec, iov, -1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_vec, iov, 2));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    struct iovec huge[] = { { tst_buffer, SSIZE_MAX }, { tst_buffer, 1 } };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_vec, huge, 2));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_readv_no_fops_should_fail() {
+    struct iovec iov[] = { { tst_buffer, 4 } };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_base_no_fops, iov, 1));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+    errno = 0;
+    tst_fops.read = NULL;
+    TEST_ASSERT_EQUAL_INT(-1, drv_readv(&tst_base, iov, 1));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    tst_fops.read = tst_read;
+}
+
+void test_writev_fallback_should_write_all_segments() {
+    struct iovec iov[] = { { tst_buffer, 4 }, { tst_buffer + 4, 8 } };
+    tst_vec_reset(SIZE_MAX);
+
+    TEST_ASSERT_EQUAL_INT(12, drv_writev(&tst_vec, iov, 2));
+    TEST_ASSERT_EQUAL_INT(2, tst_vec_calls);
+}
+
+void test_writev_fallback_error_should_return_written() {
+    struct iovec iov[] = { { tst_buffer, 4 }, { tst_buffer + 4, 8 } };
+    tst_vec_reset(4);
+
+    // Second segment fails: The bytes of the first segment are returned.
+    TEST_ASSERT_EQUAL_INT(4, drv_writev(&tst_vec, iov, 2));
+    TEST_ASSERT_EQUAL_INT(2, tst_vec_calls);
+}
+
+void test_writev_param_check_should_fail() {
+    struct iovec iov[] = { { tst_buffer, 4 } };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_writev(NULL, iov, 1));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_writev(&tst_vec, iov, DRV_IOV_MAX + 1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    tst_fops.write = NULL;
+    TEST_ASSERT_EQUAL_INT(-1, drv_writev(&tst_base, iov, 1));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    tst_fops.write = tst_write;
+}
+
 // ---- drv_ioctl ----
 void test_ioctl_should_succeed() {
     TEST_ASSERT_EQUAL_INT(0, drv_ioctl(&tst_driver, 0, NULL));
@@ -305,12 +975,325 @@ void test_ioctl_no_ioctl_fop_should_fail() {
     tst_fops.ioctl = tst_ioctl;
 }
 
+// ---- Buffer lending ----
+#define TST_STREAM_SIZE (16U)
+static uint8_t tst_stream_buf[TST_STREAM_SIZE];     // Internal buffer of the driver.
+static size_t tst_stream_fill;                      // Received bytes in tst_stream_buf.
+static size_t tst_stream_written;                   // Committed bytes.
+
+static ssize_t tst_stream_acquire_read(driver_t* driver, const void** buffer, size_t count) {
+    *buffer = tst_stream_buf;
+    return (ssize_t)((count < tst_stream_fill) ? count : tst_stream_fill);
+}
+
+static int tst_stream_release_read(driver_t* driver, const void* buffer, size_t count) {
+    memmove(tst_stream_buf, tst_stream_buf + count, tst_stream_fill - count);
+    tst_stream_fill -= count;
+    return 0;
+}
+
+static ssize_t tst_stream_acquire_write(driver_t* driver, void** buffer, size_t count) {
+    *buffer = tst_stream_buf;
+    return (ssize_t)((count < TST_STREAM_SIZE) ? count : TST_STREAM_SIZE);
+}
+
+static ssize_t tst_stream_commit_write(driver_t* driver, void* buffer, size_t count) {
+    tst_stream_written += count;
+    return (ssize_t)count;
+}
+
+static const driver_fops_t tst_stream_fops = {
+    .acquire_read_buf = tst_stream_acquire_read,
+    .release_read_buf = tst_stream_release_read,
+    .acquire_write_buf = tst_stream_acquire_write,
+    .commit_write_buf = tst_stream_commit_write,
+};
+static driver_t tst_stream = { .name = "stream", .type = DRV_TEST, .fops = &tst_stream_fops };
+
+void test_read_buf_should_lend_driver_buffer() {
+    memcpy(tst_stream_buf, "0123456789", 10);
+    tst_stream_fill = 10;
+
+    const void* buffer = NULL;
+    TEST_ASSERT_EQUAL_INT(4, drv_acquire_read_buf(&tst_stream, &buffer, 4));
+    TEST_ASSERT_EQUAL_PTR(tst_stream_buf, buffer);  // No copy.
+    TEST_ASSERT_EQUAL_INT(0, drv_release_read_buf(&tst_stream, buffer, 3));
+    TEST_ASSERT_EQUAL_INT(7, tst_stream_fill);
+
+    TEST_ASSERT_EQUAL_INT(7, drv_acquire_read_buf(&tst_stream, &buffer, 100));
+    TEST_ASSERT_EQUAL_INT('3', ((const char*)buffer)[0]);
+    TEST_ASSERT_EQUAL_INT(0, drv_release_read_buf(&tst_stream, buffer, 7));
+
+    // Nothing received: Nothing lent.
+    TEST_ASSERT_EQUAL_INT(0, drv_acquire_read_buf(&tst_stream, &buffer, 4));
+    TEST_ASSERT_NULL(buffer);
+}
+
+void test_write_buf_should_lend_driver_buffer() {
+    tst_stream_written = 0;
+    void* buffer = NULL;
+    TEST_ASSERT_EQUAL_INT(TST_STREAM_SIZE, drv_acquire_write_buf(&tst_stream, &buffer, 100));
+    TEST_ASSERT_EQUAL_PTR(tst_stream_buf, buffer);
+    memcpy(buffer, "abc", 3);
+    TEST_ASSERT_EQUAL_INT(3, drv_commit_write_buf(&tst_stream, buffer, 3));
+    TEST_ASSERT_EQUAL_INT(3, tst_stream_written);
+    TEST_ASSERT_EQUAL_INT('c', tst_stream_buf[2]);
+}
+
+void test_read_buf_fallback_should_copy() {
+    tst_vec_reset(SIZE_MAX);
+    const void* buffer = NULL;
+    TEST_ASSERT_EQUAL_INT(8, drv_acquire_read_buf(&tst_vec, &buffer, 8));
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_EQUAL_INT('r', ((const char*)buffer)[7]);
+    TEST_ASSERT_EQUAL_INT(1, tst_vec_calls);
+    TEST_ASSERT_EQUAL_INT(0, drv_release_read_buf(&tst_vec, buffer, 8));
+
+    // Read fails: Nothing lent.
+    tst_vec_reset(0);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_read_buf(&tst_vec, &buffer, 8));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);
+    TEST_ASSERT_NULL(buffer);
+}
+
+void test_write_buf_fallback_should_copy() {
+    tst_vec_reset(5);
+    void* buffer = NULL;
+    TEST_ASSERT_EQUAL_INT(8, drv_acquire_write_buf(&tst_vec, &buffer, 8));
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_EQUAL_INT(0, tst_vec_calls);
+    memset(buffer, 'w', 8);
+    TEST_ASSERT_EQUAL_INT(5, drv_commit_write_buf(&tst_vec, buffer, 8));    // Short write.
+    TEST_ASSERT_EQUAL_INT(1, tst_vec_calls);
+
+    // Commit of nothing: Buffer is dropped.
+    TEST_ASSERT_EQUAL_INT(8, drv_acquire_write_buf(&tst_vec, &buffer, 8));
+    TEST_ASSERT_EQUAL_INT(0, drv_commit_write_buf(&tst_vec, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(1, tst_vec_calls);
+}
+
+void test_lent_buffer_should_keep_driver_alive() {
+    tst_hot_reset();
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    const void* buffer = NULL;
+    TEST_ASSERT_EQUAL_INT(4, drv_acquire_read_buf(&tst_hot, &buffer, 4));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+    const void* other = NULL;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_read_buf(&tst_hot, &other, 4));
+    TEST_ASSERT_EQUAL_INT(ENODEV, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_release_read_buf(&tst_hot, buffer, 4));
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+}
+
+void test_lend_param_check_should_fail() {
+    const void* rbuf = NULL;
+    void* wbuf = NULL;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_read_buf(NULL, &rbuf, 4));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_write_buf(&tst_vec, NULL, 4));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_release_read_buf(&tst_vec, NULL, 4));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_commit_write_buf(NULL, wbuf, 4));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_read_buf(&tst_base_no_fops, &rbuf, 4));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+    errno = 0;
+    tst_fops.write = NULL;
+    TEST_ASSERT_EQUAL_INT(-1, drv_acquire_write_buf(&tst_base, &wbuf, 4));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    tst_fops.write = tst_write;
+    TEST_ASSERT_EQUAL_INT(0, drv_acquire_write_buf(&tst_vec, &wbuf, 0));
+    TEST_ASSERT_NULL(wbuf);
+}
+
+// ---- drv_bind ----
+void test_bind_should_call_fops() {
+    drv_bound_t bound;
+    tst_vec_reset(SIZE_MAX);
+    TEST_ASSERT_EQUAL_INT(0, drv_bind(&tst_vec, &bound));
+    TEST_ASSERT_EQUAL_PTR(&tst_vec, bound.driver);
+    TEST_ASSERT_EQUAL_INT(4, drv_bound_read(&bound, tst_buffer, 4));
+    TEST_ASSERT_EQUAL_INT(3, drv_bound_write(&bound, tst_buffer, 3));
+    TEST_ASSERT_EQUAL_INT(2, tst_vec_calls);
+
+    // No ioctl fop: Stub.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_bound_ioctl(&bound, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_unbind(&bound));
+    TEST_ASSERT_NULL(bound.driver);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_unbind(&bound));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+}
+
+void test_bind_should_keep_driver_alive() {
+    drv_bound_t bound;
+    tst_hot_reset();
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "hot", &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, drv_bind(&tst_hot, &bound));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(&tst_root, &tst_hot));
+    TEST_ASSERT_EQUAL_INT(0, tst_hot_released);
+
+    drv_bound_t other;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_bind(&tst_hot, &other));
+    TEST_ASSERT_EQUAL_INT(ENODEV, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_unbind(&bound));
+    TEST_ASSERT_EQUAL_INT(1, tst_hot_released);
+}
+
+void test_bind_param_check_should_fail() {
+    drv_bound_t bound;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_bind(NULL, &bound));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_bind(&tst_vec, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_bind(&tst_base_no_fops, &bound));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_unbind(NULL));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+}
+
+// ---- drv_ioctl_batch ----
+static int tst_batch_calls;
+static int tst_batch_applied;
+
+// Ids >= 100 fail with the id - 100 as errno.
+static int tst_batch_ioctl(driver_t* driver, size_t id, void* param) {
+    tst_batch_calls++;
+    if (id >= 100) {
+        errno = (int)(id - 100);
+        return -1;
+    }
+    tst_batch_applied++;
+    return 0;
+}
+
+// Applies the whole configuration at once.
+static int tst_batch_ioctl_batch(driver_t* driver, const drv_ioctl_req_t* reqs, size_t count, int* results, int flags) {
+    tst_batch_calls++;
+    for (size_t i = 0; i < count; i++) {
+        tst_batch_applied++;
+        if (results != NULL) {
+            results[i] = 0;
+        }
+    }
+    return 0;
+}
+
+static driver_fops_t tst_batch_fops = { .ioctl = tst_batch_ioctl };
+static driver_t tst_batch = { .name = "batch", .type = DRV_TEST, .fops = &tst_batch_fops };
+
+static void tst_batch_reset(void) {
+    tst_batch_calls = 0;
+    tst_batch_applied = 0;
+    tst_batch_fops.ioctl = tst_batch_ioctl;
+    tst_batch_fops.ioctl_batch = NULL;
+}
+
+void test_ioctl_batch_fallback_should_apply_all() {
+    const drv_ioctl_req_t reqs[] = { { 1, NULL }, { 2, NULL }, { 3, NULL } };
+    int results[3] = { -1, -1, -1 };
+    tst_batch_reset();
+
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl_batch(&tst_batch, reqs, 3, results, 0));
+    TEST_ASSERT_EQUAL_INT(3, tst_batch_calls);
+    TEST_ASSERT_EQUAL_INT(0, results[0]);
+    TEST_ASSERT_EQUAL_INT(0, results[2]);
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl_batch(&tst_batch, reqs, 3, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl_batch(&tst_batch, NULL, 0, NULL, 0));
+}
+
+void test_ioctl_batch_fallback_should_continue_after_error() {
+    const drv_ioctl_req_t reqs[] = { { 1, NULL }, { 100 + EIO, NULL }, { 2, NULL }, { 100 + EPERM, NULL } };
+    int results[4];
+    tst_batch_reset();
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_batch, reqs, 4, results, 0));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);              // First error.
+    TEST_ASSERT_EQUAL_INT(4, tst_batch_calls);
+    TEST_ASSERT_EQUAL_INT(2, tst_batch_applied);
+    TEST_ASSERT_EQUAL_INT(0, results[0]);
+    TEST_ASSERT_EQUAL_INT(EIO, results[1]);
+    TEST_ASSERT_EQUAL_INT(0, results[2]);
+    TEST_ASSERT_EQUAL_INT(EPERM, results[3]);
+}
+
+void test_ioctl_batch_fallback_should_stop_at_error() {
+    const drv_ioctl_req_t reqs[] = { { 1, NULL }, { 100 + EIO, NULL }, { 2, NULL } };
+    int results[3];
+    tst_batch_reset();
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_batch, reqs, 3, results, DRV_IOCTL_BATCH_STOP));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);
+    TEST_ASSERT_EQUAL_INT(2, tst_batch_calls);
+    TEST_ASSERT_EQUAL_INT(0, results[0]);
+    TEST_ASSERT_EQUAL_INT(EIO, results[1]);
+    TEST_ASSERT_EQUAL_INT(ECANCELED, results[2]);
+}
+
+void test_ioctl_batch_should_use_native_fop() {
+    const drv_ioctl_req_t reqs[] = { { 1, NULL }, { 2, NULL }, { 3, NULL } };
+    int results[3] = { -1, -1, -1 };
+    tst_batch_reset();
+    tst_batch_fops.ioctl_batch = tst_batch_ioctl_batch;
+
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl_batch(&tst_batch, reqs, 3, results, 0));
+    TEST_ASSERT_EQUAL_INT(1, tst_batch_calls);
+    TEST_ASSERT_EQUAL_INT(3, tst_batch_applied);
+    TEST_ASSERT_EQUAL_INT(0, results[1]);
+
+    // Only the batch fop.
+    tst_batch_fops.ioctl = NULL;
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl_batch(&tst_batch, reqs, 3, NULL, 0));
+    tst_batch_reset();
+}
+
+void test_ioctl_batch_param_check_should_fail() {
+    const drv_ioctl_req_t reqs[] = { { 1, NULL } };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(NULL, reqs, 1, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_batch, NULL, 1, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_batch, reqs, 1, NULL, 0x80));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_base_no_fops, reqs, 1, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(ENOSYS, errno);
+    errno = 0;
+    tst_fops.ioctl = NULL;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl_batch(&tst_driver, reqs, 1, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    tst_fops.ioctl = tst_ioctl;
+}
+
 // ---- Run all tests ----
 void test_driver_run_all() {
     // alle Tests aufrufen
 #define RUN(x) RUN_TEST(x)
     // drv_register
     RUN(test_register_valid_driver_should_succeed);
+    RUN(test_register_should_intern_name);
     RUN(test_register_param_check_should_fail);
     RUN(test_register_no_fops_should_fail);
     RUN(test_register_no_reg_fop_should_fail);
@@ -319,16 +1302,51 @@ void test_driver_run_all() {
     RUN(test_deregister_param_check_should_fail);
     RUN(test_deregister_no_fops_should_fail);
     RUN(test_deregister_no_reg_fop_should_fail);
+    RUN(test_replace_param_check_should_fail);
+    // drv_register_many / drv_deregister_many
+    RUN(test_register_many_should_succeed);
+    RUN(test_register_many_param_check_should_fail);
+    RUN(test_register_many_no_fops_should_fail);
     // drv_open
     RUN(test_open_should_succeed);
     RUN(test_open_param_check_should_fail);
     RUN(test_open_no_fops_should_fail);
     RUN(test_open_no_open_fop_should_fail);
+    // drv_open_path
+    RUN(test_open_path_should_succeed);
+    RUN(test_open_path_should_use_cache);
+    RUN(test_open_path_removed_directory_should_fail);
+    RUN(test_open_path_removal_during_walk_should_not_be_cached);
+    RUN(test_open_path_without_lookup_fop_should_succeed);
+    RUN(test_open_path_param_check_should_fail);
+    RUN(test_open_path_invalid_component_should_fail);
     // drv_close
     RUN(test_close_should_succeed);
     RUN(test_close_param_check_should_fail);
     RUN(test_close_no_fops_should_fail);
     RUN(test_close_no_close_fop_should_fail);
+
+    // drv_open_acquire / drv_open_release
+    RUN(test_open_acquire_should_respect_open_max);
+    RUN(test_open_acquire_param_check_should_fail);
+    RUN(test_open_acquire_concurrent_should_never_exceed_open_max);
+    RUN(test_ctx_layout_should_allow_malloc);
+    // drv_readv / drv_writev
+    RUN(test_readv_fallback_should_fill_all_segments);
+    RUN(test_readv_fallback_should_stop_at_short_read);
+    RUN(test_readv_fallback_error_should_fail);
+    RUN(test_readv_should_use_native_fop);
+    RUN(test_readv_param_check_should_fail);
+    RUN(test_readv_no_fops_should_fail);
+    RUN(test_writev_fallback_should_write_all_segments);
+    RUN(test_writev_fallback_error_should_return_written);
+    RUN(test_writev_param_check_should_fail);
+    // Deregistration while open
+    RUN(test_deregister_unused_driver_should_release);
+    RUN(test_deregister_open_driver_should_release_on_last_close);
+    RUN(test_deregister_should_wait_for_running_operation);
+    RUN(test_deregister_should_release_without_epoch);
+    RUN(test_deregister_concurrent_should_release_after_epoch);
     // drv_read
     RUN(test_read_should_succeed);
     RUN(test_read_param_check_should_fail);
@@ -346,11 +1364,34 @@ void test_driver_run_all() {
     RUN(test_ioctl_param_check_should_fail);
     RUN(test_ioctl_no_fops_should_fail);
     RUN(test_ioctl_no_ioctl_fop_should_fail);
+    // Buffer lending
+    RUN(test_read_buf_should_lend_driver_buffer);
+    RUN(test_write_buf_should_lend_driver_buffer);
+    RUN(test_read_buf_fallback_should_copy);
+    RUN(test_write_buf_fallback_should_copy);
+    RUN(test_lent_buffer_should_keep_driver_alive);
+    RUN(test_lend_param_check_should_fail);
+    // drv_bind
+    RUN(test_bind_should_call_fops);
+    RUN(test_bind_should_keep_driver_alive);
+    RUN(test_bind_param_check_should_fail);
+    // drv_ioctl_batch
+    RUN(test_ioctl_batch_fallback_should_apply_all);
+    RUN(test_ioctl_batch_fallback_should_continue_after_error);
+    RUN(test_ioctl_batch_fallback_should_stop_at_error);
+    RUN(test_ioctl_batch_should_use_native_fop);
+    RUN(test_ioctl_batch_param_check_should_fail);
 #undef RUN
 }
 
 // ---- Helper functions ----
 static int tst_reg_drv(driver_t* base_driver, const char* name, driver_t* driver) {
+    tst_reg_name = name;
+    return 0;
+}
+
+static int tst_reg_drv_many(driver_t* base_driver, const char* const names[], driver_t* const drivers[], size_t count, int* errors) {
+    tst_reg_name = (count > 0) ? names[0] : NULL;
     return 0;
 }
 
@@ -385,3 +1426,33 @@ static size_t tst_get_properties(driver_t* driver) {
 static property_t* tst_get_property(driver_t* driver, size_t id) {
     return (property_t*)0xCafeBabe;
 }
+
+static driver_t* tst_tree_lookup(driver_t* base_driver, const char* name) {
+    tst_lookups++;
+    driver_t* driver = registry_get_driver_by_name((registry_t*)base_driver->user, name);
+    if (driver == NULL) {
+        errno = ENOENT;
+    }
+    return driver;
+}
+
+static driver_t* tst_tree_open(driver_t* base_driver, const char* name) {
+    driver_t* driver = registry_get_driver_by_name((registry_t*)base_driver->user, name);
+    if (driver == NULL) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return (drv_open_acquire(driver) == 0) ? driver : NULL;
+}
+
+static int tst_tree_close(driver_t* driver) {
+    return drv_open_release(driver);
+}
+
+static int tst_tree_reg(driver_t* base_driver, const char* name, driver_t* driver) {
+    return registry_add_driver((registry_t*)base_driver->user, driver);
+}
+
+static int tst_tree_dereg(driver_t* base_driver, driver_t* driver) {
+    return registry_remove_driver((registry_t*)base_driver->user, driver);
+}
@@ -0,0 +1,243 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_file.h"
+#include "registry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// ---- Dummy-Treiber: Verzeichnis mit einem Treiber mit Per-Handle-Zustand ----
+static registry_t tst_reg;
+static int tst_closed;
+
+static driver_t* tst_dir_open(driver_t* base_driver, const char* name) {
+    driver_t* driver = registry_get_driver_by_name(&tst_reg, name);
+    if (driver == NULL) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return (drv_open_acquire(driver) == 0) ? driver : NULL;
+}
+
+static int tst_file_close(driver_t* driver) {
+    return drv_open_release(driver);
+}
+
+// Every handle counts its own bytes.
+static int tst_file_open_file(drv_file_t* file) {
+    if (file->flags < 0) {
+        errno = EACCES;
+        return -1;
+    }
+    file->priv = calloc(1, sizeof(size_t));
+    return (file->priv != NULL) ? 0 : -1;
+}
+
+static int tst_file_close_file(drv_file_t* file) {
+    free(file->priv);
+    file->priv = NULL;
+    tst_closed++;
+    return 0;
+}
+
+static ssize_t tst_file_write_file(drv_file_t* file, const void* buffer, size_t count) {
+    *(size_t*)file->priv += count;
+    file->offset += (off_t)count;
+    return (ssize_t)count;
+}
+
+static ssize_t tst_file_read(driver_t* driver, void* buffer, size_t count) {
+    memset(buffer, 0x5A, count);
+    return (ssize_t)count;
+}
+
+static const driver_fops_t tst_dir_fops = { .open = tst_dir_open };
+static const driver_fops_t tst_file_fops = {
+    .close = tst_file_close,
+    .read = tst_file_read,
+    .open_file = tst_file_open_file,
+    .close_file = tst_file_close_file,
+    .write_file = tst_file_write_file,
+};
+
+static driver_t tst_dir = { .name = "dir", .fops = &tst_dir_fops };
+static driver_ctx_t tst_file_ctx = { .open_max = 0 };
+static driver_t tst_file_drv = { .name = "file", .fops = &tst_file_fops, .ctx = &tst_file_ctx };
+static driver_ctx_t tst_limited_ctx = { .open_max = 1 };
+static driver_t tst_limited = { .name = "limited", .fops = &tst_file_fops, .ctx = &tst_limited_ctx };
+
+// ---- Setup / Cleanup -----
+void test_drv_file_setUp(void)
+{
+    // Also called for the whole group (nested RUN_TEST): register only once.
+    if (registry_get_driver_by_name(&tst_reg, "file") == NULL) {
+        registry_add_driver(&tst_reg, &tst_file_drv);
+        registry_add_driver(&tst_reg, &tst_limited);
+    }
+    tst_file_ctx.open_cntr = 0;
+    tst_limited_ctx.open_cntr = 0;
+    tst_closed = 0;
+}
+
+void test_drv_file_tearDown(void)
+{
+    registry_remove_driver(&tst_reg, &tst_file_drv);
+    registry_remove_driver(&tst_reg, &tst_limited);
+    registry_free_registry(&tst_reg);
+}
+
+// ---- drv_fd_alloc / drv_fd_free / drv_fd_get ----
+void test_drv_fd_alloc_should_resolve(void)
+{
+    size_t count = drv_fd_count();
+    drv_file_t* file = NULL;
+    int fd = drv_fd_alloc(&tst_file_drv, 3, &file);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_PTR(file, drv_fd_get(fd));
+    TEST_ASSERT_EQUAL_PTR(&tst_file_drv, file->driver);
+    TEST_ASSERT_EQUAL_INT(3, file->flags);
+    TEST_ASSERT_EQUAL_INT(count + 1, drv_fd_count());
+
+    TEST_ASSERT_EQUAL_INT(0, drv_fd_free(fd));
+    TEST_ASSERT_EQUAL_INT(count, drv_fd_count());
+}
+
+void test_drv_fd_stale_descriptor_should_fail(void)
+{
+    int fd = drv_fd_alloc(&tst_file_drv, 0, NULL);
+    TEST_ASSERT_EQUAL_INT(0, drv_fd_free(fd));
+
+    errno = 0;
+    TEST_ASSERT_NULL(drv_fd_get(fd));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fd_free(fd));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+
+    // Slot is reused with a new generation: The old descriptor stays stale.
+    int reused = drv_fd_alloc(&tst_file_drv, 0, NULL);
+    TEST_ASSERT_TRUE(reused != fd);
+    TEST_ASSERT_NULL(drv_fd_get(fd));
+    TEST_ASSERT_NOT_NULL(drv_fd_get(reused));
+    TEST_ASSERT_EQUAL_INT(0, drv_fd_free(reused));
+}
+
+void test_drv_fd_invalid_descriptor_should_fail(void)
+{
+    TEST_ASSERT_NULL(drv_fd_get(-1));
+    TEST_ASSERT_NULL(drv_fd_get(0));                    // Never allocated.
+    TEST_ASSERT_NULL(drv_fd_get((int)DRV_FD_MAX));       // Index out of range.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fd_alloc(NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_drv_fd_table_full_should_fail(void)
+{
+    size_t count = drv_fd_count();
+    int* fds = malloc(DRV_FD_MAX * sizeof(int));
+    size_t allocated = 0;
+    while ((allocated < DRV_FD_MAX) && ((fds[allocated] = drv_fd_alloc(&tst_file_drv, 0, NULL)) >= 0)) {
+        allocated++;
+    }
+    TEST_ASSERT_EQUAL_INT(DRV_FD_MAX - count, allocated);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fd_alloc(&tst_file_drv, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(EMFILE, errno);
+
+    for (size_t i = 0; i < allocated; i++) {
+        TEST_ASSERT_EQUAL_INT(0, drv_fd_free(fds[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(count, drv_fd_count());
+    free(fds);
+}
+
+// ---- drv_fopen / drv_fclose ----
+void test_fopen_should_keep_state_per_handle(void)
+{
+    int fd_a = drv_fopen(&tst_dir, "file", 0);
+    int fd_b = drv_fopen(&tst_dir, "file", 0);
+    TEST_ASSERT_TRUE(fd_a >= 0);
+    TEST_ASSERT_TRUE(fd_b >= 0);
+    TEST_ASSERT_EQUAL_INT(2, tst_file_ctx.open_cntr);
+
+    TEST_ASSERT_EQUAL_INT(4, drv_fwrite(fd_a, "abcd", 4));
+    TEST_ASSERT_EQUAL_INT(2, drv_fwrite(fd_b, "ab", 2));
+    TEST_ASSERT_EQUAL_INT(4, *(size_t*)drv_file(fd_a)->priv);
+    TEST_ASSERT_EQUAL_INT(2, *(size_t*)drv_file(fd_b)->priv);
+    TEST_ASSERT_EQUAL_INT(4, drv_file(fd_a)->offset);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd_a));
+    TEST_ASSERT_EQUAL_INT(1, tst_closed);
+    TEST_ASSERT_EQUAL_INT(1, tst_file_ctx.open_cntr);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd_b));
+    TEST_ASSERT_EQUAL_INT(0, tst_file_ctx.open_cntr);
+}
+
+void test_fread_should_fall_back_to_read(void)
+{
+    unsigned char buffer[4] = { 0 };
+    int fd = drv_fopen(&tst_dir, "file", 0);
+    TEST_ASSERT_EQUAL_INT(4, drv_fread(fd, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_INT(0x5A, buffer[3]);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fioctl(fd, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fread(fd, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_fclose_twice_should_fail(void)
+{
+    int fd = drv_fopen(&tst_dir, "file", 0);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fclose(fd));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fwrite(fd, "a", 1));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    TEST_ASSERT_EQUAL_INT(0, tst_file_ctx.open_cntr);
+}
+
+void test_fopen_failures_should_close_driver(void)
+{
+    size_t count = drv_fd_count();
+
+    // open_file fails
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fopen(&tst_dir, "file", -1));
+    TEST_ASSERT_EQUAL_INT(EACCES, errno);
+    TEST_ASSERT_EQUAL_INT(0, tst_file_ctx.open_cntr);
+    TEST_ASSERT_EQUAL_INT(count, drv_fd_count());
+
+    // open fails
+    int fd = drv_fopen(&tst_dir, "limited", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fopen(&tst_dir, "limited", 0));
+    TEST_ASSERT_EQUAL_INT(EBUSY, errno);
+    TEST_ASSERT_EQUAL_INT(-1, drv_fopen(&tst_dir, "unknown", 0));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+    TEST_ASSERT_EQUAL_INT(count, drv_fd_count());
+}
+
+void test_drv_file_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_drv_fd_alloc_should_resolve);
+    RUN(test_drv_fd_stale_descriptor_should_fail);
+    RUN(test_drv_fd_invalid_descriptor_should_fail);
+    RUN(test_drv_fd_table_full_should_fail);
+    RUN(test_fopen_should_keep_state_per_handle);
+    RUN(test_fread_should_fall_back_to_read);
+    RUN(test_fclose_twice_should_fail);
+    RUN(test_fopen_failures_should_close_driver);
+#undef RUN
+}
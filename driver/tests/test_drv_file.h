@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_FILE_H_
+#define _TEST_DRV_FILE_H_
+
+void test_drv_file_setUp(void);
+void test_drv_file_tearDown(void);
+void test_drv_file_run_all();
+
+#endif //_TEST_DRV_FILE_H_
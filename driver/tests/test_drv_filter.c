@@ -0,0 +1,275 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_filter.h"
+#include "drv_dio.h"
+#include "tst_time.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// ---- Ziel-Treiber: Zeichnet alle Schreibvorgänge auf ----
+static pthread_mutex_t tst_lock = PTHREAD_MUTEX_INITIALIZER;
+static char tst_sink[256];
+static size_t tst_sink_len;
+static _Atomic int tst_writes;
+static int tst_fail;                            // != 0: write schlägt mit diesem errno fehl.
+static size_t tst_last_ioctl;
+static int tst_released;
+
+static ssize_t tst_target_write(driver_t* driver, const void* buffer, size_t count) {
+    pthread_mutex_lock(&tst_lock);
+    if (tst_fail != 0) {
+        errno = tst_fail;
+        pthread_mutex_unlock(&tst_lock);
+        return -1;
+    }
+    size_t len = (count < sizeof(tst_sink) - tst_sink_len) ? count : sizeof(tst_sink) - tst_sink_len;
+    memcpy(tst_sink + tst_sink_len, buffer, len);
+    tst_sink_len += len;
+    pthread_mutex_unlock(&tst_lock);
+    atomic_fetch_add(&tst_writes, 1);
+    return (ssize_t)count;
+}
+
+static ssize_t tst_target_read(driver_t* driver, void* buffer, size_t count) {
+    return 0;
+}
+
+static int tst_target_ioctl(driver_t* driver, size_t id, void* param) {
+    tst_last_ioctl = id;
+    return 0;
+}
+
+static void tst_target_release(driver_t* driver) {
+    tst_released++;
+}
+
+static const driver_fops_t tst_target_fops = {
+    .close = drv_open_release,
+    .read = tst_target_read,
+    .write = tst_target_write,
+    .ioctl = tst_target_ioctl,
+    .release = tst_target_release,
+};
+static driver_ctx_t tst_target_ctx;
+static driver_t tst_target = { .name = "flt_pin", .type = DRV_TEST, .fops = &tst_target_fops, .ctx = &tst_target_ctx };
+
+static drv_filter_t tst_filter;
+
+static int tst_sink_equals(const char* expected) {
+    pthread_mutex_lock(&tst_lock);
+    int equal = (tst_sink_len == strlen(expected)) && (memcmp(tst_sink, expected, tst_sink_len) == 0);
+    pthread_mutex_unlock(&tst_lock);
+    return equal;
+}
+
+void test_drv_filter_setUp(void)
+{
+    pthread_mutex_lock(&tst_lock);
+    tst_sink_len = 0;
+    tst_fail = 0;
+    pthread_mutex_unlock(&tst_lock);
+    atomic_store(&tst_writes, 0);
+    tst_last_ioctl = 0;
+    tst_released = 0;
+}
+
+void test_drv_filter_tearDown(void)
+{
+}
+
+void test_filter_param_check_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_init(NULL, &tst_target, 8, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_init(&tst_filter, NULL, 8, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_init(&tst_filter, &tst_target, 0, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_destroy(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_NULL(drv_filter_driver(NULL));
+}
+
+void test_filter_should_coalesce_by_size(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 8, 0));
+    driver_t* drv = drv_filter_driver(&tst_filter);
+    TEST_ASSERT_EQUAL_STRING("flt_pin", drv->name);
+
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL_INT(1, drv_write(drv, "abcdefgh" + i, 1));
+    }
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&tst_writes));
+    // Schwelle erreicht: Ein Schreibvorgang mit allen Bytes.
+    TEST_ASSERT_EQUAL_INT(1, drv_write(drv, "h", 1));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&tst_writes));
+    TEST_ASSERT_TRUE(tst_sink_equals("abcdefgh"));
+
+    // Passt nicht mehr: Erst der Puffer, dann der große Block direkt.
+    TEST_ASSERT_EQUAL_INT(2, drv_write(drv, "ij", 2));
+    TEST_ASSERT_EQUAL_INT(10, drv_write(drv, "0123456789", 10));
+    TEST_ASSERT_EQUAL_INT(3, atomic_load(&tst_writes));
+    TEST_ASSERT_TRUE(tst_sink_equals("abcdefghij0123456789"));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+}
+
+void test_filter_should_flush_before_other_calls(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 64, 0));
+    driver_t* drv = drv_filter_driver(&tst_filter);
+
+    TEST_ASSERT_EQUAL_INT(3, drv_write(drv, "abc", 3));
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl(drv, DRV_FILTER_IOCTL_FLUSH, NULL));
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&tst_writes));
+    TEST_ASSERT_EQUAL_INT(0, tst_last_ioctl);           // Flush bleibt im Filter.
+
+    // Andere ioctls und read gehen nach einem Flush an das Ziel.
+    TEST_ASSERT_EQUAL_INT(2, drv_write(drv, "de", 2));
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl(drv, 42, NULL));
+    TEST_ASSERT_EQUAL_INT(42, tst_last_ioctl);
+    TEST_ASSERT_EQUAL_INT(2, atomic_load(&tst_writes));
+    TEST_ASSERT_EQUAL_INT(1, drv_write(drv, "f", 1));
+    char buffer[4];
+    TEST_ASSERT_EQUAL_INT(0, drv_read(drv, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_INT(3, atomic_load(&tst_writes));
+    TEST_ASSERT_TRUE(tst_sink_equals("abcdef"));
+
+    // Leerer Puffer: Kein Schreibvorgang.
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+    TEST_ASSERT_EQUAL_INT(3, atomic_load(&tst_writes));
+}
+
+void test_filter_should_flush_after_window(void)
+{
+    struct timespec start;
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 64, 10));
+    driver_t* drv = drv_filter_driver(&tst_filter);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TEST_ASSERT_EQUAL_INT(2, drv_write(drv, "xy", 2));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&tst_writes));
+    // Ohne weitere Aufrufe schreibt der Flusher-Thread nach dem Zeitfenster.
+    long elapsed_ms;
+    do {
+        sched_yield();
+        int written = atomic_load(&tst_writes);
+        // Zeit erst nach dem Zähler lesen: Sonst kann der Flush zwischen beiden liegen.
+        elapsed_ms = tst_elapsed_ms(&start);
+        if (written != 0) {
+            break;
+        }
+    } while (elapsed_ms < 2000);
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&tst_writes));
+    TEST_ASSERT_TRUE(elapsed_ms >= 9);
+    TEST_ASSERT_TRUE(tst_sink_equals("xy"));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+}
+
+void test_filter_should_report_deferred_error(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 4, 0));
+    driver_t* drv = drv_filter_driver(&tst_filter);
+
+    pthread_mutex_lock(&tst_lock);
+    tst_fail = EIO;
+    pthread_mutex_unlock(&tst_lock);
+    // Angenommen, der Flush an der Schwelle schlägt fehl: Meldung beim nächsten Aufruf.
+    TEST_ASSERT_EQUAL_INT(2, drv_write(drv, "ab", 2));
+    TEST_ASSERT_EQUAL_INT(2, drv_write(drv, "cd", 2));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_write(drv, "e", 1));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);
+
+    // Die Daten sind nicht verloren.
+    pthread_mutex_lock(&tst_lock);
+    tst_fail = 0;
+    pthread_mutex_unlock(&tst_lock);
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl(drv, DRV_FILTER_IOCTL_FLUSH, NULL));
+    TEST_ASSERT_TRUE(tst_sink_equals("abcd"));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+}
+
+void test_filter_stack_should_be_transparent(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_register(drv_dio, "flt_pin", &tst_target));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 16, 0));
+    driver_t* direct = drv_open(drv_dio, "flt_pin");
+    TEST_ASSERT_EQUAL_PTR(&tst_target, direct);
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_stack(drv_dio, &tst_filter));
+
+    // Aufrufer öffnen den Namen wie bisher und bekommen den Filter.
+    driver_t* drv = drv_open(drv_dio, "flt_pin");
+    TEST_ASSERT_EQUAL_PTR(drv_filter_driver(&tst_filter), drv);
+    TEST_ASSERT_EQUAL_INT(1, drv_write(drv, "1", 1));
+    TEST_ASSERT_EQUAL_INT(1, drv_write(drv, "0", 1));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&tst_writes));
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv));           // close schreibt den Puffer.
+    TEST_ASSERT_EQUAL_INT(1, atomic_load(&tst_writes));
+    TEST_ASSERT_TRUE(tst_sink_equals("10"));
+
+    // Handles des Ziels von vorher bleiben gültig.
+    TEST_ASSERT_EQUAL_INT(1, drv_write(direct, "x", 1));
+    TEST_ASSERT_TRUE(tst_sink_equals("10x"));
+    TEST_ASSERT_EQUAL_INT(0, drv_close(direct));
+
+    // Zurücknehmen: Der Name öffnet wieder das Ziel.
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_unstack(drv_dio, &tst_filter));
+    drv = drv_open(drv_dio, "flt_pin");
+    TEST_ASSERT_EQUAL_PTR(&tst_target, drv);
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+
+    // Das Ziel war nie abgemeldet: Freigabe erst mit drv_deregister().
+    TEST_ASSERT_EQUAL_INT(0, tst_released);
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(drv_dio, &tst_target));
+    TEST_ASSERT_EQUAL_INT(1, tst_released);
+}
+
+void test_filter_stack_failed_should_keep_target(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_init(&tst_filter, &tst_target, 16, 0));
+
+    // Ziel nicht registriert, Filter nicht gestapelt.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_stack(drv_dio, &tst_filter));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_unstack(drv_dio, &tst_filter));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+
+    // Filter schon registriert: Nichts ändert sich, das Ziel bleibt erreichbar.
+    TEST_ASSERT_EQUAL_INT(0, drv_register(drv_dio, "flt_pin", &tst_target));
+    TEST_ASSERT_EQUAL_INT(0, drv_register(drv_dio, "flt_other", drv_filter_driver(&tst_filter)));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_filter_stack(drv_dio, &tst_filter));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+    driver_t* drv = drv_open(drv_dio, "flt_pin");
+    TEST_ASSERT_EQUAL_PTR(&tst_target, drv);
+    TEST_ASSERT_EQUAL_INT(0, drv_close(drv));
+
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(drv_dio, drv_filter_driver(&tst_filter)));
+    TEST_ASSERT_EQUAL_INT(0, drv_filter_destroy(&tst_filter));
+    TEST_ASSERT_EQUAL_INT(0, drv_deregister(drv_dio, &tst_target));
+    TEST_ASSERT_EQUAL_INT(1, tst_released);
+}
+
+void test_drv_filter_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_filter_param_check_should_fail);
+    RUN(test_filter_should_coalesce_by_size);
+    RUN(test_filter_should_flush_before_other_calls);
+    RUN(test_filter_should_flush_after_window);
+    RUN(test_filter_should_report_deferred_error);
+    RUN(test_filter_stack_should_be_transparent);
+    RUN(test_filter_stack_failed_should_keep_target);
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_FILTER_H_
+#define _TEST_DRV_FILTER_H_
+
+void test_drv_filter_setUp(void);
+void test_drv_filter_tearDown(void);
+void test_drv_filter_run_all();
+
+#endif //_TEST_DRV_FILTER_H_
@@ -0,0 +1,123 @@
+#include "unity.h"
+#include "registry.h"
+#include "drv_mph.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// Generated from test_drv_mph.names by drv_mph_generate().
+extern const drv_mph_table_t DRV_MPH_TABLE;
+
+// ---- Dummy-Kontext und Treiber ----
+static driver_t tst_parent = { .name = "MphParent", .type = DRV_TEST };
+static const driver_t* tst_parent_handle = &tst_parent;
+
+static driver_ctx_t ctx_a = { .reg_name = NULL };
+static driver_ctx_t ctx_b = { .reg_name = NULL };
+static driver_ctx_t ctx_unlisted = { .reg_name = NULL };
+static driver_ctx_t ctx_dyn = { .reg_name = "reg_pin7" };
+
+static driver_t drv_a = { .name = "mph_a", .type = DRV_TEST, .ctx = &ctx_a };
+static driver_t drv_b = { .name = "mph_b", .type = DRV_TEST, .ctx = &ctx_b };
+static driver_t drv_unlisted = { .name = "mph_unlisted", .type = DRV_TEST, .ctx = &ctx_unlisted };
+static driver_t drv_dyn = { .name = "pin7", .type = DRV_TEST, .ctx = &ctx_dyn };
+
+DRV_STATIC_REGISTER(tst_parent_handle, "reg_mph_a", &drv_a);
+DRV_STATIC_REGISTER(tst_parent_handle, "reg_mph_b", &drv_b);
+DRV_STATIC_REGISTER(tst_parent_handle, "reg_mph_unlisted", &drv_unlisted);
+
+// ---- Testobjekt ----
+static registry_t reg;
+static const drv_mph_table_t* table = &DRV_MPH_TABLE;
+
+void test_drv_mph_setUp(void)
+{
+    memset(&reg, 0, sizeof(registry_t));
+    memset(table->slots, 0, table->size * sizeof(driver_t*));
+}
+
+void test_drv_mph_tearDown(void)
+{
+    free(reg.driver_list);
+    free(reg.name_index);
+    free(reg.reg_name_index);
+    free(reg.used_map);
+    free(reg.generations);
+    ptr_index_free(&reg.driver_index);
+    memset(&reg, 0, sizeof(registry_t));
+    memset(table->slots, 0, table->size * sizeof(driver_t*));
+}
+
+// ---- Generierte Tabelle ----
+void test_mph_table_should_be_minimal_and_perfect(void)
+{
+    TEST_ASSERT_EQUAL_INT(202, table->size);
+
+    bool* used = calloc(table->size, sizeof(bool));
+    TEST_ASSERT_NOT_NULL(used);
+    for (uint32_t slot = 0; slot < table->size; slot++) {
+        uint32_t index = drv_mph_index(table, table->keys[slot]);
+        TEST_ASSERT_EQUAL_INT(slot, index);
+        TEST_ASSERT_FALSE(used[index]);
+        used[index] = true;
+    }
+    free(used);
+}
+
+// ---- drv_mph_bind / drv_mph_find ----
+void test_mph_find_should_only_return_bound_drivers(void)
+{
+    const drv_static_entry_t* list;
+    size_t count = drv_static_get(&tst_parent, &list);
+    TEST_ASSERT_EQUAL_INT(3, count);
+
+    TEST_ASSERT_NULL(drv_mph_find(table, "mph_a"));
+    TEST_ASSERT_EQUAL_INT(2, drv_mph_bind(table, list, count));      // mph_unlisted is not in the table.
+    TEST_ASSERT_EQUAL_PTR(&drv_a, drv_mph_find(table, "mph_a"));
+    TEST_ASSERT_EQUAL_PTR(&drv_b, drv_mph_find(table, "mph_b"));
+    TEST_ASSERT_NULL(drv_mph_find(table, "mph_unlisted"));
+    TEST_ASSERT_NULL(drv_mph_find(table, "pin7"));                   // In the table, but not bound.
+    TEST_ASSERT_NULL(drv_mph_find(table, "unknown"));
+    TEST_ASSERT_NULL(drv_mph_find(NULL, "mph_a"));
+}
+
+// ---- registry_attach_mph ----
+void test_attach_mph_should_find_drivers(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, registry_attach_static(&reg, &tst_parent));
+    TEST_ASSERT_EQUAL_INT(0, registry_attach_mph(&reg, table));
+    TEST_ASSERT_EQUAL_PTR(table, reg.mph);
+
+    TEST_ASSERT_EQUAL_PTR(&drv_a, registry_get_driver_by_name(&reg, "mph_a"));
+    TEST_ASSERT_EQUAL_PTR(&drv_unlisted, registry_get_driver_by_name(&reg, "mph_unlisted"));
+    TEST_ASSERT_NULL(reg.driver_list);         // No allocation.
+
+    // Name in the table, driver registered at runtime: Found by the dynamic index.
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv_dyn));
+    TEST_ASSERT_EQUAL_PTR(&drv_dyn, registry_get_driver_by_name(&reg, "pin7"));
+
+    errno = 0;
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&reg, "pin8"));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+}
+
+void test_attach_mph_invalid_param_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_attach_mph(&reg, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_attach_mph(NULL, table));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_drv_mph_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_mph_table_should_be_minimal_and_perfect);
+    RUN(test_mph_find_should_only_return_bound_drivers);
+    RUN(test_attach_mph_should_find_drivers);
+    RUN(test_attach_mph_invalid_param_should_fail);
+#undef RUN
+}
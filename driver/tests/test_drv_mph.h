@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_MPH_H_
+#define _TEST_DRV_MPH_H_
+
+void test_drv_mph_setUp(void);
+void test_drv_mph_tearDown(void);
+void test_drv_mph_run_all();
+
+#endif //_TEST_DRV_MPH_H_
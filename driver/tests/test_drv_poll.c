@@ -0,0 +1,245 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_wait.h"
+#include "drv_dio.h"
+#include "tst_time.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TST_PIPES   (64U)
+
+// ---- Dummy-Treiber: Lesbar, sobald avail > 0 ----
+typedef struct {
+    driver_ctx_t ctx;
+    _Atomic int avail;
+} tst_pipe_t;
+
+static tst_pipe_t tst_pipes[TST_PIPES];
+static driver_t tst_drv[TST_PIPES];
+static int tst_released;
+
+static short tst_pipe_poll(driver_t* driver, short events) {
+    tst_pipe_t* pipe = (tst_pipe_t*)driver->ctx;
+    return (atomic_load(&pipe->avail) > 0) ? (POLLIN | POLLRDNORM) : 0;
+}
+
+static void tst_pipe_release(driver_t* driver) {
+    tst_released++;
+}
+
+static const driver_fops_t tst_pipe_fops = {
+    .poll = tst_pipe_poll,
+    .release = tst_pipe_release,
+};
+
+// Ohne poll fop: Immer bereit.
+static const driver_fops_t tst_plain_fops = { 0 };
+static driver_t tst_plain = { .name = "plain", .fops = &tst_plain_fops };
+
+// Basistreiber für die Deregistrierung.
+static int tst_reg_drv(driver_t* base_driver, const char* name, driver_t* driver) {
+    return 0;
+}
+
+static int tst_dereg_drv(driver_t* base_driver, driver_t* driver) {
+    return 0;
+}
+
+static const driver_fops_t tst_root_fops = {
+    .reg_drv = tst_reg_drv,
+    .dereg_drv = tst_dereg_drv,
+};
+static driver_t tst_root = { .name = "poll_root", .fops = &tst_root_fops };
+
+// Daten bereitstellen und Wartende wecken, wie es ein Treiber tut.
+static void tst_pipe_put(size_t i) {
+    atomic_fetch_add(&tst_pipes[i].avail, 1);
+    drv_wake(&tst_drv[i]);
+}
+
+void test_drv_poll_setUp(void)
+{
+    memset(tst_pipes, 0, sizeof(tst_pipes));
+    for (size_t i = 0; i < TST_PIPES; i++) {
+        // driver_t hat const Felder: Kopie statt Zuweisung.
+        memcpy(&tst_drv[i], &(driver_t){ .name = "pipe", .fops = &tst_pipe_fops, .ctx = &tst_pipes[i].ctx }, sizeof(driver_t));
+    }
+    tst_released = 0;
+}
+
+void test_drv_poll_tearDown(void)
+{
+}
+
+void test_poll_param_check_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_poll(NULL, 1, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_poll(NULL, 0, 0));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_wake(NULL));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_eventfd_open(NULL, POLLIN));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_eventfd_open(&tst_plain, POLLIN));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_eventfd_close(&tst_drv[0], -1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_poll_should_report_ready_drivers(void)
+{
+    atomic_store(&tst_pipes[1].avail, 1);
+    drv_pollfd_t fds[] = {
+        { .driver = &tst_drv[0], .events = POLLIN },
+        { .driver = &tst_drv[1], .events = POLLIN },
+        { .driver = &tst_plain, .events = POLLOUT },
+        { .driver = NULL, .events = POLLIN },
+        { .driver = &tst_drv[1], .events = POLLOUT },
+    };
+    // NULL zählt als bereit (POLLNVAL), wie ein ungültiger fd bei poll().
+    TEST_ASSERT_EQUAL_INT(3, drv_poll(fds, 5, 0));
+    TEST_ASSERT_EQUAL_INT(0, fds[0].revents);
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[1].revents);
+    TEST_ASSERT_EQUAL_INT(POLLOUT, fds[2].revents);
+    TEST_ASSERT_EQUAL_INT(POLLNVAL, fds[3].revents);
+    TEST_ASSERT_EQUAL_INT(0, fds[4].revents);
+}
+
+void test_poll_should_report_error_without_io(void)
+{
+    // Der DIO-Treiber liest und schreibt selbst nie: Sofort POLLERR statt Warten bis zum Timeout.
+    drv_pollfd_t fds[] = { { .driver = (driver_t*)drv_dio, .events = POLLIN | POLLOUT } };
+    TEST_ASSERT_EQUAL_INT(1, drv_poll(fds, 1, 5000));
+    TEST_ASSERT_EQUAL_INT(POLLERR, fds[0].revents);
+}
+
+void test_poll_should_time_out(void)
+{
+    drv_pollfd_t fds[] = {
+        { .driver = &tst_drv[0], .events = POLLIN },
+        { .driver = &tst_drv[1], .events = POLLIN },
+    };
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TEST_ASSERT_EQUAL_INT(0, drv_poll(fds, 2, 20));
+    TEST_ASSERT_TRUE(tst_elapsed_ms(&start) >= 19);
+    TEST_ASSERT_EQUAL_INT(0, fds[0].revents);
+    TEST_ASSERT_EQUAL_INT(0, fds[1].revents);
+
+    // Keine Registrierung bleibt zurück.
+    TEST_ASSERT_NULL(tst_pipes[0].ctx.wait.head);
+    TEST_ASSERT_NULL(tst_pipes[1].ctx.wait.head);
+}
+
+// Weckt nach kurzer Zeit den letzten Treiber.
+static void* tst_waker(void* arg) {
+    struct timespec delay = { .tv_nsec = 5000000L };
+    nanosleep(&delay, NULL);
+    tst_pipe_put(TST_PIPES - 1);
+    return NULL;
+}
+
+void test_poll_should_wake_on_change(void)
+{
+    drv_pollfd_t fds[TST_PIPES];
+    for (size_t i = 0; i < TST_PIPES; i++) {
+        fds[i] = (drv_pollfd_t){ .driver = &tst_drv[i], .events = POLLIN };
+    }
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_waker, NULL));
+    // Ohne Timeout: Kehrt nur durch das Wecken zurück.
+    TEST_ASSERT_EQUAL_INT(1, drv_poll(fds, TST_PIPES, -1));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[TST_PIPES - 1].revents);
+    for (size_t i = 0; i < TST_PIPES - 1; i++) {
+        TEST_ASSERT_EQUAL_INT(0, fds[i].revents);
+        TEST_ASSERT_NULL(tst_pipes[i].ctx.wait.head);
+    }
+}
+
+// Deregistriert tst_drv[0] nach kurzer Zeit.
+static void* tst_deregister(void* arg) {
+    struct timespec delay = { .tv_nsec = 5000000L };
+    nanosleep(&delay, NULL);
+    *(int*)arg = drv_deregister(&tst_root, &tst_drv[0]);
+    return NULL;
+}
+
+void test_poll_should_hang_up_on_deregister(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, drv_register(&tst_root, "pipe0", &tst_drv[0]));
+    TEST_ASSERT_EQUAL_INT(0, drv_open_acquire(&tst_drv[0]));
+
+    drv_pollfd_t fds[] = { { .driver = &tst_drv[0], .events = POLLIN } };
+    pthread_t thread;
+    int result = -1;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_deregister, &result));
+    TEST_ASSERT_EQUAL_INT(1, drv_poll(fds, 1, 5000));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+    TEST_ASSERT_EQUAL_INT(0, result);
+    TEST_ASSERT_EQUAL_INT(POLLHUP, fds[0].revents);
+
+    // drv_poll() hält den Treiber nicht fest: Freigabe mit dem letzten close.
+    TEST_ASSERT_EQUAL_INT(0, tst_released);
+    TEST_ASSERT_EQUAL_INT(0, drv_open_release(&tst_drv[0]));
+    TEST_ASSERT_EQUAL_INT(1, tst_released);
+}
+
+void test_eventfd_should_signal_changes(void)
+{
+#ifdef __linux__
+    uint64_t value = 0;
+    int fd = drv_eventfd_open(&tst_drv[0], POLLIN);
+    TEST_ASSERT_TRUE(fd >= 0);
+    // Nicht bereit: Nicht lesbar.
+    TEST_ASSERT_EQUAL_INT(-1, read(fd, &value, sizeof(value)));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    tst_pipe_put(0);
+    TEST_ASSERT_EQUAL_INT(1, poll(&pfd, 1, 0));
+    TEST_ASSERT_EQUAL_INT(sizeof(value), read(fd, &value, sizeof(value)));
+    TEST_ASSERT_EQUAL_INT(1, value);
+
+    // Schon bereit: Sofort lesbar.
+    int fd2 = drv_eventfd_open(&tst_drv[0], POLLIN);
+    TEST_ASSERT_TRUE(fd2 >= 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(value), read(fd2, &value, sizeof(value)));
+
+    TEST_ASSERT_EQUAL_INT(0, drv_eventfd_close(&tst_drv[0], fd));
+    TEST_ASSERT_EQUAL_INT(0, drv_eventfd_close(&tst_drv[0], fd2));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_eventfd_close(&tst_drv[0], fd));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    TEST_ASSERT_NULL(tst_pipes[0].ctx.wait.head);
+#else
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_eventfd_open(&tst_drv[0], POLLIN));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+#endif
+}
+
+void test_drv_poll_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_poll_param_check_should_fail);
+    RUN(test_poll_should_report_ready_drivers);
+    RUN(test_poll_should_report_error_without_io);
+    RUN(test_poll_should_time_out);
+    RUN(test_poll_should_wake_on_change);
+    RUN(test_poll_should_hang_up_on_deregister);
+    RUN(test_eventfd_should_signal_changes);
+#undef RUN
+}
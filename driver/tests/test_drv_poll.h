@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_POLL_H_
+#define _TEST_DRV_POLL_H_
+
+void test_drv_poll_setUp(void);
+void test_drv_poll_tearDown(void);
+void test_drv_poll_run_all();
+
+#endif //_TEST_DRV_POLL_H_
@@ -0,0 +1,304 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_ring.h"
+#include "registry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// ---- Dummy-Treiber: Verzeichnis mit einem synchronen und einem asynchronen Treiber ----
+static registry_t tst_reg;
+static int tst_submits;
+static drv_ring_t* tst_deferred_ring;               // Request of the async driver, completed by the test.
+static const drv_sqe_t* tst_deferred_sqe;
+
+static driver_t* tst_dir_open(driver_t* base_driver, const char* name) {
+    driver_t* driver = registry_get_driver_by_name(&tst_reg, name);
+    if (driver == NULL) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return (drv_open_acquire(driver) == 0) ? driver : NULL;
+}
+
+static ssize_t tst_sync_read(driver_t* driver, void* buffer, size_t count) {
+    memset(buffer, 0xA5, count);
+    return (ssize_t)count;
+}
+
+static ssize_t tst_sync_write(driver_t* driver, const void* buffer, size_t count) {
+    return (ssize_t)count;
+}
+
+static int tst_sync_ioctl(driver_t* driver, size_t id, void* param) {
+    if (id != 7) {
+        errno = ENOTTY;
+        return -1;
+    }
+    *(int*)param = 42;
+    return 0;
+}
+
+// Reads complete at once, writes are completed later by the test, ioctls fail.
+static int tst_async_submit(drv_file_t* file, const drv_sqe_t* sqe, drv_ring_t* ring) {
+    tst_submits++;
+    switch (sqe->op) {
+        case DRV_OP_READ:
+            drv_ring_complete(ring, sqe, (ssize_t)sqe->len);
+            return 0;
+        case DRV_OP_WRITE:
+            tst_deferred_ring = ring;
+            tst_deferred_sqe = sqe;
+            return 0;
+        default:
+            errno = ENOTSUP;
+            return -1;
+    }
+}
+
+static const driver_fops_t tst_dir_fops = { .open = tst_dir_open };
+static const driver_fops_t tst_sync_fops = {
+    .close = drv_open_release,
+    .read = tst_sync_read,
+    .write = tst_sync_write,
+    .ioctl = tst_sync_ioctl,
+};
+static const driver_fops_t tst_async_fops = {
+    .close = drv_open_release,
+    .read = tst_sync_read,
+    .submit = tst_async_submit,
+};
+
+static driver_t tst_dir = { .name = "dir", .fops = &tst_dir_fops };
+static driver_ctx_t tst_sync_ctx = { .open_max = 0 };
+static driver_t tst_sync = { .name = "sync", .fops = &tst_sync_fops, .ctx = &tst_sync_ctx };
+static driver_ctx_t tst_async_ctx = { .open_max = 0 };
+static driver_t tst_async = { .name = "async", .fops = &tst_async_fops, .ctx = &tst_async_ctx };
+
+// Returns the completion of a request.
+static drv_cqe_t* tst_find(drv_cqe_t* cqes, int count, uint64_t user_data) {
+    for (int i = 0; i < count; i++) {
+        if (cqes[i].user_data == user_data) {
+            return &cqes[i];
+        }
+    }
+    TEST_FAIL_MESSAGE("completion missing");
+    return NULL;
+}
+
+// ---- Setup / Cleanup -----
+void test_drv_ring_setUp(void)
+{
+    // Also called for the whole group (nested RUN_TEST): register only once.
+    if (registry_get_driver_by_name(&tst_reg, "sync") == NULL) {
+        registry_add_driver(&tst_reg, &tst_sync);
+        registry_add_driver(&tst_reg, &tst_async);
+    }
+    tst_submits = 0;
+    tst_deferred_ring = NULL;
+    tst_deferred_sqe = NULL;
+}
+
+void test_drv_ring_tearDown(void)
+{
+    registry_remove_driver(&tst_reg, &tst_sync);
+    registry_remove_driver(&tst_reg, &tst_async);
+    registry_free_registry(&tst_reg);
+}
+
+// ---- drv_ring_create / drv_ring_destroy ----
+void test_ring_create_param_check_should_fail(void) {
+    errno = 0;
+    TEST_ASSERT_NULL(drv_ring_create(0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_ring_create(3));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_ring_create(DRV_RING_MAX * 2U));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    drv_ring_destroy(NULL);
+
+    errno = 0;
+    TEST_ASSERT_NULL(drv_ring_get_sqe(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT(-1, drv_submit(NULL));
+    TEST_ASSERT_EQUAL_INT(-1, drv_reap(NULL, NULL, 0, 0));
+}
+
+// ---- drv_submit / drv_reap ----
+void test_ring_nop_should_complete(void) {
+    drv_ring_t* ring = drv_ring_create(4);
+    TEST_ASSERT_NOT_NULL(ring);
+    drv_sqe_t* sqe = drv_ring_get_sqe(ring);
+    TEST_ASSERT_NOT_NULL(sqe);
+    sqe->user_data = 0x1234;
+
+    drv_cqe_t cqe;
+    TEST_ASSERT_EQUAL_INT(0, drv_reap(ring, &cqe, 1, 1));   // Nothing submitted: Doesn't block.
+    TEST_ASSERT_EQUAL_INT(1, drv_submit(ring));
+    TEST_ASSERT_EQUAL_INT(1, drv_reap(ring, &cqe, 1, 1));
+    TEST_ASSERT_EQUAL_INT(0x1234, cqe.user_data);
+    TEST_ASSERT_EQUAL_INT(0, cqe.result);
+    drv_ring_destroy(ring);
+}
+
+void test_ring_sync_driver_should_run_on_workers(void) {
+    int fd = drv_fopen(&tst_dir, "sync", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    drv_ring_t* ring = drv_ring_create(8);
+    TEST_ASSERT_NOT_NULL(ring);
+
+    uint8_t buffer[16] = { 0 };
+    int param = 0;
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .buffer = buffer, .len = sizeof(buffer), .user_data = 1 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_WRITE, .fd = fd, .buffer = buffer, .len = 5, .user_data = 2 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_IOCTL, .fd = fd, .buffer = &param, .len = 7, .user_data = 3 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_IOCTL, .fd = fd, .buffer = &param, .len = 8, .user_data = 4 };
+    TEST_ASSERT_EQUAL_INT(4, drv_submit(ring));
+
+    drv_cqe_t cqes[8];
+    int count = 0;
+    while (count < 4) {
+        count += drv_reap(ring, &cqes[count], 8 - count, 1);
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(buffer), tst_find(cqes, count, 1)->result);
+    TEST_ASSERT_EQUAL_INT(0xA5, buffer[15]);
+    TEST_ASSERT_EQUAL_INT(5, tst_find(cqes, count, 2)->result);
+    TEST_ASSERT_EQUAL_INT(0, tst_find(cqes, count, 3)->result);
+    TEST_ASSERT_EQUAL_INT(42, param);
+    TEST_ASSERT_EQUAL_INT(-ENOTTY, tst_find(cqes, count, 4)->result);
+
+    drv_ring_destroy(ring);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_ring_invalid_request_should_complete_with_error(void) {
+    int fd = drv_fopen(&tst_dir, "sync", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));   // fd is stale now.
+    drv_ring_t* ring = drv_ring_create(2);
+    TEST_ASSERT_NOT_NULL(ring);
+
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .len = 0, .user_data = 1 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = (drv_op_t)99, .fd = fd, .user_data = 2 };
+    TEST_ASSERT_EQUAL_INT(2, drv_submit(ring));
+
+    drv_cqe_t cqes[2];
+    TEST_ASSERT_EQUAL_INT(2, drv_reap(ring, cqes, 2, 2));
+    TEST_ASSERT_EQUAL_INT(-EBADF, tst_find(cqes, 2, 1)->result);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, tst_find(cqes, 2, 2)->result);
+    drv_ring_destroy(ring);
+}
+
+void test_ring_async_driver_should_use_submit_fop(void) {
+    int fd = drv_fopen(&tst_dir, "async", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    drv_ring_t* ring = drv_ring_create(4);
+    TEST_ASSERT_NOT_NULL(ring);
+
+    uint8_t buffer[4] = { 0 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .buffer = buffer, .len = 4, .user_data = 1 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_WRITE, .fd = fd, .buffer = buffer, .len = 3, .user_data = 2 };
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_IOCTL, .fd = fd, .user_data = 3 };
+    TEST_ASSERT_EQUAL_INT(3, drv_submit(ring));
+    TEST_ASSERT_EQUAL_INT(3, tst_submits);
+    TEST_ASSERT_EQUAL_INT(0, buffer[0]);            // Not executed by drv_fread().
+
+    drv_cqe_t cqes[4];
+    TEST_ASSERT_EQUAL_INT(2, drv_reap(ring, cqes, 4, 0));
+    TEST_ASSERT_EQUAL_INT(4, tst_find(cqes, 2, 1)->result);
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP, tst_find(cqes, 2, 3)->result);
+
+    // Write is still in flight.
+    TEST_ASSERT_EQUAL_INT(0, drv_reap(ring, cqes, 4, 0));
+    TEST_ASSERT_NOT_NULL(tst_deferred_sqe);
+    const drv_sqe_t foreign = *tst_deferred_sqe;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_ring_complete(tst_deferred_ring, &foreign, 0));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_ring_complete(tst_deferred_ring, tst_deferred_sqe, (ssize_t)tst_deferred_sqe->len));
+    TEST_ASSERT_EQUAL_INT(1, drv_reap(ring, cqes, 4, 1));
+    TEST_ASSERT_EQUAL_INT(2, cqes[0].user_data);
+    TEST_ASSERT_EQUAL_INT(3, cqes[0].result);
+
+    drv_ring_destroy(ring);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_ring_full_should_fail(void) {
+    drv_ring_t* ring = drv_ring_create(2);          // SQ: 2, CQ: 4
+    TEST_ASSERT_NOT_NULL(ring);
+
+    TEST_ASSERT_NOT_NULL(drv_ring_get_sqe(ring));
+    TEST_ASSERT_NOT_NULL(drv_ring_get_sqe(ring));
+    errno = 0;
+    TEST_ASSERT_NULL(drv_ring_get_sqe(ring));
+    TEST_ASSERT_EQUAL_INT(EBUSY, errno);
+    TEST_ASSERT_EQUAL_INT(2, drv_submit(ring));
+    TEST_ASSERT_EQUAL_INT(0, drv_submit(ring));
+
+    // CQ has room for 2 more requests: The third stays queued.
+    TEST_ASSERT_NOT_NULL(drv_ring_get_sqe(ring));
+    TEST_ASSERT_NOT_NULL(drv_ring_get_sqe(ring));
+    TEST_ASSERT_EQUAL_INT(2, drv_submit(ring));
+    TEST_ASSERT_NOT_NULL(drv_ring_get_sqe(ring));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_submit(ring));
+    TEST_ASSERT_EQUAL_INT(EBUSY, errno);
+
+    drv_cqe_t cqes[4];
+    TEST_ASSERT_EQUAL_INT(4, drv_reap(ring, cqes, 4, 4));
+    TEST_ASSERT_EQUAL_INT(1, drv_submit(ring));
+    TEST_ASSERT_EQUAL_INT(1, drv_reap(ring, cqes, 4, 1));
+    drv_ring_destroy(ring);
+}
+
+void test_ring_many_requests_should_complete(void) {
+    enum { TST_REQUESTS = 2000 };
+    int fd = drv_fopen(&tst_dir, "sync", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    drv_ring_t* ring = drv_ring_create(64);
+    TEST_ASSERT_NOT_NULL(ring);
+
+    static uint8_t buffers[128][8];                 // One per CQ entry: Requests in flight don't share a buffer.
+    uint64_t sum = 0;
+    size_t reaped = 0;
+    size_t queued = 0;
+    drv_cqe_t cqes[64];
+    while (reaped < TST_REQUESTS) {
+        drv_sqe_t* sqe;
+        while ((queued < TST_REQUESTS) && ((sqe = drv_ring_get_sqe(ring)) != NULL)) {
+            *sqe = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .buffer = buffers[queued % 128], .len = 8, .user_data = queued };
+            queued++;
+        }
+        drv_submit(ring);
+        int count = drv_reap(ring, cqes, 64, 1);
+        TEST_ASSERT_TRUE(count >= 0);
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL_INT(8, cqes[i].result);
+            sum += cqes[i].user_data;
+        }
+        reaped += (size_t)count;
+    }
+    TEST_ASSERT_EQUAL_INT((uint64_t)TST_REQUESTS * (TST_REQUESTS - 1) / 2, sum);
+
+    // Destroy with requests in flight waits for them.
+    *drv_ring_get_sqe(ring) = (drv_sqe_t){ .op = DRV_OP_READ, .fd = fd, .buffer = buffers[0], .len = 8 };
+    TEST_ASSERT_EQUAL_INT(1, drv_submit(ring));
+    drv_ring_destroy(ring);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_drv_ring_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_ring_create_param_check_should_fail);
+    RUN(test_ring_nop_should_complete);
+    RUN(test_ring_sync_driver_should_run_on_workers);
+    RUN(test_ring_invalid_request_should_complete_with_error);
+    RUN(test_ring_async_driver_should_use_submit_fop);
+    RUN(test_ring_full_should_fail);
+    RUN(test_ring_many_requests_should_complete);
+#undef RUN
+}
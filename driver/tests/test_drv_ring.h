@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_RING_H_
+#define _TEST_DRV_RING_H_
+
+void test_drv_ring_setUp(void);
+void test_drv_ring_tearDown(void);
+void test_drv_ring_run_all();
+
+#endif //_TEST_DRV_RING_H_
@@ -0,0 +1,183 @@
+#include "unity.h"
+#include "registry.h"
+#include "drv_static.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// ---- Dummy-Kontext und Treiber ----
+static driver_t tst_parent = { .name = "StaticParent", .type = DRV_TEST };
+static driver_t tst_other_parent = { .name = "OtherParent", .type = DRV_TEST };
+static const driver_t* tst_parent_handle = &tst_parent;
+
+static driver_ctx_t ctx_a = { .reg_name = NULL };
+static driver_ctx_t ctx_b = { .reg_name = NULL };
+static driver_ctx_t ctx_dyn = { .reg_name = "reg_dynamic" };
+
+static driver_t drv_a = { .name = "static_a", .type = DRV_TEST, .ctx = &ctx_a };
+static driver_t drv_b = { .name = "static_b", .type = DRV_TEST, .ctx = &ctx_b };
+static driver_t drv_dyn = { .name = "dynamic", .type = DRV_TEST, .ctx = &ctx_dyn };
+
+// Registered in reverse order, the table is sorted at runtime.
+DRV_STATIC_REGISTER(tst_parent_handle, "reg_static_b", &drv_b);
+DRV_STATIC_REGISTER(tst_parent_handle, "reg_static_a", &drv_a);
+
+// Zweiter Elterntreiber mit Duplikaten.
+static driver_t tst_dup_parent = { .name = "DupParent", .type = DRV_TEST };
+static const driver_t* tst_dup_parent_handle = &tst_dup_parent;
+
+static driver_ctx_t ctx_c = { .reg_name = NULL };
+static driver_ctx_t ctx_d = { .reg_name = NULL };
+static driver_ctx_t ctx_dup1 = { .reg_name = NULL };
+static driver_ctx_t ctx_dup2 = { .reg_name = NULL };
+static driver_ctx_t ctx_twice = { .reg_name = NULL };
+
+static driver_t drv_c = { .name = "static_c", .type = DRV_TEST, .ctx = &ctx_c };
+static driver_t drv_d = { .name = "static_d", .type = DRV_TEST, .ctx = &ctx_d };
+static driver_t drv_dup1 = { .name = "static_dup1", .type = DRV_TEST, .ctx = &ctx_dup1 };
+static driver_t drv_dup2 = { .name = "static_dup2", .type = DRV_TEST, .ctx = &ctx_dup2 };
+static driver_t drv_twice = { .name = "static_twice", .type = DRV_TEST, .ctx = &ctx_twice };
+
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_z", &drv_c);
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_y", &drv_d);
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_dup", &drv_dup1);
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_dup", &drv_dup2);
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_twice1", &drv_twice);
+DRV_STATIC_REGISTER(tst_dup_parent_handle, "reg_twice2", &drv_twice);
+
+// ---- Testobjekt ----
+static registry_t reg;
+
+void test_drv_static_setUp(void)
+{
+    memset(&reg, 0, sizeof(registry_t));
+}
+
+void test_drv_static_tearDown(void)
+{
+    free(reg.driver_list);
+    free(reg.name_index);
+    free(reg.reg_name_index);
+    free(reg.used_map);
+    free(reg.generations);
+    ptr_index_free(&reg.driver_index);
+    memset(&reg, 0, sizeof(registry_t));
+}
+
+// ---- drv_static_get ----
+void test_static_get_should_return_drivers_of_parent(void)
+{
+    const drv_static_entry_t* list;
+    TEST_ASSERT_EQUAL_INT(2, drv_static_get(&tst_parent, &list));
+    TEST_ASSERT_EQUAL_PTR(&drv_a, list[0].driver);
+    TEST_ASSERT_EQUAL_PTR(&drv_b, list[1].driver);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_static_get(&tst_other_parent, &list));
+    TEST_ASSERT_NULL(list);
+}
+
+void test_static_init_should_set_parent_and_reg_name(void)
+{
+    drv_static_init();
+    TEST_ASSERT_EQUAL_STRING("reg_static_a", ctx_a.reg_name);
+    TEST_ASSERT_EQUAL_PTR(&tst_parent, ctx_a.parent);
+    TEST_ASSERT_EQUAL_STRING("reg_static_b", ctx_b.reg_name);
+}
+
+void test_static_find_by_reg_name_should_find_all(void)
+{
+    const drv_static_entry_t* list;
+    size_t count = drv_static_get(&tst_dup_parent, &list);
+    TEST_ASSERT_EQUAL_INT(2, count);
+    TEST_ASSERT_EQUAL_PTR(&drv_c, drv_static_find_by_reg_name(list, count, "reg_z"));
+    TEST_ASSERT_EQUAL_PTR(&drv_d, drv_static_find_by_reg_name(list, count, "reg_y"));
+    TEST_ASSERT_NULL(drv_static_find_by_reg_name(list, count, "reg_x"));
+    TEST_ASSERT_NULL(drv_static_find_by_reg_name(list, count, "reg_zz"));
+}
+
+void test_static_duplicates_should_be_rejected(void)
+{
+    const drv_static_entry_t* list;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_static_init());
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+
+    // Keiner der Duplikate wird gefunden oder gebunden.
+    size_t count = drv_static_get(&tst_dup_parent, &list);
+    TEST_ASSERT_NULL(drv_static_find_by_reg_name(list, count, "reg_dup"));
+    TEST_ASSERT_NULL(drv_static_find_by_name(list, count, "static_dup1"));
+    TEST_ASSERT_NULL(drv_static_find_by_reg_name(list, count, "reg_twice1"));
+    TEST_ASSERT_FALSE(drv_static_contains(list, count, &drv_twice));
+    TEST_ASSERT_NULL(ctx_dup1.reg_name);
+    TEST_ASSERT_NULL(ctx_twice.reg_name);
+    TEST_ASSERT_EQUAL_STRING("reg_y", ctx_d.reg_name);
+
+    // Die anderen Eltern sind nicht betroffen.
+    TEST_ASSERT_EQUAL_INT(2, drv_static_get(&tst_parent, &list));
+}
+
+// ---- registry_attach_static ----
+void test_attach_static_should_find_static_drivers(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, registry_attach_static(&reg, &tst_parent));
+    TEST_ASSERT_EQUAL_PTR(&drv_a, registry_get_driver_by_name(&reg, "static_a"));
+    TEST_ASSERT_EQUAL_PTR(&drv_b, registry_get_driver_by_reg_name(&reg, "reg_static_b"));
+    TEST_ASSERT_NULL(reg.driver_list);         // No allocation.
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_attach_static(NULL, &tst_parent));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_attach_static_should_allow_runtime_registration(void)
+{
+    registry_attach_static(&reg, &tst_parent);
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv_dyn));
+    TEST_ASSERT_EQUAL_PTR(&drv_dyn, registry_get_driver_by_name(&reg, "dynamic"));
+    TEST_ASSERT_EQUAL_PTR(&drv_a, registry_get_driver_by_name(&reg, "static_a"));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &drv_dyn));
+}
+
+void test_attach_static_duplicates_should_fail(void)
+{
+    const char* reg_name = ctx_dyn.reg_name;
+    registry_attach_static(&reg, &tst_parent);
+
+    // Static driver again
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_driver(&reg, &drv_a));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+
+    // Same registered name as a static driver
+    errno = 0;
+    ctx_dyn.reg_name = "reg_static_a";
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_driver(&reg, &drv_dyn));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+
+    //Cleanup
+    ctx_dyn.reg_name = reg_name;
+}
+
+void test_attach_static_remove_should_fail(void)
+{
+    registry_attach_static(&reg, &tst_parent);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_remove_driver(&reg, &drv_a));
+    TEST_ASSERT_EQUAL_INT(EPERM, errno);
+    TEST_ASSERT_EQUAL_PTR(&drv_a, registry_get_driver_by_name(&reg, "static_a"));
+}
+
+void test_drv_static_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_static_get_should_return_drivers_of_parent);
+    RUN(test_static_init_should_set_parent_and_reg_name);
+    RUN(test_static_find_by_reg_name_should_find_all);
+    RUN(test_static_duplicates_should_be_rejected);
+    RUN(test_attach_static_should_find_static_drivers);
+    RUN(test_attach_static_should_allow_runtime_registration);
+    RUN(test_attach_static_duplicates_should_fail);
+    RUN(test_attach_static_remove_should_fail);
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_STATIC_H_
+#define _TEST_DRV_STATIC_H_
+
+void test_drv_static_setUp(void);
+void test_drv_static_tearDown(void);
+void test_drv_static_run_all();
+
+#endif //_TEST_DRV_STATIC_H_
@@ -0,0 +1,253 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+// ---- Dummy-Treiber: Liest und schreibt count Bytes, schlägt bei count == 0 mit EIO fehl ----
+static ssize_t tst_read(driver_t* driver, void* buffer, size_t count) {
+    if (count == 0) {
+        errno = EIO;
+        return -1;
+    }
+    memset(buffer, 0x5A, count);
+    return (ssize_t)count;
+}
+
+static ssize_t tst_write(driver_t* driver, const void* buffer, size_t count) {
+    if (count == 0) {
+        errno = EIO;
+        return -1;
+    }
+    return (ssize_t)count;
+}
+
+static int tst_ioctl(driver_t* driver, size_t id, void* param) {
+    if (id != 1) {
+        errno = ENOTTY;
+        return -1;
+    }
+    return 0;
+}
+
+static const driver_fops_t tst_fops = {
+    .read = tst_read,
+    .write = tst_write,
+    .ioctl = tst_ioctl,
+};
+
+static driver_ctx_t tst_ctx = { .open_max = 0 };
+static driver_t tst_drv = { .name = "stats", .fops = &tst_fops, .ctx = &tst_ctx };
+
+void test_drv_stats_setUp(void)
+{
+#ifdef DRV_STATS
+    drv_stats_reset();
+#endif
+}
+
+void test_drv_stats_tearDown(void)
+{
+}
+
+#ifdef DRV_STATS
+// Sums the histogram buckets.
+static uint64_t tst_histogram_sum(const drv_stats_t* stats) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < DRV_STATS_BUCKETS; i++) {
+        sum += stats->histogram[i];
+    }
+    return sum;
+}
+
+void test_stats_param_check_should_fail(void)
+{
+    drv_stats_t stats;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_get(&tst_drv, DRV_STAT_OPS, &stats));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_get(&tst_drv, DRV_STAT_READ, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_stats_property(NULL, DRV_STAT_PROP(DRV_STAT_READ, DRV_STAT_CALLS)));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_stats_property(&tst_drv, drv_stats_properties()));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_dump(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_stats_read_should_count_calls_bytes_and_errors(void)
+{
+    char buffer[16];
+    drv_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(16, drv_read(&tst_drv, buffer, 16));
+    TEST_ASSERT_EQUAL_INT(8, drv_read(&tst_drv, buffer, 8));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read(&tst_drv, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);              // errno unverändert durch die Statistik
+
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_READ, &stats));
+    TEST_ASSERT_EQUAL_INT(3, stats.calls);
+    TEST_ASSERT_EQUAL_INT(24, stats.bytes);
+    TEST_ASSERT_EQUAL_INT(1, stats.errors);
+    TEST_ASSERT_EQUAL_INT(EIO, stats.errnos[0].error);
+    TEST_ASSERT_EQUAL_INT(1, stats.errnos[0].count);
+    TEST_ASSERT_EQUAL_INT(0, stats.errnos[1].error);
+    TEST_ASSERT_EQUAL_INT(3, tst_histogram_sum(&stats));
+
+    // Andere Operationen bleiben unberührt
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_WRITE, &stats));
+    TEST_ASSERT_EQUAL_INT(0, stats.calls);
+}
+
+void test_stats_vectored_and_ioctl_should_count(void)
+{
+    char a[4], b[12];
+    struct iovec iov[2] = { { .iov_base = a, .iov_len = sizeof(a) }, { .iov_base = b, .iov_len = sizeof(b) } };
+    drv_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(16, drv_writev(&tst_drv, iov, 2));
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_WRITE, &stats));
+    TEST_ASSERT_EQUAL_INT(1, stats.calls);          // Ein Aufruf pro drv_writev(), nicht pro Element
+    TEST_ASSERT_EQUAL_INT(16, stats.bytes);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl(&tst_drv, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl(&tst_drv, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, drv_ioctl(&tst_drv, 3, NULL));
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_IOCTL, &stats));
+    TEST_ASSERT_EQUAL_INT(3, stats.calls);
+    TEST_ASSERT_EQUAL_INT(2, stats.errors);
+    TEST_ASSERT_EQUAL_INT(ENOTTY, stats.errnos[0].error);
+    TEST_ASSERT_EQUAL_INT(2, stats.errnos[0].count);
+}
+
+void test_stats_property_should_return_values(void)
+{
+    char buffer[32];
+    TEST_ASSERT_EQUAL_INT(DRV_STAT_OPS * DRV_STAT_FIELDS, drv_stats_properties());
+    TEST_ASSERT_EQUAL_INT(32, drv_write(&tst_drv, buffer, 32));
+    TEST_ASSERT_EQUAL_INT(32, drv_write(&tst_drv, buffer, 32));
+
+    property_t* property = drv_stats_property(&tst_drv, DRV_STAT_PROP(DRV_STAT_WRITE, DRV_STAT_CALLS));
+    TEST_ASSERT_NOT_NULL(property);
+    TEST_ASSERT_EQUAL_INT(PROP_STAT, property->type);
+    TEST_ASSERT_EQUAL_INT(TYPE_CLASS_INT | TYPE_UNSIGNED | TYPE_SIZE_64, property->property.type);
+    TEST_ASSERT_EQUAL_INT(2, property->property.uval);
+
+    property = drv_stats_property(&tst_drv, DRV_STAT_PROP(DRV_STAT_WRITE, DRV_STAT_BYTES));
+    TEST_ASSERT_NOT_NULL(property);
+    TEST_ASSERT_EQUAL_INT(64, property->property.uval);
+
+    property = drv_stats_property(&tst_drv, DRV_STAT_PROP(DRV_STAT_READ, DRV_STAT_CALLS));
+    TEST_ASSERT_NOT_NULL(property);
+    TEST_ASSERT_EQUAL_INT(0, property->property.uval);
+}
+
+static void* tst_reader(void* arg) {
+    char buffer[4];
+    for (int i = 0; i < 100; i++) {
+        drv_read(&tst_drv, buffer, sizeof(buffer));
+    }
+    return NULL;
+}
+
+void test_stats_should_sum_all_threads(void)
+{
+    pthread_t threads[3];
+    drv_stats_t stats;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, tst_reader, NULL));
+    }
+    for (int i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    // Tabellen beendeter Threads zählen weiter mit
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_READ, &stats));
+    TEST_ASSERT_EQUAL_INT(300, stats.calls);
+    TEST_ASSERT_EQUAL_INT(1200, stats.bytes);
+    TEST_ASSERT_EQUAL_INT(300, tst_histogram_sum(&stats));
+}
+
+void test_stats_should_keep_counts_of_reused_tables(void)
+{
+    drv_stats_t stats;
+    // Nacheinander: Jeder Thread übernimmt die Tabelle des vorigen und zählt weiter
+    for (int i = 0; i < 4; i++) {
+        pthread_t thread;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, NULL));
+        pthread_join(thread, NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_READ, &stats));
+    TEST_ASSERT_EQUAL_INT(400, stats.calls);
+    TEST_ASSERT_EQUAL_INT(1600, stats.bytes);
+}
+
+void test_stats_dump_and_reset(void)
+{
+    char buffer[8];
+    char line[256];
+    drv_stats_t stats;
+    TEST_ASSERT_EQUAL_INT(8, drv_read(&tst_drv, buffer, 8));
+
+    FILE* out = tmpfile();
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_dump(out));
+    rewind(out);
+    int found = 0;
+    while (fgets(line, sizeof(line), out) != NULL) {
+        if ((strncmp(line, "stats ", 6) == 0) && (strstr(line, "calls 1 bytes 8 errors 0") != NULL)) {
+            found = 1;
+        }
+    }
+    fclose(out);
+    TEST_ASSERT_TRUE(found);
+
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_reset());
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_get(&tst_drv, DRV_STAT_READ, &stats));
+    TEST_ASSERT_EQUAL_INT(0, stats.calls);
+    TEST_ASSERT_EQUAL_INT(0, stats.bytes);
+    TEST_ASSERT_EQUAL_INT(0, tst_histogram_sum(&stats));
+}
+#else
+void test_stats_disabled_should_fail(void)
+{
+    drv_stats_t stats;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_get(&tst_drv, DRV_STAT_READ, &stats));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_stats_properties());
+    errno = 0;
+    TEST_ASSERT_NULL(drv_stats_property(&tst_drv, DRV_STAT_PROP(DRV_STAT_READ, DRV_STAT_CALLS)));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_dump(stdout));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_stats_reset());
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+}
+#endif
+
+void test_drv_stats_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+#ifdef DRV_STATS
+    RUN(test_stats_param_check_should_fail);
+    RUN(test_stats_read_should_count_calls_bytes_and_errors);
+    RUN(test_stats_vectored_and_ioctl_should_count);
+    RUN(test_stats_property_should_return_values);
+    RUN(test_stats_should_sum_all_threads);
+    RUN(test_stats_should_keep_counts_of_reused_tables);
+    RUN(test_stats_dump_and_reset);
+#else
+    RUN(test_stats_disabled_should_fail);
+#endif
+#undef RUN
+}
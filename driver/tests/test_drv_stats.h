@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_STATS_H_
+#define _TEST_DRV_STATS_H_
+
+void test_drv_stats_setUp(void);
+void test_drv_stats_tearDown(void);
+void test_drv_stats_run_all();
+
+#endif //_TEST_DRV_STATS_H_
@@ -0,0 +1,263 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_wait.h"
+#include "drv_dio.h"
+#include "tst_time.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+
+#define TST_CAPACITY    (4)
+
+// ---- Dummy-Treiber: FIFO mit TST_CAPACITY Bytes, liest und schreibt ohne Warten (EAGAIN) ----
+static driver_ctx_t tst_ctx;
+static _Atomic int tst_fill;
+
+static ssize_t tst_fifo_read(driver_t* driver, void* buffer, size_t count) {
+    int fill = atomic_load(&tst_fill);
+    do {
+        if (fill == 0) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak(&tst_fill, &fill, fill - 1));
+    memset(buffer, 'x', 1);
+    drv_wake(driver);
+    return 1;
+}
+
+static ssize_t tst_fifo_write(driver_t* driver, const void* buffer, size_t count) {
+    int fill = atomic_load(&tst_fill);
+    do {
+        if (fill == TST_CAPACITY) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak(&tst_fill, &fill, fill + 1));
+    drv_wake(driver);
+    return 1;
+}
+
+static short tst_fifo_poll(driver_t* driver, short events) {
+    int fill = atomic_load(&tst_fill);
+    return ((fill > 0) ? POLLIN : 0) | ((fill < TST_CAPACITY) ? POLLOUT : 0);
+}
+
+static const driver_fops_t tst_fifo_fops = {
+    .close = drv_open_release,
+    .read = tst_fifo_read,
+    .write = tst_fifo_write,
+    .poll = tst_fifo_poll,
+};
+static driver_t tst_fifo = { .name = "fifo", .fops = &tst_fifo_fops, .ctx = &tst_ctx };
+
+// ---- Dummy-Treiber mit eigenen timed fops: Merkt sich die Argumente ----
+static int tst_timed_flags;
+static const struct timespec* tst_timed_deadline;
+
+static ssize_t tst_timed_read(driver_t* driver, void* buffer, size_t count, int flags, const struct timespec* deadline) {
+    tst_timed_flags = flags;
+    tst_timed_deadline = deadline;
+    return 0;
+}
+
+static ssize_t tst_timed_write(driver_t* driver, const void* buffer, size_t count, int flags, const struct timespec* deadline) {
+    tst_timed_flags = flags;
+    tst_timed_deadline = deadline;
+    return (ssize_t)count;
+}
+
+static const driver_fops_t tst_timed_fops = {
+    .close = drv_open_release,
+    .read_timed = tst_timed_read,
+    .write_timed = tst_timed_write,
+};
+static driver_ctx_t tst_timed_ctx;
+static driver_t tst_timed = { .name = "timed", .fops = &tst_timed_fops, .ctx = &tst_timed_ctx };
+
+// ---- Basistreiber für drv_fopen(): "fifo", "dio" (der echte DIO-Treiber) oder "timed" ----
+static driver_t* tst_root_open(driver_t* base_driver, const char* name) {
+    driver_t* driver = (strcmp(name, "fifo") == 0) ? &tst_fifo : (strcmp(name, "dio") == 0) ? (driver_t*)drv_dio : &tst_timed;
+    return (drv_open_acquire(driver) == 0) ? driver : NULL;
+}
+
+static const driver_fops_t tst_root_fops = { .open = tst_root_open };
+static driver_t tst_root = { .name = "timed_root", .fops = &tst_root_fops };
+
+static char tst_buffer[8];
+
+// Liest oder schreibt nach kurzer Zeit ein Byte.
+static void* tst_fifo_peer(void* arg) {
+    struct timespec delay = { .tv_nsec = 5000000L };
+    nanosleep(&delay, NULL);
+    if (arg != NULL) {
+        (void)drv_write(&tst_fifo, "y", 1);
+    } else {
+        (void)drv_read(&tst_fifo, tst_buffer, 1);
+    }
+    return NULL;
+}
+
+void test_drv_timed_setUp(void)
+{
+    atomic_store(&tst_fill, 0);
+    tst_timed_flags = -1;
+    tst_timed_deadline = NULL;
+}
+
+void test_drv_timed_tearDown(void)
+{
+}
+
+void test_timed_param_check_should_fail(void)
+{
+    struct timespec deadline = { .tv_nsec = 1000000000L };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed(NULL, tst_buffer, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed(&tst_fifo, NULL, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed(&tst_fifo, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_write_timed(NULL, tst_buffer, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_write_timed(&tst_fifo, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_read_timed_should_time_out(void)
+{
+    struct timespec start, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    drv_wait_deadline(&deadline, 20);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed(&tst_fifo, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(ETIMEDOUT, errno);
+    TEST_ASSERT_TRUE(tst_elapsed_ms(&start) >= 19);
+    TEST_ASSERT_NULL(tst_ctx.wait.head);
+
+    // Abgelaufene Frist: Ein Versuch ohne Warten.
+    struct timespec passed = { 0 };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed(&tst_fifo, tst_buffer, 1, &passed));
+    TEST_ASSERT_EQUAL_INT(ETIMEDOUT, errno);
+    atomic_store(&tst_fill, 1);
+    TEST_ASSERT_EQUAL_INT(1, drv_read_timed(&tst_fifo, tst_buffer, 1, &passed));
+}
+
+void test_read_timed_should_wake_on_data(void)
+{
+    struct timespec deadline;
+    drv_wait_deadline(&deadline, 5000);
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_fifo_peer, "w"));
+    TEST_ASSERT_EQUAL_INT(1, drv_read_timed(&tst_fifo, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&tst_fill));
+}
+
+void test_write_timed_should_wait_for_space(void)
+{
+    atomic_store(&tst_fill, TST_CAPACITY);
+    struct timespec deadline;
+    drv_wait_deadline(&deadline, 10);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_write_timed(&tst_fifo, "z", 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(ETIMEDOUT, errno);
+
+    // Ohne Frist: Wartet, bis gelesen wurde.
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_fifo_peer, NULL));
+    TEST_ASSERT_EQUAL_INT(1, drv_write_timed(&tst_fifo, "z", 1, NULL));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+    TEST_ASSERT_EQUAL_INT(TST_CAPACITY, atomic_load(&tst_fill));
+}
+
+void test_fread_nonblock_should_fail_with_eagain(void)
+{
+    int fd = drv_fopen(&tst_root, "fifo", O_NONBLOCK);
+    TEST_ASSERT_TRUE(fd >= 0);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fread(fd, tst_buffer, 1));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+    atomic_store(&tst_fill, TST_CAPACITY);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fwrite(fd, "z", 1));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+    TEST_ASSERT_EQUAL_INT(1, drv_fread(fd, tst_buffer, 1));
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_fread_blocking_should_wait(void)
+{
+    int fd = drv_fopen(&tst_root, "fifo", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_fifo_peer, "w"));
+    TEST_ASSERT_EQUAL_INT(1, drv_fread(fd, tst_buffer, 1));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_blocking_io_without_data_should_fail_at_once(void)
+{
+    // Der DIO-Treiber hat eine poll fop, liest und schreibt aber selbst nie: Kein Warten, ENOTSUP sofort.
+    struct timespec start, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int fd = drv_fopen(&tst_root, "dio", 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fread(fd, tst_buffer, 1));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_fwrite(fd, "z", 1));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_write_timed((driver_t*)drv_dio, "z", 1, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    drv_wait_deadline(&deadline, 5000);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read_timed((driver_t*)drv_dio, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    TEST_ASSERT_TRUE(tst_elapsed_ms(&start) < 1000);
+}
+
+void test_timed_fops_should_get_flags_and_deadline(void)
+{
+    struct timespec deadline = { .tv_sec = 1 };
+    TEST_ASSERT_EQUAL_INT(0, drv_read_timed(&tst_timed, tst_buffer, 1, &deadline));
+    TEST_ASSERT_EQUAL_INT(0, tst_timed_flags);
+    TEST_ASSERT_EQUAL_PTR(&deadline, tst_timed_deadline);
+
+    // Der Handle reicht O_NONBLOCK an die fop weiter.
+    int fd = drv_fopen(&tst_root, "timed", O_NONBLOCK);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(2, drv_fwrite(fd, "ab", 2));
+    TEST_ASSERT_TRUE(tst_timed_flags & O_NONBLOCK);
+    TEST_ASSERT_NULL(tst_timed_deadline);
+    TEST_ASSERT_EQUAL_INT(0, drv_fclose(fd));
+}
+
+void test_drv_timed_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_timed_param_check_should_fail);
+    RUN(test_read_timed_should_time_out);
+    RUN(test_read_timed_should_wake_on_data);
+    RUN(test_write_timed_should_wait_for_space);
+    RUN(test_fread_nonblock_should_fail_with_eagain);
+    RUN(test_fread_blocking_should_wait);
+    RUN(test_blocking_io_without_data_should_fail_at_once);
+    RUN(test_timed_fops_should_get_flags_and_deadline);
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_TIMED_H_
+#define _TEST_DRV_TIMED_H_
+
+void test_drv_timed_setUp(void);
+void test_drv_timed_tearDown(void);
+void test_drv_timed_run_all();
+
+#endif //_TEST_DRV_TIMED_H_
@@ -0,0 +1,249 @@
+#include "unity.h"
+#include "driver.h"
+#include "drv_trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+// ---- Dummy-Treiber: Liest count Bytes, schlägt bei count == 0 mit EIO fehl ----
+static ssize_t tst_read(driver_t* driver, void* buffer, size_t count) {
+    (void)driver;
+    if (count == 0) {
+        errno = EIO;
+        return -1;
+    }
+    memset(buffer, 0x5A, count);
+    return (ssize_t)count;
+}
+
+static int tst_ioctl(driver_t* driver, size_t id, void* param) {
+    (void)driver;
+    (void)id;
+    (void)param;
+    return 0;
+}
+
+static const driver_fops_t tst_fops = {
+    .read = tst_read,
+    .ioctl = tst_ioctl,
+};
+
+static driver_ctx_t tst_ctx = { .open_max = 0 };
+static driver_t tst_drv = { .name = "trace", .fops = &tst_fops, .ctx = &tst_ctx };
+
+#define TST_MAX (DRV_TRACE_RECORDS * 4U)
+static drv_trace_record_t tst_records[TST_MAX];     // Records of all threads from tst_load().
+static uint32_t tst_threads[TST_MAX];               // Thread of the record.
+static uint64_t tst_lost;
+
+// Dumps the trace and loads all records.
+static size_t tst_load(void) {
+    FILE* file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(0, drv_trace_dump(file));
+    rewind(file);
+
+    drv_trace_header_t header;
+    TEST_ASSERT_EQUAL_INT(1, fread(&header, sizeof(header), 1, file));
+    TEST_ASSERT_EQUAL_MEMORY(DRV_TRACE_MAGIC, header.magic, 8);
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_VERSION, header.version);
+    TEST_ASSERT_EQUAL_INT(sizeof(drv_trace_record_t), header.record_size);
+    TEST_ASSERT_TRUE(header.ns[1] >= header.ns[0]);
+
+    size_t count = 0;
+    tst_lost = 0;
+    for (uint32_t t = 0; t < header.threads; t++) {
+        drv_trace_thread_t thread;
+        TEST_ASSERT_EQUAL_INT(1, fread(&thread, sizeof(thread), 1, file));
+        TEST_ASSERT_TRUE(count + thread.count <= TST_MAX);
+        if (thread.count != 0) {
+            TEST_ASSERT_EQUAL_INT(thread.count, fread(&tst_records[count], sizeof(drv_trace_record_t), thread.count, file));
+        }
+        for (uint32_t i = 0; i < thread.count; i++) {
+            tst_threads[count + i] = thread.thread;
+        }
+        count += thread.count;
+        tst_lost += thread.lost;
+    }
+    TEST_ASSERT_EQUAL_INT(EOF, fgetc(file));
+    fclose(file);
+    return count;
+}
+
+void test_drv_trace_setUp(void)
+{
+    drv_trace_enable(0);
+    drv_trace_clear();
+}
+
+void test_drv_trace_tearDown(void)
+{
+    drv_trace_enable(0);
+    drv_trace_clear();
+}
+
+void test_trace_param_check_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_trace_dump(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_trace_disabled_should_not_record(void)
+{
+    char buffer[4];
+    TEST_ASSERT_EQUAL_INT(4, drv_read(&tst_drv, buffer, 4));
+    TEST_ASSERT_EQUAL_INT(0, tst_load());
+}
+
+void test_trace_should_record_calls(void)
+{
+    char buffer[8];
+    TEST_ASSERT_EQUAL_INT(0, drv_trace_enable(1));
+    TEST_ASSERT_EQUAL_INT(8, drv_read(&tst_drv, buffer, 8));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_read(&tst_drv, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(EIO, errno);              // errno unverändert durch den Trace
+    TEST_ASSERT_EQUAL_INT(0, drv_ioctl(&tst_drv, 42, NULL));
+    TEST_ASSERT_EQUAL_INT(1, drv_trace_enable(0));
+    TEST_ASSERT_EQUAL_INT(8, drv_read(&tst_drv, buffer, 8));    // Nicht mehr aufgezeichnet
+
+    TEST_ASSERT_EQUAL_INT(4, tst_load());
+    // Name vor dem ersten Record des Treibers
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_NAME, tst_records[0].op);
+    TEST_ASSERT_EQUAL_INT((uintptr_t)&tst_drv, tst_records[0].driver);
+    TEST_ASSERT_EQUAL_MEMORY("trace", tst_records[0].name, 6);
+
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_READ, tst_records[1].op);
+    TEST_ASSERT_EQUAL_INT((uintptr_t)&tst_drv, tst_records[1].driver);
+    TEST_ASSERT_EQUAL_INT(8, tst_records[1].size);
+    TEST_ASSERT_EQUAL_INT(8, tst_records[1].result);
+    TEST_ASSERT_EQUAL_INT(0, tst_records[1].error);
+
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_READ, tst_records[2].op);
+    TEST_ASSERT_EQUAL_INT(0, tst_records[2].size);
+    TEST_ASSERT_EQUAL_INT(-1, tst_records[2].result);
+    TEST_ASSERT_EQUAL_INT(EIO, tst_records[2].error);
+
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_IOCTL, tst_records[3].op);
+    TEST_ASSERT_EQUAL_INT(42, tst_records[3].size);
+    TEST_ASSERT_EQUAL_INT(0, tst_records[3].result);
+
+    TEST_ASSERT_TRUE(tst_records[1].time <= tst_records[2].time);
+    TEST_ASSERT_TRUE(tst_records[2].time <= tst_records[3].time);
+}
+
+void test_trace_clear_should_drop_records(void)
+{
+    char buffer[4];
+    drv_trace_enable(1);
+    TEST_ASSERT_EQUAL_INT(4, drv_read(&tst_drv, buffer, 4));
+    drv_trace_clear();
+    TEST_ASSERT_EQUAL_INT(4, drv_read(&tst_drv, buffer, 4));
+    drv_trace_enable(0);
+
+    // Nach dem Löschen wird der Name erneut aufgezeichnet
+    TEST_ASSERT_EQUAL_INT(2, tst_load());
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_NAME, tst_records[0].op);
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_READ, tst_records[1].op);
+    TEST_ASSERT_EQUAL_INT(0, tst_lost);
+}
+
+void test_trace_full_ring_should_keep_newest(void)
+{
+    char buffer[4];
+    drv_trace_enable(1);
+    for (size_t i = 0; i < DRV_TRACE_RECORDS + 10U; i++) {
+        TEST_ASSERT_EQUAL_INT(0, drv_ioctl(&tst_drv, i, buffer));
+    }
+    drv_trace_enable(0);
+
+    // Der überschriebene Name wird dem Dump vorangestellt
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_RECORDS + 1U, tst_load());
+    TEST_ASSERT_EQUAL_INT(11, tst_lost);            // Name und die ersten 10 ioctls
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_NAME, tst_records[0].op);
+    TEST_ASSERT_EQUAL_INT((uintptr_t)&tst_drv, tst_records[0].driver);
+    TEST_ASSERT_EQUAL_MEMORY("trace", tst_records[0].name, 6);
+    TEST_ASSERT_EQUAL_INT(10, tst_records[1].size);
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_RECORDS + 9U, tst_records[DRV_TRACE_RECORDS].size);
+}
+
+// Liest 50 mal. arg: Barriere, an der alle Threads vor dem Ende warten (NULL: keine).
+static void* tst_reader(void* arg) {
+    char buffer[4];
+    for (int i = 0; i < 50; i++) {
+        drv_read(&tst_drv, buffer, sizeof(buffer));
+    }
+    if (arg != NULL) {
+        pthread_barrier_wait(arg);                  // Kein Thread übernimmt den Ring eines anderen
+    }
+    return NULL;
+}
+
+void test_trace_should_record_every_thread(void)
+{
+    pthread_t threads[3];
+    pthread_barrier_t barrier;
+    TEST_ASSERT_EQUAL_INT(0, pthread_barrier_init(&barrier, NULL, 3));
+    drv_trace_enable(1);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, tst_reader, &barrier));
+    }
+    for (int i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    drv_trace_enable(0);
+    pthread_barrier_destroy(&barrier);
+
+    // Jeder Thread: Ein Name und 50 Reads im eigenen Ring
+    size_t count = tst_load();
+    TEST_ASSERT_EQUAL_INT(3 * 51, count);
+    uint32_t first = tst_threads[0];
+    int names = 0;
+    for (size_t i = 0; i < count; i++) {
+        names += (tst_records[i].op == DRV_TRACE_NAME);
+        if ((i % 51) == 0) {
+            TEST_ASSERT_EQUAL_INT(DRV_TRACE_NAME, tst_records[i].op);
+        } else {
+            TEST_ASSERT_EQUAL_INT(tst_threads[i - 1], tst_threads[i]);
+            TEST_ASSERT_TRUE(tst_records[i - 1].time <= tst_records[i].time);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(3, names);
+    TEST_ASSERT_TRUE((tst_threads[51] != first) && (tst_threads[102] != first));
+}
+
+void test_trace_should_continue_ring_of_ended_thread(void)
+{
+    drv_trace_enable(1);
+    // Nacheinander: Der zweite Thread übernimmt den Ring des ersten
+    for (int i = 0; i < 2; i++) {
+        pthread_t thread;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, NULL));
+        pthread_join(thread, NULL);
+    }
+    drv_trace_enable(0);
+
+    // Ein Ring: Der Name ist dort schon bekannt, die Records des ersten Threads bleiben erhalten
+    size_t count = tst_load();
+    TEST_ASSERT_EQUAL_INT(1 + 2 * 50, count);
+    TEST_ASSERT_EQUAL_INT(DRV_TRACE_NAME, tst_records[0].op);
+    for (size_t i = 1; i < count; i++) {
+        TEST_ASSERT_EQUAL_INT(tst_threads[0], tst_threads[i]);
+        TEST_ASSERT_EQUAL_INT(DRV_TRACE_READ, tst_records[i].op);
+    }
+}
+
+void test_drv_trace_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_trace_param_check_should_fail);
+    RUN(test_trace_disabled_should_not_record);
+    RUN(test_trace_should_record_calls);
+    RUN(test_trace_clear_should_drop_records);
+    RUN(test_trace_full_ring_should_keep_newest);
+    RUN(test_trace_should_record_every_thread);
+    RUN(test_trace_should_continue_ring_of_ended_thread);
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_TRACE_H_
+#define _TEST_DRV_TRACE_H_
+
+void test_drv_trace_setUp(void);
+void test_drv_trace_tearDown(void);
+void test_drv_trace_run_all();
+
+#endif //_TEST_DRV_TRACE_H_
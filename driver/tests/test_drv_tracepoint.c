@@ -0,0 +1,254 @@
+#include "unity.h"
+#include "registry.h"
+#include "dyn_array.h"
+#include "drv_tracepoint.h"
+#include "drv_trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef DRV_TRACEPOINTS
+// ---- Dummy-Treiber ----
+static driver_ctx_t tst_ctx1 = { .reg_name = "tp_reg1" };
+static driver_ctx_t tst_ctx2 = { .reg_name = "tp_reg2" };
+static driver_t tst_drv1 = { .name = "tp_drv1", .ctx = &tst_ctx1 };
+static driver_t tst_drv2 = { .name = "tp_drv2", .ctx = &tst_ctx2 };
+
+// ---- Vom Callback empfangene Events ----
+#define TST_EVENTS (64U)
+typedef struct {
+    drv_tp_id_t id;
+    int64_t a0;
+    int64_t a1;
+} tst_event_t;
+
+static tst_event_t tst_events[TST_EVENTS];
+static size_t tst_event_count;
+static int tst_user;
+
+static void tst_callback(drv_tp_id_t id, int64_t a0, int64_t a1, void* user) {
+    TEST_ASSERT_EQUAL_PTR(&tst_user, user);
+    if (tst_event_count < TST_EVENTS) {
+        tst_events[tst_event_count++] = (tst_event_t){ .id = id, .a0 = a0, .a1 = a1 };
+    }
+}
+
+// Returns the n-th event of a tracepoint.
+static tst_event_t* tst_find(drv_tp_id_t id, size_t n) {
+    for (size_t i = 0; i < tst_event_count; i++) {
+        if ((tst_events[i].id == id) && (n-- == 0)) {
+            return &tst_events[i];
+        }
+    }
+    return NULL;
+}
+#endif
+
+void test_drv_tracepoint_setUp(void)
+{
+#ifdef DRV_TRACEPOINTS
+    drv_tracepoint_enable(DRV_TP_COUNT, 0);
+    drv_tracepoint_callback(tst_callback, &tst_user);
+    tst_event_count = 0;
+#endif
+}
+
+void test_drv_tracepoint_tearDown(void)
+{
+#ifdef DRV_TRACEPOINTS
+    drv_tracepoint_enable(DRV_TP_COUNT, 0);
+    drv_tracepoint_callback(NULL, NULL);
+#endif
+}
+
+void test_tracepoint_disabled_should_not_evaluate(void)
+{
+    int evaluated = 0;
+    // Ohne Schlüssel (bzw. ohne DRV_TRACEPOINTS) werden die Argumente nicht ausgewertet.
+    DRV_TRACEPOINT(REGISTRY_ADD, evaluated++, evaluated++);
+    DRV_TRACEPOINT(REGISTRY_RESIZE, evaluated++);
+    TEST_ASSERT_EQUAL_INT(0, evaluated);
+}
+
+#ifdef DRV_TRACEPOINTS
+void test_tracepoint_param_check_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_tracepoint_enable(DRV_TP_COUNT + 1, DRV_TP_SINK_TRACE));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_tracepoint_enable(DRV_TP_REGISTRY_ADD, 1U << 7));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_tracepoint_name(DRV_TP_COUNT));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    TEST_ASSERT_EQUAL_STRING("registry_lookup", drv_tracepoint_name(DRV_TP_REGISTRY_LOOKUP));
+    TEST_ASSERT_EQUAL_STRING("dio_open", drv_tracepoint_name(DRV_TP_DIO_OPEN));
+}
+
+void test_tracepoint_registry_should_fire(void)
+{
+    registry_t registry = { 0 };
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_COUNT, DRV_TP_SINK_CALLBACK));
+
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&registry, &tst_drv1));
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_driver(&registry, &tst_drv1));
+    TEST_ASSERT_EQUAL_PTR(&tst_drv1, registry_get_driver_by_name(&registry, "tp_drv1"));
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&registry, "tp_none"));
+
+    // Erstes Anlegen der Liste
+    tst_event_t* event = tst_find(DRV_TP_REGISTRY_RESIZE, 0);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(0, event->a0);
+    TEST_ASSERT_EQUAL_INT(registry.driver_list_size, event->a1);
+
+    event = tst_find(DRV_TP_REGISTRY_ADD, 0);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(1, event->a0);
+    TEST_ASSERT_EQUAL_INT(0, event->a1);
+    event = tst_find(DRV_TP_REGISTRY_ADD, 1);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(EEXIST, event->a1);
+
+    // Suche über den Hash-Index: Gefunden mit Index 0, dann nicht gefunden
+    event = tst_find(DRV_TP_REGISTRY_GET_BY_NAME, 0);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(2, event->a0);
+    TEST_ASSERT_EQUAL_INT(1, event->a1);
+    event = tst_find(DRV_TP_REGISTRY_GET_BY_NAME, 1);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(0, event->a1);
+    int lookups = 0;
+    for (size_t i = 0; i < tst_event_count; i++) {
+        if (tst_events[i].id == DRV_TP_REGISTRY_LOOKUP) {
+            TEST_ASSERT_TRUE(tst_events[i].a0 >= 1);
+            lookups++;
+        }
+    }
+    TEST_ASSERT_TRUE(lookups >= 2);
+
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&registry, &tst_drv1));
+    event = tst_find(DRV_TP_REGISTRY_REMOVE, 0);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(1, event->a0);
+    TEST_ASSERT_EQUAL_INT(0, event->a1);
+    registry_free_registry(&registry);
+}
+
+void test_tracepoint_single_key_should_filter(void)
+{
+    registry_t registry = { 0 };
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_REGISTRY_ADD, DRV_TP_SINK_CALLBACK));
+
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&registry, &tst_drv1));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&registry, &tst_drv2));
+    TEST_ASSERT_EQUAL_INT(2, tst_event_count);
+    TEST_ASSERT_EQUAL_INT(DRV_TP_REGISTRY_ADD, tst_events[0].id);
+    TEST_ASSERT_EQUAL_INT(DRV_TP_REGISTRY_ADD, tst_events[1].id);
+
+    // Ausgeschaltet: Keine Events mehr
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_REGISTRY_ADD, 0));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&registry, &tst_drv1));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&registry, &tst_drv2));
+    TEST_ASSERT_EQUAL_INT(2, tst_event_count);
+    registry_free_registry(&registry);
+}
+
+void test_tracepoint_dyn_array_should_fire(void)
+{
+    dyn_array_t array = { 0 };
+    int elements[DYN_ARRAY_REALLOC_ELEMENTS + 1];
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_DYN_ARRAY_RESIZE, DRV_TP_SINK_CALLBACK));
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_DYN_ARRAY_SCAN, DRV_TP_SINK_CALLBACK));
+
+    for (size_t i = 0; i < DYN_ARRAY_REALLOC_ELEMENTS + 1; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    // Zwei Reallocs: Anlegen und Wachsen
+    tst_event_t* event = tst_find(DRV_TP_DYN_ARRAY_RESIZE, 0);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(0, event->a0);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS, event->a1);
+    event = tst_find(DRV_TP_DYN_ARRAY_RESIZE, 1);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS, event->a0);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS * DYN_ARRAY_GROWTH_FACTOR, event->a1);
+    TEST_ASSERT_NULL(tst_find(DRV_TP_DYN_ARRAY_RESIZE, 2));
+
+    // Die Suche nach dem freien Platz i prüft i + 1 Elemente.
+    event = tst_find(DRV_TP_DYN_ARRAY_SCAN, DYN_ARRAY_REALLOC_ELEMENTS);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS + 1, event->a0);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS, event->a1);
+
+    for (size_t i = 0; i < DYN_ARRAY_REALLOC_ELEMENTS + 1; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_remove_element(&array, &elements[i]));
+    }
+}
+
+void test_tracepoint_trace_sink_should_record(void)
+{
+    registry_t registry = { 0 };
+    drv_trace_clear();
+    TEST_ASSERT_EQUAL_INT(0, drv_tracepoint_enable(DRV_TP_REGISTRY_ADD, DRV_TP_SINK_TRACE));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&registry, &tst_drv1));
+    TEST_ASSERT_EQUAL_INT(0, tst_event_count);      // Nur in den Trace-Ring
+
+    FILE* file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(0, drv_trace_dump(file));
+    rewind(file);
+    drv_trace_header_t header;
+    TEST_ASSERT_EQUAL_INT(1, fread(&header, sizeof(header), 1, file));
+    int found = 0;
+    for (uint32_t t = 0; t < header.threads; t++) {
+        drv_trace_thread_t thread;
+        TEST_ASSERT_EQUAL_INT(1, fread(&thread, sizeof(thread), 1, file));
+        for (uint32_t i = 0; i < thread.count; i++) {
+            drv_trace_record_t record;
+            TEST_ASSERT_EQUAL_INT(1, fread(&record, sizeof(record), 1, file));
+            if (record.op == DRV_TRACE_POINT) {
+                TEST_ASSERT_EQUAL_INT(DRV_TP_REGISTRY_ADD, record.point);
+                TEST_ASSERT_EQUAL_INT(1, record.size);
+                TEST_ASSERT_EQUAL_INT(0, record.result);
+                found++;
+            }
+        }
+    }
+    fclose(file);
+    TEST_ASSERT_EQUAL_INT(1, found);
+
+    drv_trace_clear();
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&registry, &tst_drv1));
+    registry_free_registry(&registry);
+}
+#else
+void test_tracepoint_api_disabled_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_tracepoint_enable(DRV_TP_COUNT, DRV_TP_SINK_TRACE));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, drv_tracepoint_callback(NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(drv_tracepoint_name(DRV_TP_REGISTRY_ADD));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+}
+#endif
+
+void test_drv_tracepoint_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_tracepoint_disabled_should_not_evaluate);
+#ifdef DRV_TRACEPOINTS
+    RUN(test_tracepoint_param_check_should_fail);
+    RUN(test_tracepoint_registry_should_fire);
+    RUN(test_tracepoint_single_key_should_filter);
+    RUN(test_tracepoint_dyn_array_should_fire);
+    RUN(test_tracepoint_trace_sink_should_record);
+#else
+    RUN(test_tracepoint_api_disabled_should_fail);
+#endif
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_DRV_TRACEPOINT_H_
+#define _TEST_DRV_TRACEPOINT_H_
+
+void test_drv_tracepoint_setUp(void);
+void test_drv_tracepoint_tearDown(void);
+void test_drv_tracepoint_run_all();
+
+#endif //_TEST_DRV_TRACEPOINT_H_
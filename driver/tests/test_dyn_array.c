@@ -0,0 +1,154 @@
+#include "unity.h"
+#include "dyn_array.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// ---- Testobjekt ----
+#define TST_ELEMENTS (20U)
+
+static dyn_array_t array;
+static int elements[TST_ELEMENTS];
+
+// ---- Setup / Cleanup -----
+void test_dyn_array_setUp(void)
+{
+    memset(&array, 0, sizeof(dyn_array_t));
+}
+
+void test_dyn_array_tearDown(void)
+{
+    free(array.list);
+    ptr_index_free(&array.index);
+    memset(&array, 0, sizeof(dyn_array_t));
+}
+
+// ---- dyn_array_add ----
+void test_dyn_array_should_grow_geometrically(void)
+{
+    for (size_t i = 0; i < DYN_ARRAY_REALLOC_ELEMENTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS, array.elements);
+
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[DYN_ARRAY_REALLOC_ELEMENTS]));
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS * DYN_ARRAY_GROWTH_FACTOR, array.elements);
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS + 1, array.used);
+}
+
+void test_dyn_array_should_use_growth_factor(void)
+{
+    array.growth_factor = 4;
+    for (size_t i = 0; i < DYN_ARRAY_REALLOC_ELEMENTS + 1; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS * 4, array.elements);
+}
+
+void test_dyn_array_add_duplicate_should_fail(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[0]));
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[1]));
+
+    // Jedes Element darf nur einmal gespeichert werden.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, dyn_array_add(&array, &elements[0]));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+    TEST_ASSERT_EQUAL_INT(2, array.used);
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_find_element(&array, &elements[0]));
+
+    // Nach dem Entfernen kann es wieder hinzugefügt werden.
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_remove_element(&array, &elements[0]));
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[0]));
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_find_element(&array, &elements[0]));
+}
+
+void test_dyn_array_find_should_return_index(void)
+{
+    for (size_t i = 0; i < TST_ELEMENTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    for (size_t i = 0; i < TST_ELEMENTS; i++) {
+        TEST_ASSERT_EQUAL_INT(i, dyn_array_find_element(&array, &elements[i]));
+        TEST_ASSERT_EQUAL_PTR(&elements[i], dyn_array_get_by_index(&array, i));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_remove_element(&array, &elements[3]));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, dyn_array_find_element(&array, &elements[3]));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    TEST_ASSERT_EQUAL_INT(3, dyn_array_find_free_index(&array));
+}
+
+// ---- dyn_array_reserve ----
+void test_dyn_array_reserve_should_expand(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_reserve(&array, TST_ELEMENTS));
+    TEST_ASSERT_EQUAL_INT(TST_ELEMENTS, array.elements);
+
+    // Danach kein realloc mehr.
+    void** list = array.list;
+    for (size_t i = 0; i < TST_ELEMENTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    TEST_ASSERT_EQUAL_PTR(list, array.list);
+    TEST_ASSERT_EQUAL_INT(TST_ELEMENTS, array.elements);
+
+    // Weniger reservieren verkleinert nie.
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_reserve(&array, 1));
+    TEST_ASSERT_EQUAL_INT(TST_ELEMENTS, array.elements);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, dyn_array_reserve(NULL, 1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+// ---- dyn_array_compact ----
+void test_dyn_array_compact_should_move_elements_down(void)
+{
+    for (size_t i = 0; i < TST_ELEMENTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[i]));
+    }
+    for (size_t i = 0; i < TST_ELEMENTS - 5; i++) {
+        TEST_ASSERT_EQUAL_INT(0, dyn_array_remove_element(&array, &elements[i]));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_compact(&array));
+    TEST_ASSERT_EQUAL_INT(DYN_ARRAY_REALLOC_ELEMENTS, array.elements);
+    TEST_ASSERT_EQUAL_INT(5, array.used);
+
+    // Reihenfolge bleibt erhalten, der Index wird mitgeführt.
+    for (size_t i = 0; i < 5; i++) {
+        int* element = &elements[TST_ELEMENTS - 5 + i];
+        TEST_ASSERT_EQUAL_PTR(element, dyn_array_get_by_index(&array, i));
+        TEST_ASSERT_EQUAL_INT(i, dyn_array_find_element(&array, element));
+    }
+    TEST_ASSERT_NULL(dyn_array_get_by_index(&array, 5));
+    TEST_ASSERT_EQUAL_INT(-1, dyn_array_add(&array, &elements[TST_ELEMENTS - 1]));
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_add(&array, &elements[0]));
+    TEST_ASSERT_EQUAL_INT(5, dyn_array_find_element(&array, &elements[0]));
+}
+
+void test_dyn_array_compact_empty_should_succeed(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, dyn_array_compact(&array));
+    TEST_ASSERT_EQUAL_INT(0, array.elements);
+    TEST_ASSERT_NULL(array.list);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, dyn_array_compact(NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_dyn_array_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_dyn_array_should_grow_geometrically);
+    RUN(test_dyn_array_should_use_growth_factor);
+    RUN(test_dyn_array_add_duplicate_should_fail);
+    RUN(test_dyn_array_find_should_return_index);
+    RUN(test_dyn_array_reserve_should_expand);
+    RUN(test_dyn_array_compact_should_move_elements_down);
+    RUN(test_dyn_array_compact_empty_should_succeed);
+#undef RUN
+}
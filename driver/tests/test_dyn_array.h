@@ -0,0 +1,8 @@
+#ifndef _TEST_DYN_ARRAY_H_
+#define _TEST_DYN_ARRAY_H_
+
+void test_dyn_array_setUp(void);
+void test_dyn_array_tearDown(void);
+void test_dyn_array_run_all();
+
+#endif //_TEST_DYN_ARRAY_H_
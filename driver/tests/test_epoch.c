@@ -0,0 +1,179 @@
+#include "unity.h"
+#include "epoch.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// ---- Helper ----
+static int released;
+
+static void tst_release(void* ptr)
+{
+    (void)ptr;
+    released++;
+}
+
+typedef struct {
+    atomic_bool entered;
+    atomic_bool leave;
+} tst_reader_t;
+
+// Reader thread: Stays in its critical section, until it is told to leave.
+static void* tst_reader(void* arg)
+{
+    tst_reader_t* reader = arg;
+    epoch_enter();
+    atomic_store(&reader->entered, true);
+    while (!atomic_load(&reader->leave)) {
+        sched_yield();
+    }
+    epoch_exit();
+    return NULL;
+}
+
+// Reader thread: Terminates inside its critical section.
+static void* tst_reader_exiting(void* arg)
+{
+    (void)arg;
+    epoch_enter();
+    epoch_enter();
+    return NULL;
+}
+
+// ---- Setup / Cleanup -----
+void test_epoch_setUp(void)
+{
+    epoch_synchronize();
+    released = 0;
+}
+
+void test_epoch_tearDown(void)
+{
+    epoch_synchronize();
+}
+
+// ---- epoch_retire ----
+void test_epoch_retire_without_readers_should_release(void)
+{
+    int data;
+    epoch_retire(&data, tst_release);
+    TEST_ASSERT_EQUAL_INT(1, released);
+    TEST_ASSERT_EQUAL_INT(0, epoch_pending());
+
+    epoch_retire(NULL, tst_release);
+    TEST_ASSERT_EQUAL_INT(1, released);
+}
+
+void test_epoch_retire_with_active_reader_should_defer(void)
+{
+    int data;
+    tst_reader_t reader = { .entered = false, .leave = false };
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, &reader));
+    while (!atomic_load(&reader.entered)) {
+        sched_yield();
+    }
+
+    epoch_retire(&data, tst_release);
+    TEST_ASSERT_EQUAL_INT(0, released);
+    TEST_ASSERT_EQUAL_INT(1, epoch_pending());
+
+    atomic_store(&reader.leave, true);
+    pthread_join(thread, NULL);
+    epoch_synchronize();
+    TEST_ASSERT_EQUAL_INT(1, released);
+    TEST_ASSERT_EQUAL_INT(0, epoch_pending());
+}
+
+void test_epoch_exit_should_release_pending(void)
+{
+    int data;
+    tst_reader_t reader = { .entered = false, .leave = false };
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, &reader));
+    while (!atomic_load(&reader.entered)) {
+        sched_yield();
+    }
+
+    epoch_retire(&data, tst_release);
+    TEST_ASSERT_EQUAL_INT(1, epoch_pending());
+
+    // No further writer: The exit of the last reader releases.
+    atomic_store(&reader.leave, true);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_INT(1, released);
+    TEST_ASSERT_EQUAL_INT(0, epoch_pending());
+}
+
+void test_epoch_reader_entered_after_retire_should_not_block(void)
+{
+    int data_a, data_b;
+    tst_reader_t reader = { .entered = false, .leave = false };
+    pthread_t thread;
+
+    epoch_retire(&data_a, tst_release);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, &reader));
+    while (!atomic_load(&reader.entered)) {
+        sched_yield();
+    }
+    // The reader can't see data_a anymore, but data_b.
+    TEST_ASSERT_EQUAL_INT(1, released);
+    epoch_retire(&data_b, tst_release);
+    TEST_ASSERT_EQUAL_INT(1, released);
+
+    atomic_store(&reader.leave, true);
+    pthread_join(thread, NULL);
+    epoch_synchronize();
+    TEST_ASSERT_EQUAL_INT(2, released);
+}
+
+// ---- epoch_enter / epoch_exit ----
+void test_epoch_enter_should_nest(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, epoch_enter());
+    TEST_ASSERT_EQUAL_INT(0, epoch_enter());
+    epoch_exit();
+    epoch_exit();
+    // Not in a critical section anymore: Must not deadlock.
+    epoch_synchronize();
+
+    // Unbalanced exit is ignored.
+    epoch_exit();
+    epoch_synchronize();
+}
+
+void test_epoch_thread_exit_inside_section_should_not_block(void)
+{
+    int data_a, data_b;
+    tst_reader_t reader = { .entered = false, .leave = false };
+    pthread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader_exiting, NULL));
+    pthread_join(thread, NULL);
+
+    // The record of the terminated thread is not active anymore.
+    epoch_retire(&data_a, tst_release);
+    TEST_ASSERT_EQUAL_INT(1, released);
+
+    // The next thread reuses the record with depth 0: A single exit leaves its section.
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, tst_reader, &reader));
+    while (!atomic_load(&reader.entered)) {
+        sched_yield();
+    }
+    atomic_store(&reader.leave, true);
+    pthread_join(thread, NULL);
+    epoch_retire(&data_b, tst_release);
+    TEST_ASSERT_EQUAL_INT(2, released);
+}
+
+void test_epoch_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_epoch_retire_without_readers_should_release);
+    RUN(test_epoch_retire_with_active_reader_should_defer);
+    RUN(test_epoch_exit_should_release_pending);
+    RUN(test_epoch_reader_entered_after_retire_should_not_block);
+    RUN(test_epoch_enter_should_nest);
+    RUN(test_epoch_thread_exit_inside_section_should_not_block);
+#undef RUN
+}
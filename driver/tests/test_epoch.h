@@ -0,0 +1,8 @@
+#ifndef _TEST_EPOCH_H_
+#define _TEST_EPOCH_H_
+
+void test_epoch_setUp(void);
+void test_epoch_tearDown(void);
+void test_epoch_run_all();
+
+#endif //_TEST_EPOCH_H_
@@ -0,0 +1,85 @@
+#include "unity.h"
+#include "intern.h"
+#include "hash.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+// ---- Setup / Cleanup -----
+void test_intern_setUp(void)
+{
+}
+
+void test_intern_tearDown(void)
+{
+}
+
+// ---- intern_str ----
+void test_intern_same_name_should_share_storage(void)
+{
+    char name_a[] = "tst_intern_pin";
+    char name_b[] = "tst_intern_pin";
+    size_t count = intern_count();
+
+    const char* interned_a = intern_str(name_a, NULL, NULL);
+    const char* interned_b = intern_str(name_b, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(interned_a);
+    TEST_ASSERT_EQUAL_PTR(interned_a, interned_b);
+    TEST_ASSERT_TRUE(interned_a != name_a);                     // Copied
+    TEST_ASSERT_EQUAL_STRING("tst_intern_pin", interned_a);
+    TEST_ASSERT_EQUAL_INT(count + 1, intern_count());
+
+    const char* other = intern_str("tst_intern_port", NULL, NULL);
+    TEST_ASSERT_TRUE(other != interned_a);
+    TEST_ASSERT_EQUAL_INT(count + 2, intern_count());
+}
+
+void test_intern_should_return_hash_and_length(void)
+{
+    uint32_t hash = 0, len = 0;
+    TEST_ASSERT_NOT_NULL(intern_str("tst_intern_hash", &hash, &len));
+    TEST_ASSERT_EQUAL_UINT(hash_str("tst_intern_hash"), hash);
+    TEST_ASSERT_EQUAL_INT(strlen("tst_intern_hash"), len);
+
+    // Already interned
+    hash = 0; len = 0;
+    TEST_ASSERT_NOT_NULL(intern_str("tst_intern_hash", &hash, &len));
+    TEST_ASSERT_EQUAL_UINT(hash_str("tst_intern_hash"), hash);
+    TEST_ASSERT_EQUAL_INT(strlen("tst_intern_hash"), len);
+
+    TEST_ASSERT_NOT_NULL(intern_str("", &hash, &len));
+    TEST_ASSERT_EQUAL_INT(0, len);
+}
+
+void test_intern_many_names_should_grow(void)
+{
+    const char* interned[200];
+    char name[32];
+    for (size_t i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "tst_intern_%zu", i);
+        interned[i] = intern_str(name, NULL, NULL);
+        TEST_ASSERT_NOT_NULL(interned[i]);
+    }
+    // Still the same storage after the table has grown.
+    for (size_t i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "tst_intern_%zu", i);
+        TEST_ASSERT_EQUAL_PTR(interned[i], intern_str(name, NULL, NULL));
+    }
+}
+
+void test_intern_param_check_should_fail(void)
+{
+    errno = 0;
+    TEST_ASSERT_NULL(intern_str(NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_intern_run_all() {
+    // alle Tests aufrufen
+#define RUN(x) RUN_TEST(x)
+    RUN(test_intern_same_name_should_share_storage);
+    RUN(test_intern_should_return_hash_and_length);
+    RUN(test_intern_many_names_should_grow);
+    RUN(test_intern_param_check_should_fail);
+#undef RUN
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_INTERN_H_
+#define _TEST_INTERN_H_
+
+void test_intern_setUp(void);
+void test_intern_tearDown(void);
+void test_intern_run_all();
+
+#endif //_TEST_INTERN_H_
@@ -1,8 +1,11 @@
 #include "unity.h"
 #include "registry.h"
+#include "intern.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
 
 // ---- Dummy-Kontext und Treiber ----
 
@@ -24,9 +27,37 @@ void test_registry_setUp(void)
 void test_registry_tearDown(void)
 {
     free(reg.driver_list);
+    free(reg.name_index);
+    free(reg.reg_name_index);
+    free(reg.used_map);
+    free(reg.generations);
+    ptr_index_free(&reg.driver_index);
+    free(atomic_load(&reg.snapshot));
     memset(&reg, 0, sizeof(registry_t));
 }
 
+// ---- Helper for tests with many drivers ----
+#define TST_MANY_DRIVERS (100U)
+
+typedef struct {
+    driver_t drv[TST_MANY_DRIVERS];
+    driver_ctx_t ctx[TST_MANY_DRIVERS];
+    char name[TST_MANY_DRIVERS][16];
+    char reg_name[TST_MANY_DRIVERS][16];
+} tst_many_t;
+
+static tst_many_t* tst_many_create(void)
+{
+    tst_many_t* many = calloc(1, sizeof(tst_many_t));
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        snprintf(many->name[i], sizeof(many->name[i]), "pin%zu", i);
+        snprintf(many->reg_name[i], sizeof(many->reg_name[i]), "reg_pin%zu", i);
+        memcpy(&many->ctx[i], &(driver_ctx_t){ .reg_name = many->reg_name[i] }, sizeof(driver_ctx_t));
+        memcpy(&many->drv[i], &(driver_t){ .name = many->name[i], .ctx = &many->ctx[i] }, sizeof(driver_t));
+    }
+    return many;
+}
+
 // ---- registry_add_driver ----
 void test_add_valid_driver_should_succeed(void)
 {
@@ -124,6 +155,82 @@ void test_remove_with_null_args_should_fail(void)
     TEST_ASSERT_EQUAL_INT(EINVAL, errno);
 }
 
+// ---- registry_add_drivers / registry_remove_drivers ----
+void test_add_drivers_should_add_all(void)
+{
+    tst_many_t* many = tst_many_create();
+    const driver_t* drivers[TST_MANY_DRIVERS];
+    int errors[TST_MANY_DRIVERS];
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        drivers[i] = &many->drv[i];
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, registry_add_drivers(&reg, drivers, TST_MANY_DRIVERS, errors));
+    TEST_ASSERT_EQUAL_INT(TST_MANY_DRIVERS, reg.driver_list_used);
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, errors[i]);
+        TEST_ASSERT_EQUAL_PTR(drivers[i], registry_get_driver_by_name(&reg, many->name[i]));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_drivers(&reg, drivers, TST_MANY_DRIVERS, errors));
+    TEST_ASSERT_EQUAL_INT(0, reg.driver_list_used);
+    free(many);
+}
+
+void test_add_drivers_with_duplicate_should_add_none(void)
+{
+    const driver_t* batch[] = { &drv2, &drv1, &drv2 };
+    int errors[3];
+
+    // Duplicate within the batch
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_drivers(&reg, batch, 3, errors));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+    TEST_ASSERT_EQUAL_INT(ECANCELED, errors[0]);
+    TEST_ASSERT_EQUAL_INT(ECANCELED, errors[1]);
+    TEST_ASSERT_EQUAL_INT(EEXIST, errors[2]);
+    TEST_ASSERT_EQUAL_INT(0, reg.driver_list_used);
+
+    // Duplicate of a registered driver, without error report.
+    registry_add_driver(&reg, &drv1);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_drivers(&reg, batch, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+    TEST_ASSERT_EQUAL_INT(1, reg.driver_list_used);
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_name(&reg, "drv1"));
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&reg, "drv2"));
+}
+
+void test_add_drivers_failed_should_keep_generations(void)
+{
+    const driver_t* batch[] = { &drv2, &drv1 };
+    registry_handle_t handle;
+    registry_add_driver(&reg, &drv1);
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv1, &handle));
+    uint32_t generation = registry_generation();
+    uint32_t slot_generation = reg.generations[1];
+
+    // drv2 was never visible: Rollback must neither invalidate caches nor handles.
+    TEST_ASSERT_EQUAL_INT(-1, registry_add_drivers(&reg, batch, 2, NULL));
+    TEST_ASSERT_EQUAL_UINT(generation, registry_generation());
+    TEST_ASSERT_EQUAL_UINT(slot_generation, reg.generations[1]);
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_handle(&reg, handle));
+}
+
+void test_remove_drivers_with_unknown_should_remove_none(void)
+{
+    const driver_t* batch[] = { &drv1, &drv2 };
+    int errors[2];
+    registry_add_driver(&reg, &drv1);
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_remove_drivers(&reg, batch, 2, errors));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    TEST_ASSERT_EQUAL_INT(ECANCELED, errors[0]);
+    TEST_ASSERT_EQUAL_INT(ENOENT, errors[1]);
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_name(&reg, "drv1"));
+}
+
 // ---- registry_free_registry ----
 void test_free_empty_registry_should_succeed(void)
 {
@@ -167,6 +274,30 @@ void test_get_driver_by_name_should_return_null_on_not_found(void)
     TEST_ASSERT_EQUAL_INT(ENOENT, errno);
 }
 
+void test_get_driver_by_name_with_many_drivers_should_find_all(void)
+{
+    tst_many_t* many = tst_many_create();
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &many->drv[i]));
+    }
+
+    // Remove every third driver, the others must still be found.
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i += 3) {
+        TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &many->drv[i]));
+    }
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        driver_t* expected = (i % 3 == 0) ? NULL : &many->drv[i];
+        TEST_ASSERT_EQUAL_PTR(expected, registry_get_driver_by_name(&reg, many->name[i]));
+        TEST_ASSERT_EQUAL_PTR(expected, registry_get_driver_by_reg_name(&reg, many->reg_name[i]));
+    }
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
 // ---- registry_get_driver_by_reg_name ----
 void test_get_driver_by_reg_name_should_return_correct_pointer(void)
 {
@@ -175,6 +306,21 @@ void test_get_driver_by_reg_name_should_return_correct_pointer(void)
     TEST_ASSERT_EQUAL_PTR(&drv1, found);
 }
 
+void test_get_driver_by_reg_name_interned_should_return_correct_pointer(void)
+{
+    static driver_ctx_t ctx = { .reg_name = NULL };
+    static driver_t drv = { .name = "drv_interned", .ctx = &ctx };
+    ctx.reg_name = intern_str("reg_interned", &ctx.reg_name_hash, &ctx.reg_name_len);
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv));
+
+    char copy[] = "reg_interned";
+    TEST_ASSERT_EQUAL_PTR(&drv, registry_get_driver_by_reg_name(&reg, ctx.reg_name));   // Same pointer
+    TEST_ASSERT_EQUAL_PTR(&drv, registry_get_driver_by_reg_name(&reg, copy));           // Byte compare
+    TEST_ASSERT_NULL(registry_get_driver_by_reg_name(&reg, "reg_intern"));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &drv));
+    TEST_ASSERT_NULL(registry_get_driver_by_reg_name(&reg, copy));
+}
+
 void test_get_driver_by_reg_name_should_return_null_on_not_found(void)
 {
     registry_add_driver(&reg, &drv1);
@@ -250,6 +396,27 @@ void test_get_index_by_driver_should_return_negative_on_not_found(void)
     TEST_ASSERT_EQUAL_INT(EEXIST, errno);
 }
 
+void test_get_index_by_driver_with_many_drivers_should_return_correct_index(void)
+{
+    tst_many_t* many = tst_many_create();
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+    for (size_t i = 1; i < TST_MANY_DRIVERS; i += 2) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        TEST_ASSERT_EQUAL_INT((i % 2) ? -1 : (ssize_t)i, registry_get_index_by_driver(&reg, &many->drv[i]));
+    }
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
 // ---- registry_get_free_index ----
 void test_get_free_index_should_return_first_free_slot(void)
 {
@@ -259,6 +426,117 @@ void test_get_free_index_should_return_first_free_slot(void)
     TEST_ASSERT_EQUAL_INT(0, registry_get_free_index(&reg));
 }
 
+void test_get_free_index_with_many_drivers_should_return_lowest_free_slot(void)
+{
+    tst_many_t* many = tst_many_create();
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+
+    // Free slots in the second and first bitmap word. The lowest must be returned.
+    registry_remove_driver(&reg, &many->drv[70]);
+    TEST_ASSERT_EQUAL_INT(70, registry_get_free_index(&reg));
+    registry_remove_driver(&reg, &many->drv[5]);
+    TEST_ASSERT_EQUAL_INT(5, registry_get_free_index(&reg));
+
+    // Refill the slots in ascending order.
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &many->drv[5]));
+    TEST_ASSERT_EQUAL_INT(5, registry_get_index_by_driver(&reg, &many->drv[5]));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &many->drv[70]));
+    TEST_ASSERT_EQUAL_INT(70, registry_get_index_by_driver(&reg, &many->drv[70]));
+    TEST_ASSERT_EQUAL_INT(registry_get_size(&reg) - TST_MANY_DRIVERS, registry_get_space(&reg));
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
+// ---- registry_reserve / registry_compact ----
+void test_registry_should_grow_geometrically(void)
+{
+    tst_many_t* many = tst_many_create();
+    for (size_t i = 0; i < REGISTRY_EXPAND_SIZE + 1; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(REGISTRY_EXPAND_SIZE * REGISTRY_GROWTH_FACTOR, registry_get_size(&reg));
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
+void test_registry_reserve_should_expand(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, registry_reserve(&reg, TST_MANY_DRIVERS));
+    TEST_ASSERT_EQUAL_INT(TST_MANY_DRIVERS, registry_get_size(&reg));
+    TEST_ASSERT_EQUAL_INT(TST_MANY_DRIVERS, registry_get_space(&reg));
+
+    // Reserving less never shrinks.
+    TEST_ASSERT_EQUAL_INT(0, registry_reserve(&reg, 1));
+    TEST_ASSERT_EQUAL_INT(TST_MANY_DRIVERS, registry_get_size(&reg));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_reserve(NULL, 1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+void test_registry_compact_should_move_drivers_down(void)
+{
+    tst_many_t* many = tst_many_create();
+    reg.policy.stable_index = true;             // No automatic compaction
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+    for (size_t i = 0; i < TST_MANY_DRIVERS - 10; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+
+    // Not allowed with stable indexes.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_compact(&reg));
+    TEST_ASSERT_EQUAL_INT(EPERM, errno);
+
+    reg.policy.stable_index = false;
+    TEST_ASSERT_EQUAL_INT(0, registry_compact(&reg));
+    TEST_ASSERT_EQUAL_INT(10, registry_get_size(&reg));
+    TEST_ASSERT_EQUAL_INT(0, registry_get_space(&reg));
+    for (size_t i = 0; i < 10; i++) {
+        driver_t* drv = &many->drv[TST_MANY_DRIVERS - 10 + i];
+        TEST_ASSERT_EQUAL_PTR(drv, registry_get_driver_by_index(&reg, i));
+        TEST_ASSERT_EQUAL_PTR(drv, registry_get_driver_by_name(&reg, drv->name));
+    }
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
+void test_registry_should_compact_automatically(void)
+{
+    tst_many_t* many = tst_many_create();
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+    ssize_t size = registry_get_size(&reg);
+    for (size_t i = 0; i < TST_MANY_DRIVERS - 2; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    TEST_ASSERT_LESS_THAN_INT(size, registry_get_size(&reg));
+    TEST_ASSERT_EQUAL_PTR(&many->drv[TST_MANY_DRIVERS - 1], registry_get_driver_by_name(&reg, many->name[TST_MANY_DRIVERS - 1]));
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
 // ---- registry_get_space ----
 void test_registry_get_space_should_return_correct_number(void)
 {
@@ -290,6 +568,290 @@ void test_registry_get_size_with_null_should_fail(void)
     TEST_ASSERT_EQUAL_INT(EINVAL, errno);
 }
 
+// ---- registry_get_handle / registry_get_driver_by_handle ----
+void test_registry_handle_should_resolve_driver(void)
+{
+    registry_handle_t handle;
+    registry_add_driver(&reg, &drv1);
+    registry_add_driver(&reg, &drv2);
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv2, &handle));
+    TEST_ASSERT_EQUAL_INT(1, handle.index);
+    TEST_ASSERT_EQUAL_PTR(&drv2, registry_get_driver_by_handle(&reg, handle));
+}
+
+void test_registry_handle_of_removed_driver_should_be_stale(void)
+{
+    registry_handle_t handle, reused;
+    registry_add_driver(&reg, &drv1);
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv1, &handle));
+    registry_remove_driver(&reg, &drv1);
+
+    errno = 0;
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handle));
+    TEST_ASSERT_EQUAL_INT(ESTALE, errno);
+
+    // The slot is reused by another driver: The old handle must not resolve to it.
+    registry_add_driver(&reg, &drv2);
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv2, &reused));
+    TEST_ASSERT_EQUAL_INT(handle.index, reused.index);
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handle));
+    TEST_ASSERT_EQUAL_PTR(&drv2, registry_get_driver_by_handle(&reg, reused));
+}
+
+void test_registry_handle_of_moved_driver_should_be_stale(void)
+{
+    tst_many_t* many = tst_many_create();
+    registry_handle_t handles[TST_MANY_DRIVERS];
+    reg.policy.stable_index = true;             // No automatic compaction
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+        registry_get_handle(&reg, &many->drv[i], &handles[i]);
+    }
+    for (size_t i = 0; i < TST_MANY_DRIVERS - 10; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+
+    reg.policy.stable_index = false;
+    TEST_ASSERT_EQUAL_INT(0, registry_compact(&reg));
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handles[i]));
+    }
+
+    // The list has shrunk. Slots, which come back after growing again, must not match old handles.
+    for (size_t i = 0; i < TST_MANY_DRIVERS - 10; i++) {
+        registry_add_driver(&reg, &many->drv[i]);
+    }
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_handle_t handle;
+        TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handles[i]));
+        TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &many->drv[i], &handle));
+        TEST_ASSERT_EQUAL_PTR(&many->drv[i], registry_get_driver_by_handle(&reg, handle));
+    }
+
+    //Cleanup
+    for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+        registry_remove_driver(&reg, &many->drv[i]);
+    }
+    free(many);
+}
+
+void test_registry_handle_param_check_should_fail(void)
+{
+    registry_handle_t handle = { .index = 0, .generation = 0 };
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_get_handle(NULL, &drv1, &handle));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_get_handle(&reg, &drv1, NULL));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_get_handle(&reg, &drv1, &handle));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(NULL, handle));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handle));      // Empty registry
+    TEST_ASSERT_EQUAL_INT(ESTALE, errno);
+}
+
+// ---- registry_make_concurrent ----
+void test_registry_make_concurrent_should_keep_drivers(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv1));
+    TEST_ASSERT_EQUAL_INT(0, registry_make_concurrent(&reg));
+    TEST_ASSERT_TRUE(reg.policy.stable_index);
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_name(&reg, "drv1"));
+
+    registry_handle_t handle;
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv1, &handle));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv2));
+    TEST_ASSERT_EQUAL_PTR(&drv2, registry_get_driver_by_reg_name(&reg, "reg_drv2"));
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_handle(&reg, handle));
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &drv1));
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&reg, "drv1"));
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handle));
+    TEST_ASSERT_EQUAL_INT(1, registry_get_index_by_driver(&reg, &drv2));
+
+    // No compaction in concurrent mode.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_compact(&reg));
+    TEST_ASSERT_EQUAL_INT(EPERM, errno);
+
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &drv2));
+    TEST_ASSERT_EQUAL_INT(0, registry_free_registry(&reg));
+}
+
+#define TST_STRESS_FIXED    (TST_MANY_DRIVERS / 2)  // Drivers, which stay registered.
+#define TST_STRESS_READERS  (4U)
+#define TST_STRESS_ROUNDS   (200U)
+
+typedef struct {
+    tst_many_t* many;
+    atomic_bool stop;
+    atomic_size_t errors;
+} tst_stress_t;
+
+// Reader thread: Fixed drivers must always be found, the others either correct or not at all.
+static void* tst_stress_reader(void* arg)
+{
+    tst_stress_t* stress = arg;
+    while (!atomic_load(&stress->stop)) {
+        for (size_t i = 0; i < TST_MANY_DRIVERS; i++) {
+            driver_t* drv = registry_get_driver_by_name(&reg, stress->many->name[i]);
+            if ((drv != &stress->many->drv[i]) && ((i < TST_STRESS_FIXED) || (drv != NULL))) {
+                atomic_fetch_add(&stress->errors, 1);
+            }
+        }
+    }
+    return NULL;
+}
+
+void test_registry_concurrent_lookups_should_see_consistent_drivers(void)
+{
+    tst_stress_t stress = { .many = tst_many_create(), .stop = false, .errors = 0 };
+    pthread_t readers[TST_STRESS_READERS];
+
+    TEST_ASSERT_EQUAL_INT(0, registry_make_concurrent(&reg));
+    for (size_t i = 0; i < TST_STRESS_FIXED; i++) {
+        TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &stress.many->drv[i]));
+    }
+    for (size_t i = 0; i < TST_STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], NULL, tst_stress_reader, &stress));
+    }
+
+    // Hot plug the other drivers, single and in batches.
+    int writer_errors = 0;
+    for (size_t round = 0; round < TST_STRESS_ROUNDS; round++) {
+        const driver_t* batch[TST_MANY_DRIVERS - TST_STRESS_FIXED];
+        for (size_t i = TST_STRESS_FIXED; i < TST_MANY_DRIVERS; i++) {
+            batch[i - TST_STRESS_FIXED] = &stress.many->drv[i];
+            if ((round % 2) == 0) {
+                writer_errors += (registry_add_driver(&reg, &stress.many->drv[i]) != 0);
+            }
+        }
+        if ((round % 2) != 0) {
+            writer_errors += (registry_add_drivers(&reg, batch, TST_MANY_DRIVERS - TST_STRESS_FIXED, NULL) != 0);
+        }
+        writer_errors += (registry_remove_drivers(&reg, batch, TST_MANY_DRIVERS - TST_STRESS_FIXED, NULL) != 0);
+    }
+
+    atomic_store(&stress.stop, true);
+    for (size_t i = 0; i < TST_STRESS_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(0, writer_errors);
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&stress.errors));
+
+    for (size_t i = 0; i < TST_STRESS_FIXED; i++) {
+        TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &stress.many->drv[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(0, registry_free_registry(&reg));
+    free(stress.many);
+}
+
+// ---- registry_replace_driver ----
+static driver_ctx_t ctx1b = { .reg_name = "reg_drv1" };
+static driver_t drv1b = { .name = "drv1b", .ctx = (void*)&ctx1b };
+
+void test_replace_driver_should_swap(void)
+{
+    registry_handle_t handle;
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv1));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv2));
+    TEST_ASSERT_EQUAL_INT(0, registry_get_handle(&reg, &drv1, &handle));
+    uint32_t generation = registry_generation();
+
+    // Same registered name: The new driver takes the place of the old one.
+    TEST_ASSERT_EQUAL_INT(0, registry_replace_driver(&reg, &drv1, &drv1b));
+    TEST_ASSERT_EQUAL_PTR(&drv1b, registry_get_driver_by_reg_name(&reg, "reg_drv1"));
+    TEST_ASSERT_EQUAL_PTR(&drv1b, registry_get_driver_by_name(&reg, "drv1b"));
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&reg, "drv1"));
+    TEST_ASSERT_TRUE(registry_get_index_by_driver(&reg, &drv1) < 0);
+    TEST_ASSERT_EQUAL_INT(2, reg.driver_list_used);
+    TEST_ASSERT_NULL(registry_get_driver_by_handle(&reg, handle));
+    TEST_ASSERT_TRUE(registry_generation() != generation);
+
+    // And back.
+    TEST_ASSERT_EQUAL_INT(0, registry_replace_driver(&reg, &drv1b, &drv1));
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_reg_name(&reg, "reg_drv1"));
+    TEST_ASSERT_NULL(registry_get_driver_by_name(&reg, "drv1b"));
+    TEST_ASSERT_EQUAL_PTR(&drv2, registry_get_driver_by_reg_name(&reg, "reg_drv2"));
+}
+
+void test_replace_driver_invalid_should_change_nothing(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv2));
+
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_replace_driver(NULL, &drv2, &drv1));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_replace_driver(&reg, &drv2, &drv2));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    // Old driver not registered.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_replace_driver(&reg, &drv1, &drv1b));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+
+    // The registered name belongs to another driver.
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv1));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_replace_driver(&reg, &drv2, &drv1b));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+
+    // New driver already registered.
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, registry_replace_driver(&reg, &drv2, &drv1));
+    TEST_ASSERT_EQUAL_INT(EEXIST, errno);
+
+    TEST_ASSERT_EQUAL_PTR(&drv1, registry_get_driver_by_reg_name(&reg, "reg_drv1"));
+    TEST_ASSERT_EQUAL_PTR(&drv2, registry_get_driver_by_reg_name(&reg, "reg_drv2"));
+    TEST_ASSERT_EQUAL_INT(2, reg.driver_list_used);
+}
+
+// Reader thread: The registered name must always find one of both drivers.
+static void* tst_replace_reader(void* arg)
+{
+    tst_stress_t* stress = arg;
+    while (!atomic_load(&stress->stop)) {
+        driver_t* drv = registry_get_driver_by_reg_name(&reg, "reg_drv1");
+        if ((drv != &drv1) && (drv != &drv1b)) {
+            atomic_fetch_add(&stress->errors, 1);
+        }
+    }
+    return NULL;
+}
+
+void test_replace_driver_concurrent_should_never_miss(void)
+{
+    tst_stress_t stress = { .many = NULL, .stop = false, .errors = 0 };
+    pthread_t readers[TST_STRESS_READERS];
+
+    TEST_ASSERT_EQUAL_INT(0, registry_make_concurrent(&reg));
+    TEST_ASSERT_EQUAL_INT(0, registry_add_driver(&reg, &drv1));
+    for (size_t i = 0; i < TST_STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], NULL, tst_replace_reader, &stress));
+    }
+
+    int writer_errors = 0;
+    for (size_t round = 0; round < TST_STRESS_ROUNDS; round++) {
+        writer_errors += (registry_replace_driver(&reg, &drv1, &drv1b) != 0);
+        writer_errors += (registry_replace_driver(&reg, &drv1b, &drv1) != 0);
+    }
+
+    atomic_store(&stress.stop, true);
+    for (size_t i = 0; i < TST_STRESS_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(0, writer_errors);
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&stress.errors));
+
+    TEST_ASSERT_EQUAL_INT(0, registry_remove_driver(&reg, &drv1));
+    TEST_ASSERT_EQUAL_INT(0, registry_free_registry(&reg));
+}
+
 void test_registry_run_all() {
     // alle Tests aufrufen
 #define RUN(x) RUN_TEST(x)
@@ -300,12 +862,18 @@ void test_registry_run_all() {
     RUN(test_remove_existing_driver_should_succeed);
     RUN(test_remove_nonexistent_driver_should_fail);
     RUN(test_remove_with_null_args_should_fail);
+    RUN(test_add_drivers_should_add_all);
+    RUN(test_add_drivers_with_duplicate_should_add_none);
+    RUN(test_add_drivers_failed_should_keep_generations);
+    RUN(test_remove_drivers_with_unknown_should_remove_none);
     RUN(test_free_empty_registry_should_succeed);
     RUN(test_free_nonempty_registry_should_fail);
     RUN(test_free_null_registry_should_fail);
     RUN(test_get_driver_by_name_should_return_correct_pointer);
     RUN(test_get_driver_by_name_should_return_null_on_not_found);
+    RUN(test_get_driver_by_name_with_many_drivers_should_find_all);
     RUN(test_get_driver_by_reg_name_should_return_correct_pointer);
+    RUN(test_get_driver_by_reg_name_interned_should_return_correct_pointer);
     RUN(test_get_driver_by_reg_name_should_return_null_on_not_found);
     RUN(test_get_driver_by_index_should_return_correct_pointer);
     RUN(test_get_driver_by_index_out_of_bounds_should_return_null);
@@ -315,10 +883,25 @@ void test_registry_run_all() {
     RUN(test_get_index_by_reg_name_should_return_negative_on_not_found);
     RUN(test_get_index_by_driver_should_return_correct_index);
     RUN(test_get_index_by_driver_should_return_negative_on_not_found);
+    RUN(test_get_index_by_driver_with_many_drivers_should_return_correct_index);
     RUN(test_get_free_index_should_return_first_free_slot);
+    RUN(test_get_free_index_with_many_drivers_should_return_lowest_free_slot);
+    RUN(test_registry_should_grow_geometrically);
+    RUN(test_registry_reserve_should_expand);
+    RUN(test_registry_compact_should_move_drivers_down);
+    RUN(test_registry_should_compact_automatically);
     RUN(test_registry_get_space_should_return_correct_number);
     RUN(test_registry_get_space_with_null_should_fail);
     RUN(test_registry_get_size_should_return_size);
     RUN(test_registry_get_size_with_null_should_fail);
+    RUN(test_registry_handle_should_resolve_driver);
+    RUN(test_registry_handle_of_removed_driver_should_be_stale);
+    RUN(test_registry_handle_of_moved_driver_should_be_stale);
+    RUN(test_registry_handle_param_check_should_fail);
+    RUN(test_registry_make_concurrent_should_keep_drivers);
+    RUN(test_registry_concurrent_lookups_should_see_consistent_drivers);
+    RUN(test_replace_driver_should_swap);
+    RUN(test_replace_driver_invalid_should_change_nothing);
+    RUN(test_replace_driver_concurrent_should_never_miss);
 #undef RUN
 }
\ No newline at end of file
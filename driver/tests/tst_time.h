@@ -0,0 +1,13 @@
+#ifndef _TST_TIME_H_
+#define _TST_TIME_H_
+
+#include <time.h>
+
+// Vergangene Zeit seit start (CLOCK_MONOTONIC) in ms.
+static inline long tst_elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000L + (now.tv_nsec - start->tv_nsec) / 1000000L;
+}
+
+#endif //_TST_TIME_H_
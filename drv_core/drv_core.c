@@ -2,31 +2,49 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <poll.h>
 #include <types.h>
+#include <driver.h>
 
 #include <registry.h>
+#include <epoch.h>
+#include <drv_stats.h>
+#include <drv_tracepoint.h>
+
+#ifdef DRV_MPH_TABLE
+// Perfekter Hash der zur Build-Zeit bekannten Treibernamen, erzeugt von drv_mph_generate() (siehe drv_core.names).
+extern const drv_mph_table_t DRV_MPH_TABLE;
+#endif
 
 /*
  * LOCAL Prototypes
  */
+static registry_t* drv_core_registry(driver_t* base_driver);
 static int drv_core_reg_drv(driver_t* base_driver, const char* name, driver_t* driver);
 static int drv_core_dereg_drv(driver_t* base_driver, driver_t* driver);
+static int drv_core_replace_drv(driver_t* base_driver, driver_t* old_driver, driver_t* new_driver);
 static driver_t* drv_core_open(driver_t* base_driver, const char* name);
+static driver_t* drv_core_lookup(driver_t* base_driver, const char* name);
 static int drv_core_close(driver_t* driver);
 static ssize_t drv_core_read(driver_t* driver, void* buffer, size_t count);
 static ssize_t drv_core_write(driver_t* driver, const void* buffer, size_t count);
 static int drv_core_ioctl(driver_t* driver, size_t id, void* param);
+static ssize_t drv_core_readv(driver_t* driver, const struct iovec* iov, int iovcnt);
+static ssize_t drv_core_writev(driver_t* driver, const struct iovec* iov, int iovcnt);
+static short drv_core_poll(driver_t* driver, short events);
 static size_t drv_core_get_properties(driver_t* driver);
 static property_t* drv_core_get_property(driver_t* driver, size_t id);
+static int drv_core_reg_drv_many(driver_t* base_driver, const char* const names[], driver_t* const drivers[], size_t count, int* errors);
+static int drv_core_dereg_drv_many(driver_t* base_driver, driver_t* const drivers[], size_t count, int* errors);
 
 /*
  * LOCAL Variables 
  */
 
 static registry_t drv_core_params = {
-    NULL,
-    0,
-    0
+    .driver_list = NULL,
+    .driver_list_size = 0,
+    .driver_list_used = 0,
 };
 
 const driver_fops_t drv_core_fops = {
@@ -39,6 +57,13 @@ const driver_fops_t drv_core_fops = {
         .ioctl = drv_core_ioctl,
         .get_properties = drv_core_get_properties,
         .get_property = drv_core_get_property,
+        .reg_drv_many = drv_core_reg_drv_many,
+        .dereg_drv_many = drv_core_dereg_drv_many,
+        .lookup = drv_core_lookup,
+        .readv = drv_core_readv,
+        .writev = drv_core_writev,
+        .poll = drv_core_poll,
+        .replace_drv = drv_core_replace_drv,
 };
 
 static const property_t drv_core_properties[] = {
@@ -65,9 +90,33 @@ static const driver_t drv_core_config = {
 
 const driver_t const* drv_core = &drv_core_config;
 
+/*
+ * GLOBAL Functions
+ */
+int drv_core_init(void) {
+    // Übernimmt die statisch registrierten Treiber. Wird sonst beim ersten Zugriff automatisch aufgerufen.
+    if (drv_core_registry((driver_t*)drv_core) == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+    return 0;
+}
+
 /*
  * LOCAL Functions
  */
+// Liefert die Registry des Treibers. Beim ersten Aufruf werden die statisch registrierten Treiber übernommen (ohne Heap).
+static registry_t* drv_core_registry(driver_t* base_driver) {
+    registry_t* registry = (registry_t*) base_driver->user;
+    if ((registry != NULL) && (!registry->static_attached)) {
+        registry_attach_static(registry, base_driver);
+#ifdef DRV_MPH_TABLE
+        registry_attach_mph(registry, &DRV_MPH_TABLE);
+#endif
+    }
+    return registry;
+}
+
 static int drv_core_reg_drv(driver_t* base_driver, const char* name, driver_t* driver) {
     // base_driver kann nicht null sein, da von drv_register() drv_core_reg_drv über base_driver->fop aufgerufen wird.
     // name und driver sind schon vorab auf Gültigkeit geprüft.
@@ -78,69 +127,103 @@ static int drv_core_reg_drv(driver_t* base_driver, const char* name, driver_t* d
         return -1;
     }
 
-    registry_t* registry = (registry_t*) base_driver->user;
+    registry_t* registry = drv_core_registry(base_driver);
     // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
     if (registry == NULL) {
         errno = ENOSYS;
         return -1;
     }
 
-    return registry_add_driver(registry, driver);
+    int result = registry_add_driver(registry, driver);
+    DRV_TRACEPOINT(CORE_REG_DRV, (result == 0) ? 0 : errno);
+    return result;
 
 }
 
 static int drv_core_dereg_drv(driver_t* base_driver, driver_t* driver) {
     ssize_t index;
 
-    registry_t* registry = (registry_t*) base_driver->user;
+    registry_t* registry = drv_core_registry(base_driver);
     // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
     if (registry == NULL) {
         errno = ENOSYS;
         return -1;
     }
 
-    return registry_remove_driver(registry, driver);
+    int result = registry_remove_driver(registry, driver);
+    DRV_TRACEPOINT(CORE_DEREG_DRV, (result == 0) ? 0 : errno);
+    return result;
+}
+
+static int drv_core_replace_drv(driver_t* base_driver, driver_t* old_driver, driver_t* new_driver) {
+    // Wie bei drv_core_reg_drv: Core-Treiber darf nicht registriert werden.
+    if (new_driver->type == DRV_CORE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    registry_t* registry = drv_core_registry(base_driver);
+    // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
+    if (registry == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return registry_replace_driver(registry, old_driver, new_driver);
 }
 
 static driver_t* drv_core_open(driver_t* base_driver, const char* name) {
 
-    registry_t* registry = (registry_t*) base_driver->user;
+    registry_t* registry = drv_core_registry(base_driver);
     // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
     if (registry == NULL) {
         errno = ENOSYS;
         return NULL;
     }
     
-    // Suche Treiberhandle
+    // Suche und öffne den Treiber in einer Epoche: Ein gleichzeitig abgemeldeter Treiber
+    // wird erst freigegeben, wenn die Epoche verlassen ist (siehe driver_fops_t::release).
+    if (epoch_enter() != 0) {
+        return NULL;
+    }
     driver_t* driver = registry_get_driver_by_name(registry, name);
     if ((driver == NULL) || (driver->ctx == NULL)) {
+        epoch_exit();
+        DRV_TRACEPOINT(CORE_OPEN, ENOENT);
         errno = ENOENT;
         return NULL;
     }
 
-    // Erhöhe die Anzahl der geöffneten handles
-    if ((driver->ctx->open_max == 0) || (driver->ctx->open_cntr < driver->ctx->open_max)) {
-        driver->ctx->open_cntr++;
-        return driver;
+    // Erhöhe die Anzahl der geöffneten handles (atomar). Schlägt mit EBUSY fehl,
+    // wenn die max. Anzahl der gleichzeitigen Öffnungen überschritten ist, und mit ENOENT,
+    // wenn der Treiber inzwischen abgemeldet wurde.
+    int result = drv_open_acquire(driver);
+    DRV_TRACEPOINT(CORE_OPEN, (result == 0) ? 0 : errno);
+    epoch_exit();
+    return (result == 0) ? driver : NULL;
+}
+
+// Sucht einen registrierten Treiber, ohne ihn zu öffnen (für drv_open_path).
+static driver_t* drv_core_lookup(driver_t* base_driver, const char* name) {
+    registry_t* registry = drv_core_registry(base_driver);
+    if (registry == NULL) {
+        errno = ENOSYS;
+        return NULL;
     }
 
-    // Wenn hier, dann ist die max. Anzahl der gleichzeitigen Öffnungen überschritten.
-    errno = EBUSY;
-    return NULL;
+    driver_t* driver = registry_get_driver_by_name(registry, name);
+    if (driver == NULL) {
+        errno = ENOENT;
+    }
+    return driver;
 }
 
 static int drv_core_close(driver_t* driver) {
     // Parametercheck für driver ist nicht notwendig, da schon von drv_close geprüft.
 
-    // Prüfe, ob schon alles geschlossen ist.
-    if (driver->ctx->open_cntr) {
-        driver->ctx->open_cntr--;
-        return 0;
-    }
-    else {
-        errno = EBADF;
-        return -1;
-    }
+    // Verringere die Anzahl der geöffneten handles (atomar). Schlägt mit EBADF fehl,
+    // wenn schon alles geschlossen ist.
+    return drv_open_release(driver);
 }
 
 static ssize_t drv_core_read(driver_t* driver, void* buffer, size_t count) {
@@ -153,17 +236,81 @@ static ssize_t drv_core_write(driver_t* driver, const void* buffer, size_t count
     return -1;
 }
 
+static ssize_t drv_core_readv(driver_t* driver, const struct iovec* iov, int iovcnt) {
+    // Segmente sind schon von drv_readv() geprüft. Wie drv_core_read: Der Treiber selbst hat
+    // keine Daten, der ganze Vektor wird in einem Aufruf abgelehnt.
+    errno = ENOTSUP;
+    return -1;
+}
+
+static ssize_t drv_core_writev(driver_t* driver, const struct iovec* iov, int iovcnt) {
+    // Segmente sind schon von drv_writev() geprüft. Wie drv_core_write: Der Treiber selbst
+    // nimmt keine Daten an, der ganze Vektor wird in einem Aufruf abgelehnt.
+    errno = ENOTSUP;
+    return -1;
+}
+
+static short drv_core_poll(driver_t* driver, short events) {
+    // Wie drv_core_read/drv_core_write: Der Treiber selbst hat nie Daten und nimmt keine an.
+    // Lesen und Schreiben schlagen sofort fehl (ENOTSUP): Fehler melden, nicht "nie bereit".
+    return POLLERR;
+}
+
 static int drv_core_ioctl(driver_t* driver, size_t id, void* param) {
     errno = ENOTSUP;
     return -1;
 }
 
 static size_t drv_core_get_properties(driver_t* driver) {
+#ifdef DRV_STATS
+    // Einzige Properties sind die Aufrufstatistiken, siehe DRV_STAT_PROP().
+    return drv_stats_properties();
+#else
     errno = ENOTSUP;
     return -1;
+#endif
 }
 
 static property_t* drv_core_get_property(driver_t* driver, size_t id) {
+#ifdef DRV_STATS
+    return drv_stats_property(driver, id);
+#else
     errno = ENOTSUP;
     return NULL;
+#endif
+}
+
+static int drv_core_reg_drv_many(driver_t* base_driver, const char* const names[], driver_t* const drivers[], size_t count, int* errors) {
+    // names und drivers sind schon vorab von drv_register_many() auf Gültigkeit geprüft.
+
+    registry_t* registry = drv_core_registry(base_driver);
+    // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
+    if (registry == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    // Core-Treiber darf nicht registriert werden. Dann wird kein Treiber registriert.
+    for (size_t i = 0; i < count; i++) {
+        if (drivers[i]->type == DRV_CORE) {
+            for (size_t j = 0; (errors != NULL) && (j < count); j++) {
+                errors[j] = (drivers[j]->type == DRV_CORE) ? EINVAL : ECANCELED;
+            }
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    return registry_add_drivers(registry, (const driver_t* const*)drivers, count, errors);
+}
+
+static int drv_core_dereg_drv_many(driver_t* base_driver, driver_t* const drivers[], size_t count, int* errors) {
+    registry_t* registry = drv_core_registry(base_driver);
+    // Prüfe registry. Sollte eigentlich nie NULL sein, da statisch definiert.
+    if (registry == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return registry_remove_drivers(registry, (const driver_t* const*)drivers, count, errors);
 }
@@ -4,4 +4,6 @@
 
 extern const driver_t const* drv_core;
 
+int drv_core_init(void);
+
 #endif //_DRV_CORE_H_
\ No newline at end of file
@@ -4,4 +4,6 @@
 
 extern const driver_t const* drv_dio;
 
+int drv_dio_init(void);
+
 #endif //_DRV_DIO_H_
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "drv_filter.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <driver.h>
+
+/*
+ * LOCAL Prototypes
+ */
+static int drv_filter_close(driver_t* driver);
+static ssize_t drv_filter_read(driver_t* driver, void* buffer, size_t count);
+static ssize_t drv_filter_write(driver_t* driver, const void* buffer, size_t count);
+static int drv_filter_ioctl(driver_t* driver, size_t id, void* param);
+static int drv_filter_flush_locked(drv_filter_t* filter);
+static int drv_filter_expired(const drv_filter_t* filter, struct timespec* deadline);
+static void* drv_filter_flusher(void* arg);
+
+/*
+ * LOCAL Variables
+ */
+const driver_fops_t drv_filter_fops = {
+        .close = drv_filter_close,
+        .read = drv_filter_read,
+        .write = drv_filter_write,
+        .ioctl = drv_filter_ioctl,
+};
+
+/*
+ * GLOBAL Functions
+ */
+int drv_filter_init(drv_filter_t* filter, driver_t* target, size_t size, uint32_t window_ms) {
+    // Parameter check
+    if ((filter == NULL) || (target == NULL) || (size == 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(filter, 0, sizeof(drv_filter_t));
+    filter->buffer = malloc(size);
+    if (filter->buffer == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // Das Ziel bleibt bis drv_filter_destroy() gebunden, auch wenn es abgemeldet wird.
+    if (drv_bind(target, &filter->target) != 0) {
+        int error = errno;
+        free(filter->buffer);
+        errno = error;
+        return -1;
+    }
+
+    pthread_condattr_t attr;
+    int result = pthread_condattr_init(&attr);
+    if (result == 0) {
+        result = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        if (result == 0) {
+            result = pthread_cond_init(&filter->cond, &attr);
+        }
+        pthread_condattr_destroy(&attr);
+    }
+    if ((result == 0) && ((result = pthread_mutex_init(&filter->lock, NULL)) != 0)) {
+        pthread_cond_destroy(&filter->cond);
+    }
+    if (result != 0) {
+        (void)drv_unbind(&filter->target);
+        free(filter->buffer);
+        errno = result;
+        return -1;
+    }
+
+    filter->size = size;
+    filter->window_ms = window_ms;
+    // driver_t hat const Felder: Einmalig per Kopie setzen. Der Filter trägt den Namen des Ziels.
+    memcpy(&filter->driver, &(driver_t){ .name = target->name, .type = DRV_FILTER, .fops = &drv_filter_fops,
+                                         .ctx = &filter->ctx, .user = filter }, sizeof(driver_t));
+
+    // Zeitfenster: Ein Thread pro Filter leert den Puffer, wenn keine weiteren Schreibvorgänge kommen.
+    if (window_ms > 0) {
+        filter->running = 1;
+        result = pthread_create(&filter->flusher, NULL, drv_filter_flusher, filter);
+        if (result != 0) {
+            filter->running = 0;
+            pthread_mutex_destroy(&filter->lock);
+            pthread_cond_destroy(&filter->cond);
+            (void)drv_unbind(&filter->target);
+            free(filter->buffer);
+            errno = result;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int drv_filter_destroy(drv_filter_t* filter) {
+    // Parameter check
+    if ((filter == NULL) || (filter->buffer == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pthread_mutex_lock(&filter->lock);
+    int running = filter->running;
+    filter->running = 0;
+    pthread_cond_signal(&filter->cond);
+    pthread_mutex_unlock(&filter->lock);
+    if (running) {
+        pthread_join(filter->flusher, NULL);
+    }
+
+    // Letzter Flush. Ein Fehler wird gemeldet, der Filter aber trotzdem freigegeben.
+    pthread_mutex_lock(&filter->lock);
+    int result = drv_filter_flush_locked(filter);
+    int error = errno;
+    pthread_mutex_unlock(&filter->lock);
+
+    pthread_mutex_destroy(&filter->lock);
+    pthread_cond_destroy(&filter->cond);
+    (void)drv_unbind(&filter->target);               // Gibt ein abgemeldetes Ziel frei.
+    free(filter->buffer);
+    filter->buffer = NULL;
+    errno = error;
+    return result;
+}
+
+driver_t* drv_filter_driver(drv_filter_t* filter) {
+    return (filter != NULL) ? &filter->driver : NULL;
+}
+
+int drv_filter_stack(const driver_t* base_driver, drv_filter_t* filter) {
+    // Parameter check
+    if ((base_driver == NULL) || (filter == NULL) || (filter->buffer == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Der Filter übernimmt den Platz und den registrierten Namen des Ziels in einem Schritt.
+    return drv_replace(base_driver, filter->target.driver, &filter->driver);
+}
+
+int drv_filter_unstack(const driver_t* base_driver, drv_filter_t* filter) {
+    // Parameter check
+    if ((base_driver == NULL) || (filter == NULL) || (filter->buffer == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Das Ziel bekommt seinen Platz zurück. Offene Handles des Filters schreiben weiter über ihn.
+    return drv_replace(base_driver, &filter->driver, filter->target.driver);
+}
+
+/*
+ * LOCAL Functions
+ */
+static int drv_filter_close(driver_t* driver) {
+    // Parametercheck für driver ist nicht notwendig, da schon von drv_close geprüft.
+    drv_filter_t* filter = driver->user;
+
+    // Wie fclose(): Gesammelte Daten schreiben, der Handle wird in jedem Fall geschlossen.
+    pthread_mutex_lock(&filter->lock);
+    int result = drv_filter_flush_locked(filter);
+    int error = errno;
+    pthread_mutex_unlock(&filter->lock);
+
+    if (drv_open_release(driver) != 0) {
+        return -1;
+    }
+    errno = error;
+    return result;
+}
+
+static ssize_t drv_filter_read(driver_t* driver, void* buffer, size_t count) {
+    drv_filter_t* filter = driver->user;
+
+    // Erst die gesammelten Daten schreiben, damit das Ziel die Aufrufe in Reihenfolge sieht.
+    pthread_mutex_lock(&filter->lock);
+    int result = drv_filter_flush_locked(filter);
+    pthread_mutex_unlock(&filter->lock);
+    if (result != 0) {
+        return -1;
+    }
+    // Ohne Sperre lesen: Ein blockierendes Lesen hält keine Schreiber auf.
+    return drv_bound_read(&filter->target, buffer, count);
+}
+
+static ssize_t drv_filter_write(driver_t* driver, const void* buffer, size_t count) {
+    drv_filter_t* filter = driver->user;
+    ssize_t result = (ssize_t)count;
+
+    pthread_mutex_lock(&filter->lock);
+    // Fehler eines Flushs im Hintergrund einmal melden.
+    if (filter->error != 0) {
+        errno = filter->error;
+        filter->error = 0;
+        pthread_mutex_unlock(&filter->lock);
+        return -1;
+    }
+
+    // Passt nicht mehr in den Puffer: Erst den Puffer leeren.
+    if ((count > filter->size - filter->fill) && (drv_filter_flush_locked(filter) != 0)) {
+        pthread_mutex_unlock(&filter->lock);
+        return -1;
+    }
+
+    if (count >= filter->size) {
+        // Groß genug: Direkt schreiben (der Puffer ist leer).
+        result = drv_bound_write(&filter->target, buffer, count);
+    } else if (count > 0) {
+        if (filter->fill == 0) {
+            // Ältestes Byte: Das Zeitfenster beginnt, der Flusher-Thread wartet ab jetzt darauf.
+            clock_gettime(CLOCK_MONOTONIC, &filter->first);
+            pthread_cond_signal(&filter->cond);
+        }
+        memcpy(filter->buffer + filter->fill, buffer, count);
+        filter->fill += count;
+        // Schwelle erreicht. Die Daten sind angenommen: Ein Fehler wird beim nächsten Aufruf gemeldet.
+        if ((filter->fill == filter->size) && (drv_filter_flush_locked(filter) != 0)) {
+            filter->error = errno;
+        }
+    }
+    pthread_mutex_unlock(&filter->lock);
+    return result;
+}
+
+static int drv_filter_ioctl(driver_t* driver, size_t id, void* param) {
+    drv_filter_t* filter = driver->user;
+
+    pthread_mutex_lock(&filter->lock);
+    int result = 0;
+    if ((id == DRV_FILTER_IOCTL_FLUSH) && (filter->error != 0)) {
+        errno = filter->error;
+        filter->error = 0;
+        result = -1;
+    }
+    if (result == 0) {
+        result = drv_filter_flush_locked(filter);
+    }
+    pthread_mutex_unlock(&filter->lock);
+
+    // Alle anderen ioctls gehen nach dem Flush an das Ziel.
+    if ((id == DRV_FILTER_IOCTL_FLUSH) || (result != 0)) {
+        return result;
+    }
+    return drv_bound_ioctl(&filter->target, id, param);
+}
+
+// Schreibt den Puffer in das Ziel. Aufruf mit gesperrtem Filter. Kurze Schreibvorgänge werden fortgesetzt,
+// bei einem Fehler bleibt der Rest im Puffer.
+static int drv_filter_flush_locked(drv_filter_t* filter) {
+    size_t done = 0;
+    while (done < filter->fill) {
+        ssize_t result = drv_bound_write(&filter->target, filter->buffer + done, filter->fill - done);
+        if (result <= 0) {
+            if (result == 0) {
+                errno = EIO;                        // Kein Fortschritt.
+            }
+            int error = errno;
+            memmove(filter->buffer, filter->buffer + done, filter->fill - done);
+            filter->fill -= done;
+            errno = error;
+            return -1;
+        }
+        done += (size_t)result;
+    }
+    filter->fill = 0;
+    return 0;
+}
+
+// Liefert das Ende des Zeitfensters der gesammelten Daten und ob es abgelaufen ist.
+static int drv_filter_expired(const drv_filter_t* filter, struct timespec* deadline) {
+    deadline->tv_sec = filter->first.tv_sec + (time_t)(filter->window_ms / 1000U);
+    deadline->tv_nsec = filter->first.tv_nsec + (long)(filter->window_ms % 1000U) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec > deadline->tv_sec) || ((now.tv_sec == deadline->tv_sec) && (now.tv_nsec >= deadline->tv_nsec));
+}
+
+// Flusher-Thread: Schläft, bis Daten gesammelt werden, und leert den Puffer am Ende ihres Zeitfensters.
+static void* drv_filter_flusher(void* arg) {
+    drv_filter_t* filter = arg;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&filter->lock);
+    while (filter->running) {
+        if (filter->fill == 0) {
+            pthread_cond_wait(&filter->cond, &filter->lock);
+        } else if (!drv_filter_expired(filter, &deadline)) {
+            // Der Puffer kann inzwischen geleert und neu gefüllt sein: Danach neu prüfen.
+            pthread_cond_timedwait(&filter->cond, &filter->lock, &deadline);
+        } else if (drv_filter_flush_locked(filter) != 0) {
+            // Fehler merken und erst nach einem weiteren Zeitfenster erneut versuchen.
+            filter->error = errno;
+            clock_gettime(CLOCK_MONOTONIC, &filter->first);
+        }
+    }
+    pthread_mutex_unlock(&filter->lock);
+    return NULL;
+}
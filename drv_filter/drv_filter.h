@@ -0,0 +1,127 @@
+/**
+ * @file    drv_filter.h
+ * @brief   Stackable filter driver: Coalesces small writes to a target driver.
+ *
+ * @details
+ * A filter is a driver in front of another driver (its target). Registered under the
+ * name of the target, callers of drv_open() get the filter without any change:
+ *
+ * @code
+ * drv_filter_init(&filter, pin, 64, 5);                    // Flush at 64 bytes or after 5 ms.
+ * drv_filter_stack(drv_dio, &filter);                      // "pin" now opens the filter.
+ * ...
+ * drv_filter_unstack(drv_dio, &filter);                    // "pin" opens the target again.
+ * ...                                                      // Close the handles of the filter.
+ * drv_filter_destroy(&filter);
+ * @endcode
+ *
+ * Writes are collected in a buffer and written to the target in one call, when the
+ * buffer is full, when the oldest byte is older than the time window, on
+ * DRV_FILTER_IOCTL_FLUSH and on close. Writes of at least the buffer size go through
+ * directly. Reads and other ioctls flush first and are passed on, so the target sees
+ * all calls in order. Filters can be stacked: The target may be a filter again.
+ *
+ * Errors of a flush in the background are returned by the next write or flush. Data,
+ * that could not be written, stays in the buffer.
+ *
+ * The filter calls the target through a bound handle (see drv_bind()): The target is
+ * kept alive until drv_filter_destroy(), even if it has been deregistered.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+#ifndef _DRV_FILTER_H_
+#define _DRV_FILTER_H_
+
+/*
+ * INCLUDEs
+ */
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <driver_types.h>
+
+/*
+ * DEFINEs
+ */
+#define DRV_FILTER_IOCTL_FLUSH  ((size_t)0x464C5348U)   /// ioctl: Write the buffer to the target now. param: unused.
+
+/*
+ * Types
+ */
+typedef struct drv_filter_s {
+    driver_t driver;                                // Registered in front of the target, see drv_filter_driver().
+    driver_ctx_t ctx;
+    drv_bound_t target;                             // Target of the filter.
+    pthread_mutex_t lock;                           // Protects the buffer.
+    pthread_cond_t cond;                            // Wakes the flusher thread (CLOCK_MONOTONIC).
+    uint8_t* buffer;
+    size_t size;                                    // Size of the buffer: Threshold of a flush.
+    size_t fill;                                    // Collected bytes.
+    struct timespec first;                          // Time of the oldest collected byte.
+    uint32_t window_ms;                             // Max. age of collected bytes [ms]. 0: No time limit.
+    int error;                                      // errno of a failed flush in the background, reported once.
+    int running;                                    // true: Flusher thread runs (window_ms > 0).
+    pthread_t flusher;
+} drv_filter_t;
+
+/*
+ * Global Prototypes
+ */
+
+/**
+ * @brief drv_filter_init: Initialize a write-coalescing filter in front of a target driver.
+ *
+ * @param (drv_filter_t*) filter: Filter.
+ * @param (driver_t*) target: Driver behind the filter. May be a filter again.
+ * @param (size_t) size: Size of the buffer [bytes]. > 0.
+ * @param (uint32_t) window_ms: Max. time [ms] a byte is kept in the buffer. 0: Only size, ioctl and close flush.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_filter_init(drv_filter_t* filter, driver_t* target, size_t size, uint32_t window_ms);
+
+/**
+ * @brief drv_filter_destroy: Flush and release a filter. It must be unstacked (or deregistered) and closed.
+ *
+ * @param (drv_filter_t*) filter: Filter.
+ *
+ * @return (int): 0: Success, -1: Failed (released anyway, the buffer is lost). For reason see errno-variable.
+ */
+int drv_filter_destroy(drv_filter_t* filter);
+
+/**
+ * @brief drv_filter_driver: Get the driver of a filter, e.g. for drv_register().
+ *
+ * @param (drv_filter_t*) filter: Filter.
+ *
+ * @return (driver_t*): Driver of the filter.
+ */
+driver_t* drv_filter_driver(drv_filter_t* filter);
+
+/**
+ * @brief drv_filter_stack: Put a filter in front of its registered target: The filter replaces the
+ * target under its registered name in one step (see drv_replace()), opens of the name find either
+ * of both, never none. Open handles of the target stay valid. If it fails, nothing is changed.
+ * The base driver must support driver_fops_t::replace_drv.
+ *
+ * @param (const driver_t*) base_driver: Base driver, at which the target is registered.
+ * @param (drv_filter_t*) filter: Initialized filter.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_filter_stack(const driver_t* base_driver, drv_filter_t* filter);
+
+/**
+ * @brief drv_filter_unstack: Undo drv_filter_stack(): The target replaces the filter again in one step.
+ * Open handles of the filter stay valid and still write through it. Close them before drv_filter_destroy().
+ *
+ * @param (const driver_t*) base_driver: Base driver, at which the filter is registered.
+ * @param (drv_filter_t*) filter: Stacked filter.
+ *
+ * @return (int): 0: Success, -1: Failed. For reason see errno-variable.
+ */
+int drv_filter_unstack(const driver_t* base_driver, drv_filter_t* filter);
+
+#endif //_DRV_FILTER_H_
@@ -3,18 +3,72 @@
 #include <drv_core.h>
 #include <drv_dio.h>
 #include <test_registry.h>
+#include <test_dyn_array.h>
 #include <test_driver.h>
+#include <test_drv_static.h>
+#include <test_drv_mph.h>
+#include <test_intern.h>
+#include <test_epoch.h>
+#include <test_drv_file.h>
+#include <test_drv_ring.h>
+#include <test_drv_stats.h>
+#include <test_drv_trace.h>
+#include <test_drv_tracepoint.h>
+#include <test_drv_poll.h>
+#include <test_drv_timed.h>
+#include <test_drv_filter.h>
 
 void setUp(void) {
+    test_driver_setUp();
     test_registry_setUp();
+    test_dyn_array_setUp();
+    test_drv_static_setUp();
+    test_drv_mph_setUp();
+    test_intern_setUp();
+    test_epoch_setUp();
+    test_drv_file_setUp();
+    test_drv_ring_setUp();
+    test_drv_stats_setUp();
+    test_drv_trace_setUp();
+    test_drv_tracepoint_setUp();
+    test_drv_poll_setUp();
+    test_drv_timed_setUp();
+    test_drv_filter_setUp();
 }     // optional
 void tearDown(void) {
+    test_driver_tearDown();
     test_registry_tearDown();
+    test_dyn_array_tearDown();
+    test_drv_static_tearDown();
+    test_drv_mph_tearDown();
+    test_intern_tearDown();
+    test_epoch_tearDown();
+    test_drv_file_tearDown();
+    test_drv_ring_tearDown();
+    test_drv_stats_tearDown();
+    test_drv_trace_tearDown();
+    test_drv_tracepoint_tearDown();
+    test_drv_poll_tearDown();
+    test_drv_timed_tearDown();
+    test_drv_filter_tearDown();
 }  // optional
 
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_driver_run_all);
     RUN_TEST(test_registry_run_all);
+    RUN_TEST(test_dyn_array_run_all);
+    RUN_TEST(test_drv_static_run_all);
+    RUN_TEST(test_drv_mph_run_all);
+    RUN_TEST(test_intern_run_all);
+    RUN_TEST(test_epoch_run_all);
+    RUN_TEST(test_drv_file_run_all);
+    RUN_TEST(test_drv_ring_run_all);
+    RUN_TEST(test_drv_stats_run_all);
+    RUN_TEST(test_drv_trace_run_all);
+    RUN_TEST(test_drv_tracepoint_run_all);
+    RUN_TEST(test_drv_poll_run_all);
+    RUN_TEST(test_drv_timed_run_all);
+    RUN_TEST(test_drv_filter_run_all);
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,273 @@
+/**
+ * @file    drv_mph_gen.c
+ * @brief   Build tool: Generate a minimal perfect hash table for a list of driver names.
+ *
+ * @details
+ * Usage: drv_mph_gen <symbol> <names-file> <output.c>
+ *
+ * The names file contains one driver name per line. Empty lines and lines starting
+ * with '#' are ignored. The output defines "const drv_mph_table_t <symbol>" (see drv_mph.h).
+ *
+ * Algorithm (hash and displace): The names are distributed over buckets by their hash.
+ * Starting with the largest bucket, a displacement is searched for every bucket, which
+ * maps all names of the bucket to free slots. If no displacement fits, the next seed is tried.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include <drv_mph.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+
+/*
+ * DEFINEs
+ */
+#define MPH_GEN_LINE_LEN    (256U)      /// Max. length of a line in the names file.
+#define MPH_GEN_SEEDS       (1000U)     /// Number of seeds to try.
+#define MPH_GEN_BUCKET_LOAD (4U)        /// Mean number of names per bucket.
+
+/*
+ * Types
+ */
+typedef struct mph_gen_bucket_s {
+    uint32_t bucket;                    // Index of the bucket.
+    uint32_t count;                     // Number of names in the bucket.
+} mph_gen_bucket_t;
+
+/*
+ * LOCAL Variables
+ */
+static char** mph_gen_names = NULL;
+static size_t mph_gen_count = 0;
+
+/*
+ * LOCAL Functions
+ */
+static int mph_gen_read(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    char line[MPH_GEN_LINE_LEN];
+    size_t size = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        // Trim whitespace
+        char* begin = line;
+        while (isspace((unsigned char)*begin)) {
+            begin++;
+        }
+        char* end = begin + strlen(begin);
+        while ((end > begin) && isspace((unsigned char)end[-1])) {
+            end--;
+        }
+        *end = '\0';
+        if ((*begin == '\0') || (*begin == '#')) {
+            continue;
+        }
+
+        if (strpbrk(begin, "\"\\") != NULL) {
+            fprintf(stderr, "%s: invalid character in name \"%s\"\n", path, begin);
+            fclose(file);
+            return -1;
+        }
+
+        for (size_t i = 0; i < mph_gen_count; i++) {
+            if (strcmp(mph_gen_names[i], begin) == 0) {
+                fprintf(stderr, "%s: duplicate name \"%s\"\n", path, begin);
+                fclose(file);
+                return -1;
+            }
+        }
+
+        if (mph_gen_count == size) {
+            size = (size == 0) ? 16 : size * 2;
+            char** names = realloc(mph_gen_names, size * sizeof(char*));
+            if (names == NULL) {
+                fclose(file);
+                return -1;
+            }
+            mph_gen_names = names;
+        }
+        mph_gen_names[mph_gen_count] = strdup(begin);
+        if (mph_gen_names[mph_gen_count] == NULL) {
+            fclose(file);
+            return -1;
+        }
+        mph_gen_count++;
+    }
+    fclose(file);
+
+    if ((mph_gen_count == 0) || (mph_gen_count > UINT32_MAX)) {
+        fprintf(stderr, "%s: no names\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static void mph_gen_free(void) {
+    for (size_t i = 0; i < mph_gen_count; i++) {
+        free(mph_gen_names[i]);
+    }
+    free(mph_gen_names);
+    mph_gen_names = NULL;
+    mph_gen_count = 0;
+}
+
+// Largest bucket first.
+static int mph_gen_compare(const void* a, const void* b) {
+    const mph_gen_bucket_t* bucket_a = a;
+    const mph_gen_bucket_t* bucket_b = b;
+    if (bucket_a->count != bucket_b->count) {
+        return (bucket_a->count > bucket_b->count) ? -1 : 1;
+    }
+    return (bucket_a->bucket < bucket_b->bucket) ? -1 : 1;
+}
+
+// Try to build the table for one seed. Returns true on success, disp and keys are filled.
+static bool mph_gen_build(uint32_t seed, uint32_t buckets, uint16_t* disp, uint32_t* slot_of) {
+    uint32_t size = (uint32_t)mph_gen_count;
+    uint32_t* hashes = malloc(size * sizeof(uint32_t));
+    mph_gen_bucket_t* order = calloc(buckets, sizeof(mph_gen_bucket_t));
+    bool* used = calloc(size, sizeof(bool));
+    uint32_t* slots = malloc(size * sizeof(uint32_t));
+    bool success = (hashes != NULL) && (order != NULL) && (used != NULL) && (slots != NULL);
+
+    for (uint32_t b = 0; success && (b < buckets); b++) {
+        order[b].bucket = b;
+    }
+    for (uint32_t i = 0; success && (i < size); i++) {
+        hashes[i] = hash_str_seed(mph_gen_names[i], seed);
+        order[drv_mph_reduce(hashes[i], buckets)].count++;
+    }
+    if (success) {
+        qsort(order, buckets, sizeof(mph_gen_bucket_t), mph_gen_compare);
+    }
+
+    for (uint32_t b = 0; success && (b < buckets) && (order[b].count > 0); b++) {
+        uint32_t bucket = order[b].bucket;
+        bool placed = false;
+        for (uint32_t d = 0; (d <= UINT16_MAX) && !placed; d++) {
+            // Try to place all names of the bucket with displacement d.
+            uint32_t taken = 0;
+            placed = true;
+            for (uint32_t i = 0; i < size; i++) {
+                if (drv_mph_reduce(hashes[i], buckets) != bucket) {
+                    continue;
+                }
+                uint32_t slot = drv_mph_slot(hashes[i], (uint16_t)d, size);
+                if (used[slot]) {
+                    placed = false;
+                    break;
+                }
+                used[slot] = true;
+                slots[taken++] = slot;
+                slot_of[i] = slot;
+            }
+            if (placed) {
+                disp[bucket] = (uint16_t)d;
+            } else {
+                for (uint32_t i = 0; i < taken; i++) {
+                    used[slots[i]] = false;
+                }
+            }
+        }
+        success = placed;
+    }
+
+    free(slots);
+    free(used);
+    free(order);
+    free(hashes);
+    return success;
+}
+
+static int mph_gen_write(const char* path, const char* symbol, uint32_t seed, uint32_t buckets, const uint16_t* disp, const uint32_t* slot_of) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    uint32_t size = (uint32_t)mph_gen_count;
+    const char** keys = calloc(size, sizeof(char*));
+    if (keys == NULL) {
+        fclose(file);
+        return -1;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        keys[slot_of[i]] = mph_gen_names[i];
+    }
+
+    fprintf(file, "// Generated by drv_mph_gen. Do not edit.\n");
+    fprintf(file, "#include <drv_mph.h>\n\n");
+    fprintf(file, "static const uint16_t %s_disp[%u] = {", symbol, buckets);
+    for (uint32_t b = 0; b < buckets; b++) {
+        fprintf(file, "%s%u,", (b % 16 == 0) ? "\n    " : " ", disp[b]);
+    }
+    fprintf(file, "\n};\n\n");
+    fprintf(file, "static const char* const %s_keys[%u] = {\n", symbol, size);
+    for (uint32_t i = 0; i < size; i++) {
+        fprintf(file, "    \"%s\",\n", keys[i]);
+    }
+    fprintf(file, "};\n\n");
+    fprintf(file, "static driver_t* %s_slots[%u];\n\n", symbol, size);
+    fprintf(file, "const drv_mph_table_t %s = {\n", symbol);
+    fprintf(file, "    .size = %uU,\n    .buckets = %uU,\n    .seed = 0x%08xUL,\n", size, buckets, seed);
+    fprintf(file, "    .disp = %s_disp,\n    .keys = %s_keys,\n    .slots = %s_slots,\n};\n", symbol, symbol, symbol);
+
+    free(keys);
+    if (fclose(file) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s <symbol> <names-file> <output.c>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (mph_gen_read(argv[2]) != 0) {
+        mph_gen_free();
+        return EXIT_FAILURE;
+    }
+
+    uint32_t buckets = (uint32_t)((mph_gen_count + MPH_GEN_BUCKET_LOAD - 1) / MPH_GEN_BUCKET_LOAD);
+    uint16_t* disp = calloc(buckets, sizeof(uint16_t));
+    uint32_t* slot_of = calloc(mph_gen_count, sizeof(uint32_t));
+    int result = EXIT_FAILURE;
+    if ((disp == NULL) || (slot_of == NULL)) {
+        perror("drv_mph_gen");
+    }
+    else {
+        uint32_t attempt;
+        for (attempt = 0; attempt < MPH_GEN_SEEDS; attempt++) {
+            uint32_t seed = HASH_FNV_OFFSET ^ (attempt * DRV_MPH_DISP_MUL);
+            memset(disp, 0, buckets * sizeof(uint16_t));
+            if (mph_gen_build(seed, buckets, disp, slot_of)) {
+                result = (mph_gen_write(argv[3], argv[1], seed, buckets, disp, slot_of) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+                break;
+            }
+        }
+        if (attempt == MPH_GEN_SEEDS) {
+            fprintf(stderr, "%s: no perfect hash found\n", argv[2]);
+        }
+    }
+
+    free(slot_of);
+    free(disp);
+    mph_gen_free();
+    return result;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file    drv_trace_decode.c
+ * @brief   Tool: Decode a driver call trace written by drv_trace_dump().
+ *
+ * @details
+ * Usage: drv_trace_decode <trace-file>
+ *
+ * Merges the records of all threads by time and prints one line per call:
+ *
+ *   <time [us]> T<thread> <op> <driver name> (<address>) size <size> result <result> [errno <errno> (<text>)]
+ *   <time [us]> T<thread> point <tracepoint> a0 <a0> a1 <a1>
+ *
+ * The time is relative to the oldest record. Driver names are taken from the
+ * DRV_TRACE_NAME records of the same thread. The trace must have been written on a
+ * system with the same byte order.
+ *
+ * @author  Roman Buchert <roman.buchert@googlemail.com>
+ * @date    2026-10-17
+ * @version 0.1
+ */
+
+/*
+ * INCLUDEs
+ */
+#include <drv_trace.h>
+#include <drv_tracepoint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+/*
+ * Types
+ */
+typedef struct trace_entry_s {
+    uint32_t thread;                    // Number of the thread.
+    uint32_t seq;                       // Position in the ring of the thread.
+    drv_trace_record_t record;
+} trace_entry_t;
+
+typedef struct trace_name_s {
+    uint32_t thread;
+    uint64_t driver;
+    char name[sizeof(((drv_trace_record_t*)0)->name) + 1];
+} trace_name_t;
+
+/*
+ * LOCAL Variables
+ */
+static const char* const trace_op_names[DRV_TRACE_OPS] = {
+    "name", "register", "deregister", "open", "close", "read", "write", "ioctl", "point",
+};
+#define TRACE_POINT_NAME(id, name) name,
+static const char* const trace_point_names[DRV_TP_COUNT] = {
+    DRV_TP_LIST(TRACE_POINT_NAME)
+};
+#undef TRACE_POINT_NAME
+static trace_entry_t* trace_entries = NULL;
+static size_t trace_count = 0;
+static trace_name_t* trace_names = NULL;
+static size_t trace_name_count = 0;
+
+/*
+ * LOCAL Functions
+ */
+static int trace_compare(const void* a, const void* b) {
+    const trace_entry_t* x = a;
+    const trace_entry_t* y = b;
+    if (x->record.time != y->record.time) {
+        return (x->record.time < y->record.time) ? -1 : 1;
+    }
+    if (x->thread != y->thread) {
+        return (x->thread < y->thread) ? -1 : 1;
+    }
+    return (x->seq < y->seq) ? -1 : (x->seq > y->seq);
+}
+
+// Gets the last recorded name of a driver in a thread.
+static const char* trace_name(uint32_t thread, uint64_t driver) {
+    const char* name = "?";
+    for (size_t i = 0; i < trace_name_count; i++) {
+        if ((trace_names[i].thread == thread) && (trace_names[i].driver == driver)) {
+            name = trace_names[i].name;
+        }
+    }
+    return name;
+}
+
+static int trace_add_name(uint32_t thread, const drv_trace_record_t* record) {
+    trace_name_t* names = realloc(trace_names, (trace_name_count + 1U) * sizeof(trace_name_t));
+    if (names == NULL) {
+        return -1;
+    }
+    trace_names = names;
+    trace_name_t* name = &trace_names[trace_name_count++];
+    name->thread = thread;
+    name->driver = record->driver;
+    memcpy(name->name, record->name, sizeof(record->name));
+    name->name[sizeof(record->name)] = '\0';
+    return 0;
+}
+
+static int trace_read(FILE* in, drv_trace_header_t* header) {
+    if (fread(header, sizeof(*header), 1, in) != 1) {
+        fprintf(stderr, "Missing header\n");
+        return -1;
+    }
+    if ((memcmp(header->magic, DRV_TRACE_MAGIC, sizeof(header->magic)) != 0)
+        || (header->version != DRV_TRACE_VERSION)
+        || (header->record_size != sizeof(drv_trace_record_t))) {
+        fprintf(stderr, "No trace or unsupported format\n");
+        return -1;
+    }
+
+    for (uint32_t t = 0; t < header->threads; t++) {
+        drv_trace_thread_t thread;
+        if (fread(&thread, sizeof(thread), 1, in) != 1) {
+            fprintf(stderr, "Truncated trace\n");
+            return -1;
+        }
+        if (thread.lost != 0) {
+            fprintf(stderr, "T%" PRIu32 ": %" PRIu64 " records lost\n", thread.thread, thread.lost);
+        }
+        trace_entry_t* entries = realloc(trace_entries, (trace_count + thread.count) * sizeof(trace_entry_t));
+        if ((entries == NULL) && (thread.count != 0)) {
+            perror("realloc");
+            return -1;
+        }
+        trace_entries = entries;
+        for (uint32_t i = 0; i < thread.count; i++) {
+            trace_entry_t* entry = &trace_entries[trace_count];
+            if (fread(&entry->record, sizeof(entry->record), 1, in) != 1) {
+                fprintf(stderr, "Truncated trace\n");
+                return -1;
+            }
+            entry->thread = thread.thread;
+            entry->seq = i;
+            if (entry->record.op == DRV_TRACE_NAME) {
+                if (trace_add_name(thread.thread, &entry->record) != 0) {
+                    perror("realloc");
+                    return -1;
+                }
+                continue;
+            }
+            trace_count++;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Main
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <trace-file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE* in = fopen(argv[1], "rb");
+    if (in == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    drv_trace_header_t header;
+    int result = trace_read(in, &header);
+    fclose(in);
+    if (result != 0) {
+        return EXIT_FAILURE;
+    }
+
+    qsort(trace_entries, trace_count, sizeof(trace_entry_t), trace_compare);
+
+    // Ticks to ns by the two calibration points of the header.
+    double ns_per_tick = 1.0;
+    if (header.ticks[1] > header.ticks[0]) {
+        ns_per_tick = (double)(header.ns[1] - header.ns[0]) / (double)(header.ticks[1] - header.ticks[0]);
+    }
+    for (size_t i = 0; i < trace_count; i++) {
+        const trace_entry_t* entry = &trace_entries[i];
+        const drv_trace_record_t* record = &entry->record;
+        double us = (double)(record->time - trace_entries[0].record.time) * ns_per_tick / 1000.0;
+        if (record->op == DRV_TRACE_POINT) {
+            printf("%14.3f T%-3" PRIu32 " %-10s %-16s a0 %" PRId64 " a1 %" PRId64 "\n",
+                   us, entry->thread, trace_op_names[DRV_TRACE_POINT],
+                   (record->point < DRV_TP_COUNT) ? trace_point_names[record->point] : "?", record->size, record->result);
+            continue;
+        }
+        printf("%14.3f T%-3" PRIu32 " %-10s %-16s (0x%" PRIx64 ") size %" PRId64 " result %" PRId64,
+               us, entry->thread, (record->op < DRV_TRACE_OPS) ? trace_op_names[record->op] : "?",
+               trace_name(entry->thread, record->driver), record->driver, record->size, record->result);
+        if (record->error != 0) {
+            printf(" errno %d (%s)", record->error, strerror(record->error));
+        }
+        printf("\n");
+    }
+
+    free(trace_entries);
+    free(trace_names);
+    return EXIT_SUCCESS;
+}